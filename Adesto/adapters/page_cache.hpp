@@ -0,0 +1,396 @@
+/********************************************************************************
+ *  File Name:
+ *    page_cache.hpp
+ *
+ *  Description:
+ *    LRU page read cache that can be layered over any generic memory device
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+#pragma once
+#ifndef ADESTO_PAGE_CACHE_HPP
+#define ADESTO_PAGE_CACHE_HPP
+
+/* STL Includes */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/* Aurora Includes */
+#include <Aurora/memory>
+
+/* Chimera Includes */
+#include <Chimera/thread>
+
+namespace Adesto::Adapter
+{
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct CacheStats
+  {
+    size_t hits;   /**< Number of page lookups served from RAM */
+    size_t misses; /**< Number of page lookups that went to the device */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Wraps a generic memory device with a statically allocated, page granular
+   *  read cache. Pages are evicted in least recently used order. Any write or
+   *  erase issued through the adapter invalidates the affected pages, so the
+   *  cache only stays coherent if all modifications go through this object.
+   *
+   *  @tparam PageSize    Size of a cached page in bytes. Should match the device page size.
+   *  @tparam NumPages    How many pages can be cached at once
+   */
+  template<size_t PageSize, size_t NumPages>
+  class PageCache : public virtual Aurora::Memory::IGenericDevice, public Chimera::Threading::Lockable
+  {
+    static_assert( PageSize, "Page size must be non-zero" );
+    static_assert( NumPages, "Cache must hold at least one page" );
+
+  public:
+    PageCache( Aurora::Memory::IGenericDevice &device ) : mDevice( device ), mTick( 0 ), mStats( {} )
+    {
+      drop();
+    }
+
+    ~PageCache()
+    {
+    }
+
+    /*-------------------------------------------------
+    Generic Memory Device Interface
+    -------------------------------------------------*/
+    Aurora::Memory::Status open() final override
+    {
+      return mDevice.open();
+    }
+
+    Aurora::Memory::Status close() final override
+    {
+      this->lock();
+      drop();
+      auto result = mDevice.close();
+      this->unlock();
+
+      return result;
+    }
+
+    Aurora::Memory::Status write( const size_t address, const void *const data, const size_t length ) final override
+    {
+      this->lock();
+      auto result = mDevice.write( address, data, length );
+      drop( address, length );
+      this->unlock();
+
+      return result;
+    }
+
+    Aurora::Memory::Status read( const size_t address, void *const data, const size_t length ) final override
+    {
+      /*-------------------------------------------------
+      Input Protection
+      -------------------------------------------------*/
+      if ( !data || !length )
+      {
+        return Aurora::Memory::Status::ERR_BAD_ARG;
+      }
+
+      this->lock();
+
+      /*-------------------------------------------------
+      Serve the request one page at a time, pulling any
+      missing pages into the cache as whole pages.
+      -------------------------------------------------*/
+      auto result      = Aurora::Memory::Status::ERR_OK;
+      auto dst         = reinterpret_cast<uint8_t *>( data );
+      size_t bytesDone = 0;
+
+      while ( bytesDone < length )
+      {
+        const size_t addr   = address + bytesDone;
+        const size_t page   = addr / PageSize;
+        const size_t offset = addr % PageSize;
+        const size_t chunk  = std::min( PageSize - offset, length - bytesDone );
+
+        Line *line = lookup( page );
+        if ( !line )
+        {
+          line = fill( page, result );
+          if ( !line )
+          {
+            break;
+          }
+        }
+
+        memcpy( dst + bytesDone, line->data.data() + offset, chunk );
+        bytesDone += chunk;
+      }
+
+      this->unlock();
+      return result;
+    }
+
+    Aurora::Memory::Status erase( const size_t address, const size_t length ) final override
+    {
+      this->lock();
+      auto result = mDevice.erase( address, length );
+      drop( address, length );
+      this->unlock();
+
+      return result;
+    }
+
+    Aurora::Memory::Status erase( const Aurora::Memory::Chunk chunk, const size_t id ) final override
+    {
+      /*-------------------------------------------------
+      Figure out which address range the chunk covers so
+      only those pages get dropped.
+      -------------------------------------------------*/
+      const auto props = mDevice.getDeviceProperties();
+      size_t chunkSize = 0;
+
+      switch ( chunk )
+      {
+        case Aurora::Memory::Chunk::PAGE:
+          chunkSize = props.pageSize;
+          break;
+
+        case Aurora::Memory::Chunk::BLOCK:
+          chunkSize = props.blockSize;
+          break;
+
+        case Aurora::Memory::Chunk::SECTOR:
+          chunkSize = props.sectorSize;
+          break;
+
+        default:
+          break;
+      };
+
+      this->lock();
+      auto result = mDevice.erase( chunk, id );
+
+      if ( chunkSize )
+      {
+        drop( chunkSize * id, chunkSize );
+      }
+      else
+      {
+        drop();
+      }
+
+      this->unlock();
+      return result;
+    }
+
+    Aurora::Memory::Status eraseChip() final override
+    {
+      this->lock();
+      auto result = mDevice.eraseChip();
+      drop();
+      this->unlock();
+
+      return result;
+    }
+
+    Aurora::Memory::Status flush() final override
+    {
+      return mDevice.flush();
+    }
+
+    Aurora::Memory::Status pendEvent( const Aurora::Memory::Event event, const size_t timeout ) final override
+    {
+      return mDevice.pendEvent( event, timeout );
+    }
+
+    Aurora::Memory::Status onEvent( const Aurora::Memory::Event event, void ( *func )( const size_t ) ) final override
+    {
+      return mDevice.onEvent( event, func );
+    }
+
+    Aurora::Memory::Status writeProtect( const bool enable, const Aurora::Memory::Chunk chunk, const size_t id ) final override
+    {
+      return mDevice.writeProtect( enable, chunk, id );
+    }
+
+    Aurora::Memory::Status readProtect( const bool enable, const Aurora::Memory::Chunk chunk, const size_t id ) final override
+    {
+      return mDevice.readProtect( enable, chunk, id );
+    }
+
+    Aurora::Memory::Properties getDeviceProperties() final override
+    {
+      return mDevice.getDeviceProperties();
+    }
+
+    /*-------------------------------------------------
+    Cache Interface
+    -------------------------------------------------*/
+    /**
+     *  Drops every page held in the cache
+     *
+     *  @return void
+     */
+    void invalidate()
+    {
+      this->lock();
+      drop();
+      this->unlock();
+    }
+
+    /**
+     *  Drops any cached pages that overlap the given range
+     *
+     *  @param[in]  address     Start of the range
+     *  @param[in]  length      Number of bytes in the range
+     *  @return void
+     */
+    void invalidate( const size_t address, const size_t length )
+    {
+      this->lock();
+      drop( address, length );
+      this->unlock();
+    }
+
+    /**
+     *  Gets the hit/miss counters
+     *
+     *  @return CacheStats
+     */
+    CacheStats getStats() const
+    {
+      return mStats;
+    }
+
+    /**
+     *  Zeros the hit/miss counters
+     *
+     *  @return void
+     */
+    void resetStats()
+    {
+      mStats = {};
+    }
+
+  private:
+    struct Line
+    {
+      bool valid;                         /**< Whether the line holds data */
+      size_t page;                        /**< Which device page is cached */
+      size_t lastUse;                     /**< Tick of the most recent access */
+      std::array<uint8_t, PageSize> data; /**< Cached page contents */
+    };
+
+    Aurora::Memory::IGenericDevice &mDevice; /**< Device being cached */
+    std::array<Line, NumPages> mLines;       /**< Cache storage */
+    size_t mTick;                            /**< Monotonic access counter for LRU tracking */
+    CacheStats mStats;                       /**< Hit/miss counters */
+
+    /**
+     *  Drops every page held in the cache. Callers hold the lock.
+     *
+     *  @return void
+     */
+    void drop()
+    {
+      for ( auto &line : mLines )
+      {
+        line.valid = false;
+      }
+    }
+
+    /**
+     *  Drops any cached pages that overlap the given range. Callers hold the lock.
+     *
+     *  @param[in]  address     Start of the range
+     *  @param[in]  length      Number of bytes in the range
+     *  @return void
+     */
+    void drop( const size_t address, const size_t length )
+    {
+      if ( !length )
+      {
+        return;
+      }
+
+      const size_t firstPage = address / PageSize;
+      const size_t lastPage  = ( address + length - 1 ) / PageSize;
+
+      for ( auto &line : mLines )
+      {
+        if ( line.valid && ( line.page >= firstPage ) && ( line.page <= lastPage ) )
+        {
+          line.valid = false;
+        }
+      }
+    }
+
+    /**
+     *  Finds the line holding a page, marking it as most recently used
+     *
+     *  @param[in]  page        Which page to look for
+     *  @return Line *          The line, or nullptr on a miss
+     */
+    Line *lookup( const size_t page )
+    {
+      for ( auto &line : mLines )
+      {
+        if ( line.valid && ( line.page == page ) )
+        {
+          line.lastUse = ++mTick;
+          mStats.hits++;
+          return &line;
+        }
+      }
+
+      mStats.misses++;
+      return nullptr;
+    }
+
+    /**
+     *  Evicts the least recently used line and loads a page into it
+     *
+     *  @param[in]  page        Which page to load
+     *  @param[out] result      Status of the device read
+     *  @return Line *          The filled line, or nullptr if the read failed
+     */
+    Line *fill( const size_t page, Aurora::Memory::Status &result )
+    {
+      Line *victim = &mLines[ 0 ];
+
+      for ( auto &line : mLines )
+      {
+        if ( !line.valid )
+        {
+          victim = &line;
+          break;
+        }
+        else if ( line.lastUse < victim->lastUse )
+        {
+          victim = &line;
+        }
+      }
+
+      result = mDevice.read( page * PageSize, victim->data.data(), PageSize );
+      if ( result != Aurora::Memory::Status::ERR_OK )
+      {
+        victim->valid = false;
+        return nullptr;
+      }
+
+      victim->valid   = true;
+      victim->page    = page;
+      victim->lastUse = ++mTick;
+      return victim;
+    }
+  };
+}  // namespace Adesto::Adapter
+
+#endif /* !ADESTO_PAGE_CACHE_HPP */
@@ -0,0 +1,370 @@
+/********************************************************************************
+ *  File Name:
+ *    read_ahead.hpp
+ *
+ *  Description:
+ *    Sequential read-ahead stage that can be layered over any generic memory device
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+#pragma once
+#ifndef ADESTO_READ_AHEAD_HPP
+#define ADESTO_READ_AHEAD_HPP
+
+/* STL Includes */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/* Aurora Includes */
+#include <Aurora/memory>
+
+/* Chimera Includes */
+#include <Chimera/thread>
+
+namespace Adesto::Adapter
+{
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct ReadAheadStats
+  {
+    size_t hits;       /**< Number of reads served entirely from the window */
+    size_t prefetches; /**< Number of window fills issued to the device */
+    size_t bypassed;   /**< Number of reads passed straight through to the device */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Wraps a generic memory device with a read-ahead window. Once a read starts
+   *  exactly where the previous one ended, the adapter fetches a whole window
+   *  in one device read and serves the following reads from RAM. Random access
+   *  reads pass straight through, so they never pay for data they don't use.
+   *
+   *  Any write or erase issued through the adapter drops the window if it
+   *  overlaps, so the data only stays coherent if all modifications go
+   *  through this object.
+   *
+   *  @tparam Capacity    Largest window size in bytes that can be configured
+   */
+  template<size_t Capacity>
+  class ReadAhead : public virtual Aurora::Memory::IGenericDevice, public Chimera::Threading::Lockable
+  {
+    static_assert( Capacity, "Read-ahead window must be non-zero" );
+
+  public:
+    ReadAhead( Aurora::Memory::IGenericDevice &device ) :
+        mDevice( device ), mWindowSize( Capacity ), mValid( false ), mStart( 0 ), mEnd( 0 ), mNextAddress( 0 ), mStats( {} )
+    {
+    }
+
+    ~ReadAhead()
+    {
+    }
+
+    /*-------------------------------------------------
+    Generic Memory Device Interface
+    -------------------------------------------------*/
+    Aurora::Memory::Status open() final override
+    {
+      return mDevice.open();
+    }
+
+    Aurora::Memory::Status close() final override
+    {
+      this->lock();
+      drop();
+      auto result = mDevice.close();
+      this->unlock();
+
+      return result;
+    }
+
+    Aurora::Memory::Status write( const size_t address, const void *const data, const size_t length ) final override
+    {
+      this->lock();
+      auto result = mDevice.write( address, data, length );
+      drop( address, length );
+      this->unlock();
+
+      return result;
+    }
+
+    Aurora::Memory::Status read( const size_t address, void *const data, const size_t length ) final override
+    {
+      /*-------------------------------------------------
+      Input Protection
+      -------------------------------------------------*/
+      if ( !data || !length )
+      {
+        return Aurora::Memory::Status::ERR_BAD_ARG;
+      }
+
+      this->lock();
+
+      auto result      = Aurora::Memory::Status::ERR_OK;
+      auto dst         = reinterpret_cast<uint8_t *>( data );
+      size_t bytesDone = 0;
+
+      /*-------------------------------------------------
+      Serve whatever leading portion the window holds
+      -------------------------------------------------*/
+      if ( mValid && ( address >= mStart ) && ( address < mEnd ) )
+      {
+        bytesDone = std::min( mEnd - address, length );
+        memcpy( dst, mWindow.data() + ( address - mStart ), bytesDone );
+      }
+
+      if ( bytesDone == length )
+      {
+        mStats.hits++;
+      }
+      else
+      {
+        const size_t addr      = address + bytesDone;
+        const size_t remaining = length - bytesDone;
+        const bool sequential  = ( address == mNextAddress ) || ( bytesDone != 0 );
+
+        if ( sequential && ( remaining < mWindowSize ) )
+        {
+          /*-------------------------------------------------
+          The stream is continuing. Pull in a full window in
+          one transaction, clipped to the end of the device.
+          -------------------------------------------------*/
+          const size_t devSize = deviceSize();
+          size_t fetch         = mWindowSize;
+
+          if ( devSize && ( addr < devSize ) )
+          {
+            fetch = std::min( fetch, devSize - addr );
+          }
+          fetch = std::max( fetch, remaining );
+
+          mStats.prefetches++;
+          result = mDevice.read( addr, mWindow.data(), fetch );
+
+          if ( result == Aurora::Memory::Status::ERR_OK )
+          {
+            mValid = true;
+            mStart = addr;
+            mEnd   = addr + fetch;
+            memcpy( dst + bytesDone, mWindow.data(), remaining );
+          }
+          else
+          {
+            mValid = false;
+          }
+        }
+        else
+        {
+          /*-------------------------------------------------
+          Random access, or too large to gain anything from
+          buffering. Read it directly into the caller's buffer.
+          -------------------------------------------------*/
+          mStats.bypassed++;
+          result = mDevice.read( addr, dst + bytesDone, remaining );
+        }
+      }
+
+      mNextAddress = address + length;
+      this->unlock();
+      return result;
+    }
+
+    Aurora::Memory::Status erase( const size_t address, const size_t length ) final override
+    {
+      this->lock();
+      auto result = mDevice.erase( address, length );
+      drop( address, length );
+      this->unlock();
+
+      return result;
+    }
+
+    Aurora::Memory::Status erase( const Aurora::Memory::Chunk chunk, const size_t id ) final override
+    {
+      this->lock();
+      auto result = mDevice.erase( chunk, id );
+      drop();
+      this->unlock();
+
+      return result;
+    }
+
+    Aurora::Memory::Status eraseChip() final override
+    {
+      this->lock();
+      auto result = mDevice.eraseChip();
+      drop();
+      this->unlock();
+
+      return result;
+    }
+
+    Aurora::Memory::Status flush() final override
+    {
+      return mDevice.flush();
+    }
+
+    Aurora::Memory::Status pendEvent( const Aurora::Memory::Event event, const size_t timeout ) final override
+    {
+      return mDevice.pendEvent( event, timeout );
+    }
+
+    Aurora::Memory::Status onEvent( const Aurora::Memory::Event event, void ( *func )( const size_t ) ) final override
+    {
+      return mDevice.onEvent( event, func );
+    }
+
+    Aurora::Memory::Status writeProtect( const bool enable, const Aurora::Memory::Chunk chunk, const size_t id ) final override
+    {
+      return mDevice.writeProtect( enable, chunk, id );
+    }
+
+    Aurora::Memory::Status readProtect( const bool enable, const Aurora::Memory::Chunk chunk, const size_t id ) final override
+    {
+      return mDevice.readProtect( enable, chunk, id );
+    }
+
+    Aurora::Memory::Properties getDeviceProperties() final override
+    {
+      return mDevice.getDeviceProperties();
+    }
+
+    /*-------------------------------------------------
+    Read-Ahead Interface
+    -------------------------------------------------*/
+    /**
+     *  Sets how many bytes are fetched each time the window is refilled.
+     *  Larger windows amortize the command overhead over more data at
+     *  the cost of reading past the end of short streams.
+     *
+     *  @param[in]  size        Window size in bytes, up to Capacity
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status setWindowSize( const size_t size )
+    {
+      if ( !size || ( size > Capacity ) )
+      {
+        return Aurora::Memory::Status::ERR_BAD_ARG;
+      }
+
+      this->lock();
+      mWindowSize = size;
+      drop();
+      this->unlock();
+
+      return Aurora::Memory::Status::ERR_OK;
+    }
+
+    /**
+     *  Gets the currently configured window size
+     *
+     *  @return size_t
+     */
+    size_t getWindowSize() const
+    {
+      return mWindowSize;
+    }
+
+    /**
+     *  Drops the buffered window
+     *
+     *  @return void
+     */
+    void invalidate()
+    {
+      this->lock();
+      drop();
+      this->unlock();
+    }
+
+    /**
+     *  Drops the buffered window if it overlaps the given range
+     *
+     *  @param[in]  address     Start of the range
+     *  @param[in]  length      Number of bytes in the range
+     *  @return void
+     */
+    void invalidate( const size_t address, const size_t length )
+    {
+      this->lock();
+      drop( address, length );
+      this->unlock();
+    }
+
+    /**
+     *  Gets the read-ahead counters
+     *
+     *  @return ReadAheadStats
+     */
+    ReadAheadStats getStats() const
+    {
+      return mStats;
+    }
+
+    /**
+     *  Zeros the read-ahead counters
+     *
+     *  @return void
+     */
+    void resetStats()
+    {
+      mStats = {};
+    }
+
+  private:
+    Aurora::Memory::IGenericDevice &mDevice; /**< Device being read from */
+    std::array<uint8_t, Capacity> mWindow;   /**< Read-ahead storage */
+    size_t mWindowSize;                      /**< Bytes fetched per refill */
+    bool mValid;                             /**< Whether the window holds data */
+    size_t mStart;                           /**< Device address of the first buffered byte */
+    size_t mEnd;                             /**< Device address one past the last buffered byte */
+    size_t mNextAddress;                     /**< Address a sequential reader would ask for next */
+    ReadAheadStats mStats;                   /**< Usage counters */
+
+    /**
+     *  Drops the buffered window. Callers hold the lock.
+     *
+     *  @return void
+     */
+    void drop()
+    {
+      mValid = false;
+    }
+
+    /**
+     *  Drops the buffered window if it overlaps the given range. Callers
+     *  hold the lock.
+     *
+     *  @param[in]  address     Start of the range
+     *  @param[in]  length      Number of bytes in the range
+     *  @return void
+     */
+    void drop( const size_t address, const size_t length )
+    {
+      if ( mValid && length && ( address < mEnd ) && ( ( address + length ) > mStart ) )
+      {
+        mValid = false;
+      }
+    }
+
+    /**
+     *  Gets the total size of the device, or zero if it can't be determined
+     *
+     *  @return size_t
+     */
+    size_t deviceSize()
+    {
+      const auto props = mDevice.getDeviceProperties();
+      return props.endAddress ? ( props.endAddress - props.startAddress ) : 0;
+    }
+  };
+}  // namespace Adesto::Adapter
+
+#endif /* !ADESTO_READ_AHEAD_HPP */
@@ -0,0 +1,501 @@
+/********************************************************************************
+ *  File Name:
+ *    scheduler.hpp
+ *
+ *  Description:
+ *    Priority based request scheduler that can front any generic memory device
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+#pragma once
+#ifndef ADESTO_SCHEDULER_HPP
+#define ADESTO_SCHEDULER_HPP
+
+/* STL Includes */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Aurora Includes */
+#include <Aurora/memory>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/thread>
+
+namespace Adesto::Adapter
+{
+  /*-------------------------------------------------------------------------------
+  Enumerations
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Request classes, from most to least urgent
+   */
+  enum class Priority : uint8_t
+  {
+    REALTIME, /**< Latency sensitive accesses, such as table lookups */
+    NORMAL,   /**< General purpose accesses */
+    BULK,     /**< Throughput oriented work, such as logging */
+
+    NUM_OPTIONS
+  };
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct LatencyStats
+  {
+    size_t requests;  /**< Number of requests completed */
+    size_t average;   /**< Running average of the call to completion time in microseconds */
+    size_t maximum;   /**< Slowest call to completion time in microseconds */
+    size_t queueFull; /**< Number of requests that had to wait for space in the queue */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Orders access to a generic memory device by priority class instead of
+   *  arrival order. Every request is broken into steps that never cross a
+   *  page boundary, or a sector boundary for erases, and the scheduler
+   *  picks the next step from the most urgent queued request each time. A
+   *  realtime read therefore only waits for the step in progress rather than
+   *  the whole of a long write. Requests within a class run in arrival order.
+   *
+   *  There is no dedicated worker. A thread blocked in read(), write() or
+   *  erase() executes steps itself whenever the device is free, including
+   *  steps belonging to other threads' requests. While another thread has
+   *  the device it blocks on a semaphore, which is signaled as soon as the
+   *  step in progress finishes. process() lets a periodic thread pump the
+   *  queue as well.
+   *
+   *  Requests in different classes may overlap in time, so a realtime read
+   *  of a range being written by a bulk request can see partially written
+   *  data. Lower classes can be starved by a steady stream of urgent work.
+   *
+   *  @tparam QueueDepth  How many requests may be waiting at once
+   *  @tparam PageSize    Largest read or write step in bytes. Should match the device page size.
+   */
+  template<size_t QueueDepth, size_t PageSize>
+  class Scheduler : public Chimera::Threading::Lockable
+  {
+    static_assert( QueueDepth, "Queue must hold at least one request" );
+    static_assert( PageSize, "Page size must be non-zero" );
+
+  public:
+    Scheduler( Aurora::Memory::IGenericDevice &device ) :
+        mDevice( device ), mCount( 0 ), mSequence( 0 ), mDispatching( false ), mParked( nullptr )
+    {
+      resetStats();
+    }
+
+    ~Scheduler()
+    {
+    }
+
+    /*-------------------------------------------------
+    Scheduler Interface
+    -------------------------------------------------*/
+    /**
+     *  Reads data from the device, returning once all of it has arrived
+     *
+     *  @param[in]  priority    Request class
+     *  @param[in]  address     Address to start reading from
+     *  @param[out] data        Where to place the data
+     *  @param[in]  length      Number of bytes to read
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status read( const Priority priority, const size_t address, void *const data, const size_t length )
+    {
+      if ( !data || !length || ( priority >= Priority::NUM_OPTIONS ) )
+      {
+        return Aurora::Memory::Status::ERR_BAD_ARG;
+      }
+
+      Request request  = {};
+      request.type     = OpType::READ;
+      request.priority = priority;
+      request.address  = address;
+      request.rxData   = reinterpret_cast<uint8_t *>( data );
+      request.length   = length;
+      request.stepSize = PageSize;
+
+      return submit( request );
+    }
+
+    /**
+     *  Writes data to the device, returning once all of it has been programmed
+     *
+     *  @param[in]  priority    Request class
+     *  @param[in]  address     Address to start writing at
+     *  @param[in]  data        Data to be written
+     *  @param[in]  length      Number of bytes to write
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status write( const Priority priority, const size_t address, const void *const data, const size_t length )
+    {
+      if ( !data || !length || ( priority >= Priority::NUM_OPTIONS ) )
+      {
+        return Aurora::Memory::Status::ERR_BAD_ARG;
+      }
+
+      Request request  = {};
+      request.type     = OpType::WRITE;
+      request.priority = priority;
+      request.address  = address;
+      request.txData   = reinterpret_cast<const uint8_t *>( data );
+      request.length   = length;
+      request.stepSize = PageSize;
+
+      return submit( request );
+    }
+
+    /**
+     *  Erases a range of the device one sector at a time, or one block if the
+     *  device reports no sectors, returning once the whole range is erased.
+     *  Each step still goes through the device's own erase planning, so an
+     *  aligned sector is erased with a single large erase.
+     *
+     *  @param[in]  priority    Request class
+     *  @param[in]  address     Address to start erasing at
+     *  @param[in]  length      Number of bytes to erase
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status erase( const Priority priority, const size_t address, const size_t length )
+    {
+      if ( !length || ( priority >= Priority::NUM_OPTIONS ) )
+      {
+        return Aurora::Memory::Status::ERR_BAD_ARG;
+      }
+
+      /*-------------------------------------------------
+      Step at the coarsest granularity the device reports.
+      Without one the range can't be split, so it goes out
+      as a single step.
+      -------------------------------------------------*/
+      const auto props       = mDevice.getDeviceProperties();
+      const size_t eraseStep = std::max( props.blockSize, props.sectorSize );
+
+      Request request  = {};
+      request.type     = OpType::ERASE;
+      request.priority = priority;
+      request.address  = address;
+      request.length   = length;
+      request.stepSize = eraseStep;
+
+      return submit( request );
+    }
+
+    /**
+     *  Executes the next step of the most urgent request, if the device
+     *  isn't already busy with one. Intended to be called from a periodic
+     *  thread so queued work keeps moving while its owners sleep.
+     *
+     *  @return bool            True if a step was executed
+     */
+    bool process()
+    {
+      this->lock();
+      const bool dispatched = !mDispatching && dispatch();
+      this->unlock();
+
+      return dispatched;
+    }
+
+    /**
+     *  Gets how many requests are queued, including any with a step in progress
+     *
+     *  @return size_t
+     */
+    size_t pending()
+    {
+      this->lock();
+      const size_t count = mCount;
+      this->unlock();
+
+      return count;
+    }
+
+    /**
+     *  Gets the latency statistics for a request class
+     *
+     *  @param[in]  priority    Which class to look up
+     *  @return LatencyStats
+     */
+    LatencyStats getStats( const Priority priority )
+    {
+      LatencyStats tmp = {};
+
+      if ( priority < Priority::NUM_OPTIONS )
+      {
+        this->lock();
+        tmp = mStats[ static_cast<size_t>( priority ) ];
+        this->unlock();
+      }
+
+      return tmp;
+    }
+
+    /**
+     *  Zeros the latency statistics of every class
+     *
+     *  @return void
+     */
+    void resetStats()
+    {
+      this->lock();
+      for ( auto &stats : mStats )
+      {
+        stats = {};
+      }
+      this->unlock();
+    }
+
+  private:
+    enum class OpType : uint8_t
+    {
+      READ,
+      WRITE,
+      ERASE
+    };
+
+    struct Request
+    {
+      OpType type;                   /**< What the request does */
+      Priority priority;             /**< Request class */
+      size_t address;                /**< First address of the request */
+      uint8_t *rxData;               /**< Read destination */
+      const uint8_t *txData;         /**< Write source */
+      size_t length;                 /**< Total bytes in the request */
+      size_t stepSize;               /**< Boundary that no single step may cross, zero if none */
+      size_t bytesDone;              /**< Bytes completed so far */
+      size_t sequence;               /**< Arrival order, used to keep each class FIFO */
+      bool complete;                 /**< Whether the request has finished */
+      Aurora::Memory::Status result; /**< Outcome once complete */
+    };
+
+    /**
+     *  A thread blocked until the device is free again
+     */
+    struct Waiter
+    {
+      Chimera::Threading::BinarySemaphore wake; /**< Signaled when the step in progress finishes */
+      Waiter *next;                             /**< Next thread waiting */
+    };
+
+    Aurora::Memory::IGenericDevice &mDevice;                                      /**< Device being scheduled */
+    std::array<Request *, QueueDepth> mQueue;                                     /**< Waiting requests */
+    size_t mCount;                                                                /**< Number of waiting requests */
+    size_t mSequence;                                                             /**< Next arrival number */
+    bool mDispatching;                                                            /**< Whether a step is executing */
+    Waiter *mParked;                                                              /**< Threads waiting for the step to finish */
+    std::array<LatencyStats, static_cast<size_t>( Priority::NUM_OPTIONS )> mStats; /**< Per class latency */
+
+    /**
+     *  Queues a request and helps execute steps until it completes
+     *
+     *  @param[in]  request     Request to run. Must stay alive until this returns.
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status submit( Request &request )
+    {
+      const size_t startTime = Chimera::micros();
+      bool queued            = false;
+      bool waitedForSpace    = false;
+      Waiter waiter;
+
+      while ( true )
+      {
+        this->lock();
+
+        /*-------------------------------------------------
+        Get into the queue. When it's full, keep the device
+        busy with other requests until a slot frees up.
+        -------------------------------------------------*/
+        if ( !queued && ( mCount < QueueDepth ) )
+        {
+          request.sequence   = mSequence++;
+          mQueue[ mCount++ ] = &request;
+          queued             = true;
+        }
+        else if ( !queued && !waitedForSpace )
+        {
+          mStats[ static_cast<size_t>( request.priority ) ].queueFull++;
+          waitedForSpace = true;
+        }
+
+        const bool dispatched = !request.complete && !mDispatching && dispatch();
+        const bool complete   = request.complete;
+
+        if ( complete )
+        {
+          recordLatency( request.priority, Chimera::micros() - startTime );
+        }
+        else if ( !dispatched )
+        {
+          /*-------------------------------------------------
+          Another thread has the device. Get on the list it
+          signals when the step is done, before letting go of
+          the lock so the signal can't be missed.
+          -------------------------------------------------*/
+          waiter.next = mParked;
+          mParked     = &waiter;
+        }
+
+        this->unlock();
+
+        if ( complete )
+        {
+          break;
+        }
+        else if ( !dispatched )
+        {
+          waiter.wake.acquire();
+        }
+      }
+
+      return request.result;
+    }
+
+    /**
+     *  Executes one step of the most urgent request. The lock must be held
+     *  on entry. It is released while the device is being accessed so other
+     *  threads can queue their requests in the meantime.
+     *
+     *  @return bool            True if a step was executed
+     */
+    bool dispatch()
+    {
+      Request *request = select();
+      if ( !request )
+      {
+        return false;
+      }
+
+      /*-------------------------------------------------
+      Clip the step at the next page or block boundary
+      -------------------------------------------------*/
+      const size_t address   = request->address + request->bytesDone;
+      const size_t remaining = request->length - request->bytesDone;
+      const size_t boundary  = request->stepSize ? ( request->stepSize - ( address % request->stepSize ) ) : remaining;
+      const size_t chunk     = std::min( boundary, remaining );
+
+      mDispatching = true;
+      this->unlock();
+
+      auto result = Aurora::Memory::Status::ERR_OK;
+      switch ( request->type )
+      {
+        case OpType::READ:
+          result = mDevice.read( address, request->rxData + request->bytesDone, chunk );
+          break;
+
+        case OpType::WRITE:
+          result = mDevice.write( address, request->txData + request->bytesDone, chunk );
+          break;
+
+        case OpType::ERASE:
+          result = mDevice.erase( address, chunk );
+          break;
+
+        default:
+          result = Aurora::Memory::Status::ERR_UNSUPPORTED;
+          break;
+      };
+
+      this->lock();
+      mDispatching = false;
+      request->bytesDone += chunk;
+
+      if ( ( result != Aurora::Memory::Status::ERR_OK ) || ( request->bytesDone >= request->length ) )
+      {
+        request->result   = result;
+        request->complete = true;
+        remove( request );
+      }
+
+      /*-------------------------------------------------
+      Everyone waiting either has a finished request to
+      collect or can take the next step themselves.
+      -------------------------------------------------*/
+      while ( mParked )
+      {
+        Waiter *waiter = mParked;
+        mParked        = waiter->next;
+        waiter->wake.release();
+      }
+
+      return true;
+    }
+
+    /**
+     *  Finds the oldest request in the most urgent non-empty class
+     *
+     *  @return Request *       The request, or nullptr if the queue is empty
+     */
+    Request *select()
+    {
+      Request *best = nullptr;
+
+      for ( size_t idx = 0; idx < mCount; idx++ )
+      {
+        Request *candidate = mQueue[ idx ];
+
+        if ( !best || ( candidate->priority < best->priority )
+             || ( ( candidate->priority == best->priority ) && ( candidate->sequence < best->sequence ) ) )
+        {
+          best = candidate;
+        }
+      }
+
+      return best;
+    }
+
+    /**
+     *  Takes a finished request out of the queue
+     *
+     *  @param[in]  request     Request to remove
+     *  @return void
+     */
+    void remove( const Request *const request )
+    {
+      for ( size_t idx = 0; idx < mCount; idx++ )
+      {
+        if ( mQueue[ idx ] == request )
+        {
+          mQueue[ idx ] = mQueue[ mCount - 1 ];
+          mCount--;
+          break;
+        }
+      }
+    }
+
+    /**
+     *  Folds a completion time into the statistics of a class
+     *
+     *  @param[in]  priority    Class the request belonged to
+     *  @param[in]  latency     Call to completion time in microseconds
+     *  @return void
+     */
+    void recordLatency( const Priority priority, const size_t latency )
+    {
+      LatencyStats &stats = mStats[ static_cast<size_t>( priority ) ];
+
+      if ( !stats.requests )
+      {
+        stats.average = latency;
+      }
+      else
+      {
+        stats.average = stats.average - ( stats.average / 8 ) + ( latency / 8 );
+      }
+
+      stats.maximum = std::max( stats.maximum, latency );
+      stats.requests++;
+    }
+  };
+}  // namespace Adesto::Adapter
+
+#endif /* !ADESTO_SCHEDULER_HPP */
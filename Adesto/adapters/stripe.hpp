@@ -0,0 +1,457 @@
+/********************************************************************************
+ *  File Name:
+ *    stripe.hpp
+ *
+ *  Description:
+ *    Presents several identical memory devices as one striped device
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+#pragma once
+#ifndef ADESTO_STRIPE_HPP
+#define ADESTO_STRIPE_HPP
+
+/* STL Includes */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Aurora Includes */
+#include <Aurora/memory>
+
+/* Chimera Includes */
+#include <Chimera/thread>
+
+namespace Adesto::Adapter
+{
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Combines identical devices into one larger device, RAID-0 style. The address
+   *  space is split into stripes of StripeSize bytes handed out to the devices in
+   *  turn, so stripe N lives on device N % NumDevices.
+   *
+   *  Writes are issued one stripe at a time, visiting every device before coming
+   *  back to the first. Devices that return from write() and erase() before the
+   *  operation finishes, such as AT25 drivers with setAsync( true ), then program
+   *  and erase in parallel: a device only holds up the loop once it is handed its
+   *  next stripe while still busy with the last one. Each device's share of an
+   *  aligned erase is a single contiguous range, so all devices erase at once.
+   *  Writes and erases return after every device involved reports completion.
+   *
+   *  Reads go out a stripe at a time as well and are not serialized by the
+   *  adapter, so threads reading different stripes use the devices in parallel.
+   *  A single reader sees each device in turn, as the underlying SPI transfers
+   *  block until done.
+   *
+   *  @note Like the other adapters this one owns no worker threads, so it
+   *  never dispatches to several devices at once by itself. A single reader,
+   *  or a writer on devices whose write() blocks until programmed, gets the
+   *  capacity of the combined devices but the bandwidth of one. Overlap only
+   *  comes from asynchronous devices or from several calling threads.
+   *
+   *  Erases must cover whole blocks of the striped device, which span one
+   *  stripe or one device block, whichever is larger, on every device.
+   *
+   *  @tparam NumDevices  How many devices are striped together
+   *  @tparam StripeSize  Bytes placed on one device before moving to the next
+   */
+  template<size_t NumDevices, size_t StripeSize>
+  class Stripe : public virtual Aurora::Memory::IGenericDevice, public Chimera::Threading::Lockable
+  {
+    static_assert( NumDevices, "Must stripe over at least one device" );
+    static_assert( StripeSize && ( ( StripeSize & ( StripeSize - 1 ) ) == 0 ), "Stripe size must be a power of two" );
+
+  public:
+    using DeviceList = std::array<Aurora::Memory::IGenericDevice *, NumDevices>;
+
+    Stripe( const DeviceList &devices ) : mDevices( devices ), mProps( {} )
+    {
+    }
+
+    ~Stripe()
+    {
+    }
+
+    /*-------------------------------------------------
+    Generic Memory Device Interface
+    -------------------------------------------------*/
+    /**
+     *  Opens every device and derives the striped geometry. The devices
+     *  must report identical properties.
+     *
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status open() final override
+    {
+      this->lock();
+      mProps = {};
+
+      auto result = Aurora::Memory::Status::ERR_OK;
+      for ( auto device : mDevices )
+      {
+        if ( !device )
+        {
+          result = Aurora::Memory::Status::ERR_BAD_ARG;
+        }
+        else if ( auto status = device->open(); status != Aurora::Memory::Status::ERR_OK )
+        {
+          result = status;
+        }
+      }
+
+      if ( result == Aurora::Memory::Status::ERR_OK )
+      {
+        result = buildProperties();
+      }
+
+      this->unlock();
+      return result;
+    }
+
+    Aurora::Memory::Status close() final override
+    {
+      this->lock();
+
+      auto result = Aurora::Memory::Status::ERR_OK;
+      for ( auto device : mDevices )
+      {
+        if ( auto status = device->close(); status != Aurora::Memory::Status::ERR_OK )
+        {
+          result = status;
+        }
+      }
+
+      mProps = {};
+      this->unlock();
+      return result;
+    }
+
+    Aurora::Memory::Status write( const size_t address, const void *const data, const size_t length ) final override
+    {
+      if ( !data || !length || !inRange( address, length ) )
+      {
+        return Aurora::Memory::Status::ERR_BAD_ARG;
+      }
+
+      this->lock();
+
+      /*-------------------------------------------------
+      Hand out the stripes in address order, which visits
+      each device in turn and lets them overlap.
+      -------------------------------------------------*/
+      auto result       = Aurora::Memory::Status::ERR_OK;
+      auto src          = reinterpret_cast<const uint8_t *>( data );
+      size_t bytesDone  = 0;
+      DeviceMask active = {};
+
+      while ( bytesDone < length )
+      {
+        const size_t addr  = address + bytesDone;
+        const size_t chunk = std::min( StripeSize - ( addr % StripeSize ), length - bytesDone );
+        const size_t idx   = deviceOf( addr );
+
+        result = mDevices[ idx ]->write( deviceAddress( addr ), src + bytesDone, chunk );
+        if ( result != Aurora::Memory::Status::ERR_OK )
+        {
+          break;
+        }
+
+        active[ idx ] = true;
+        bytesDone += chunk;
+      }
+
+      result = settle( Aurora::Memory::Event::MEM_WRITE_COMPLETE, active, result );
+
+      this->unlock();
+      return result;
+    }
+
+    Aurora::Memory::Status read( const size_t address, void *const data, const size_t length ) final override
+    {
+      if ( !data || !length || !inRange( address, length ) )
+      {
+        return Aurora::Memory::Status::ERR_BAD_ARG;
+      }
+
+      auto result      = Aurora::Memory::Status::ERR_OK;
+      auto dst         = reinterpret_cast<uint8_t *>( data );
+      size_t bytesDone = 0;
+
+      while ( ( bytesDone < length ) && ( result == Aurora::Memory::Status::ERR_OK ) )
+      {
+        const size_t addr  = address + bytesDone;
+        const size_t chunk = std::min( StripeSize - ( addr % StripeSize ), length - bytesDone );
+
+        result = mDevices[ deviceOf( addr ) ]->read( deviceAddress( addr ), dst + bytesDone, chunk );
+        bytesDone += chunk;
+      }
+
+      return result;
+    }
+
+    Aurora::Memory::Status erase( const size_t address, const size_t length ) final override
+    {
+      /*-------------------------------------------------
+      Input Protection: Whole striped blocks only. These
+      map to the same contiguous, block aligned range on
+      every device.
+      -------------------------------------------------*/
+      const size_t blockSize = mProps.blockSize;
+
+      if ( !length || !blockSize || ( address % blockSize ) || ( length % blockSize ) || !inRange( address, length ) )
+      {
+        return Aurora::Memory::Status::ERR_BAD_ARG;
+      }
+
+      this->lock();
+
+      auto result       = Aurora::Memory::Status::ERR_OK;
+      DeviceMask active = {};
+
+      for ( size_t idx = 0; idx < NumDevices; idx++ )
+      {
+        result = mDevices[ idx ]->erase( address / NumDevices, length / NumDevices );
+        if ( result != Aurora::Memory::Status::ERR_OK )
+        {
+          break;
+        }
+
+        active[ idx ] = true;
+      }
+
+      result = settle( Aurora::Memory::Event::MEM_ERASE_COMPLETE, active, result );
+
+      this->unlock();
+      return result;
+    }
+
+    Aurora::Memory::Status erase( const Aurora::Memory::Chunk chunk, const size_t id ) final override
+    {
+      size_t chunkSize = 0;
+
+      switch ( chunk )
+      {
+        case Aurora::Memory::Chunk::BLOCK:
+          chunkSize = mProps.blockSize;
+          break;
+
+        case Aurora::Memory::Chunk::SECTOR:
+          chunkSize = mProps.sectorSize;
+          break;
+
+        default:
+          return Aurora::Memory::Status::ERR_BAD_ARG;
+      };
+
+      return erase( chunkSize * id, chunkSize );
+    }
+
+    Aurora::Memory::Status eraseChip() final override
+    {
+      this->lock();
+
+      auto result       = Aurora::Memory::Status::ERR_OK;
+      DeviceMask active = {};
+
+      for ( size_t idx = 0; idx < NumDevices; idx++ )
+      {
+        result = mDevices[ idx ]->eraseChip();
+        if ( result != Aurora::Memory::Status::ERR_OK )
+        {
+          break;
+        }
+
+        active[ idx ] = true;
+      }
+
+      result = settle( Aurora::Memory::Event::MEM_ERASE_COMPLETE, active, result );
+
+      this->unlock();
+      return result;
+    }
+
+    Aurora::Memory::Status flush() final override
+    {
+      auto result = Aurora::Memory::Status::ERR_OK;
+      for ( auto device : mDevices )
+      {
+        if ( auto status = device->flush(); status != Aurora::Memory::Status::ERR_OK )
+        {
+          result = status;
+        }
+      }
+
+      return result;
+    }
+
+    Aurora::Memory::Status pendEvent( const Aurora::Memory::Event event, const size_t timeout ) final override
+    {
+      /*-------------------------------------------------
+      Devices are waited on one after the other, so the
+      timeout applies to each rather than to the whole.
+      -------------------------------------------------*/
+      auto result = Aurora::Memory::Status::ERR_OK;
+      for ( auto device : mDevices )
+      {
+        if ( auto status = device->pendEvent( event, timeout ); status != Aurora::Memory::Status::ERR_OK )
+        {
+          result = status;
+        }
+      }
+
+      return result;
+    }
+
+    Aurora::Memory::Status onEvent( const Aurora::Memory::Event event, void ( *func )( const size_t ) ) final override
+    {
+      /*-------------------------------------------------
+      Callbacks carry no context, so there is no way to
+      tell which device finished or to combine them.
+      -------------------------------------------------*/
+      return Aurora::Memory::Status::ERR_UNSUPPORTED;
+    }
+
+    Aurora::Memory::Status writeProtect( const bool enable, const Aurora::Memory::Chunk chunk, const size_t id ) final override
+    {
+      return Aurora::Memory::Status::ERR_UNSUPPORTED;
+    }
+
+    Aurora::Memory::Status readProtect( const bool enable, const Aurora::Memory::Chunk chunk, const size_t id ) final override
+    {
+      return Aurora::Memory::Status::ERR_UNSUPPORTED;
+    }
+
+    /**
+     *  Gets the striped geometry. Only valid after open().
+     *
+     *  @return Aurora::Memory::Properties
+     */
+    Aurora::Memory::Properties getDeviceProperties() final override
+    {
+      return mProps;
+    }
+
+    /*-------------------------------------------------
+    Stripe Interface
+    -------------------------------------------------*/
+    /**
+     *  Gets which device holds an address
+     *
+     *  @param[in]  address     Address in the striped space
+     *  @return size_t          Index into the device list
+     */
+    static constexpr size_t deviceOf( const size_t address )
+    {
+      return ( address / StripeSize ) % NumDevices;
+    }
+
+    /**
+     *  Gets where an address lives on the device that holds it
+     *
+     *  @param[in]  address     Address in the striped space
+     *  @return size_t          Address on the device
+     */
+    static constexpr size_t deviceAddress( const size_t address )
+    {
+      return ( ( address / ( StripeSize * NumDevices ) ) * StripeSize ) + ( address % StripeSize );
+    }
+
+  private:
+    using DeviceMask = std::array<bool, NumDevices>;
+
+    DeviceList mDevices;               /**< Devices being striped over */
+    Aurora::Memory::Properties mProps; /**< Striped geometry, filled in by open() */
+
+    bool inRange( const size_t address, const size_t length ) const
+    {
+      return ( address < mProps.endAddress ) && ( length <= ( mProps.endAddress - address ) );
+    }
+
+    /**
+     *  Waits for every device that was handed work to finish it. Devices
+     *  that complete their work before returning don't implement pendEvent(),
+     *  which is taken as already done.
+     *
+     *  @param[in]  event       Completion event to wait on
+     *  @param[in]  active      Which devices were handed work
+     *  @param[in]  result      Outcome of issuing the work
+     *  @return Aurora::Memory::Status  The first error seen, if any
+     */
+    Aurora::Memory::Status settle( const Aurora::Memory::Event event, const DeviceMask &active, Aurora::Memory::Status result )
+    {
+      for ( size_t idx = 0; idx < NumDevices; idx++ )
+      {
+        if ( !active[ idx ] )
+        {
+          continue;
+        }
+
+        const auto status = mDevices[ idx ]->pendEvent( event, Chimera::Threading::TIMEOUT_BLOCK );
+        if ( ( result == Aurora::Memory::Status::ERR_OK ) && ( status != Aurora::Memory::Status::ERR_OK )
+             && ( status != Aurora::Memory::Status::ERR_UNSUPPORTED ) )
+        {
+          result = status;
+        }
+      }
+
+      return result;
+    }
+
+    /**
+     *  Checks that all devices match and scales their geometry up. Striped
+     *  blocks and sectors cover one device block or sector, or one stripe if
+     *  that is larger, on every device.
+     *
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status buildProperties()
+    {
+      const auto device = mDevices[ 0 ]->getDeviceProperties();
+
+      for ( auto other : mDevices )
+      {
+        const auto props = other->getDeviceProperties();
+        if ( ( props.startAddress != device.startAddress ) || ( props.endAddress != device.endAddress )
+             || ( props.pageSize != device.pageSize ) || ( props.blockSize != device.blockSize )
+             || ( props.sectorSize != device.sectorSize ) )
+        {
+          return Aurora::Memory::Status::ERR_UNSUPPORTED;
+        }
+      }
+
+      const size_t deviceSize  = device.endAddress - device.startAddress;
+      const size_t blockSpan   = std::max( StripeSize, device.blockSize );
+      const size_t sectorSpan  = std::max( StripeSize, device.sectorSize );
+      const size_t smallBlock  = std::min( StripeSize, device.blockSize );
+      const size_t smallSector = std::min( StripeSize, device.sectorSize );
+
+      if ( device.startAddress || !deviceSize || !smallBlock || !smallSector || ( deviceSize % sectorSpan )
+           || ( blockSpan % smallBlock ) || ( sectorSpan % smallSector ) )
+      {
+        return Aurora::Memory::Status::ERR_UNSUPPORTED;
+      }
+
+      mProps = device;
+
+      mProps.pageSize = std::min( StripeSize, device.pageSize );
+      mProps.numPages = ( deviceSize * NumDevices ) / mProps.pageSize;
+
+      mProps.blockSize = blockSpan * NumDevices;
+      mProps.numBlocks = deviceSize / blockSpan;
+
+      mProps.sectorSize = sectorSpan * NumDevices;
+      mProps.numSectors = deviceSize / sectorSpan;
+
+      mProps.startAddress = 0;
+      mProps.endAddress   = deviceSize * NumDevices;
+
+      return Aurora::Memory::Status::ERR_OK;
+    }
+  };
+}  // namespace Adesto::Adapter
+
+#endif /* !ADESTO_STRIPE_HPP */
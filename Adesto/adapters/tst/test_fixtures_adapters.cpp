@@ -0,0 +1,326 @@
+/********************************************************************************
+ *  File Name:
+ *    test_fixtures_adapters.cpp
+ *
+ *  Description:
+ *    Provides the RAM backed device and fixtures used in testing the adapters
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+/* Chimera Includes */
+#include <Chimera/common>
+
+/* Test Includes */
+#include "test_fixtures_adapters.hpp"
+
+/*-------------------------------------------------------------------------------
+RAM Device
+-------------------------------------------------------------------------------*/
+RamDevice::RamDevice( const size_t size, const size_t blockSize ) :
+    mMemory( size, 0xFF ), mBlockSize( blockSize ), mActive( 0 ), mMaxActive( 0 )
+{
+  mFailures.fill( Status::ERR_OK );
+}
+
+
+Status RamDevice::open()
+{
+  return Status::ERR_OK;
+}
+
+
+Status RamDevice::close()
+{
+  return Status::ERR_OK;
+}
+
+
+Status RamDevice::write( const size_t address, const void *const data, const size_t length )
+{
+  auto result = record( { Access::WRITE, address, length } );
+
+  if ( ( result == Status::ERR_OK ) && ( !data || !inRange( address, length ) ) )
+  {
+    result = Status::ERR_BAD_ARG;
+  }
+  else if ( result == Status::ERR_OK )
+  {
+    auto src = reinterpret_cast<const uint8_t *>( data );
+    for ( size_t x = 0; x < length; x++ )
+    {
+      mMemory[ address + x ] &= src[ x ];
+    }
+  }
+
+  finish();
+  return result;
+}
+
+
+Status RamDevice::read( const size_t address, void *const data, const size_t length )
+{
+  auto result = record( { Access::READ, address, length } );
+
+  if ( ( result == Status::ERR_OK ) && ( !data || !inRange( address, length ) ) )
+  {
+    result = Status::ERR_BAD_ARG;
+  }
+  else if ( result == Status::ERR_OK )
+  {
+    memcpy( data, mMemory.data() + address, length );
+  }
+
+  finish();
+  return result;
+}
+
+
+Status RamDevice::erase( const size_t address, const size_t length )
+{
+  auto result = record( { Access::ERASE, address, length } );
+
+  if ( ( result == Status::ERR_OK ) && !inRange( address, length ) )
+  {
+    result = Status::ERR_BAD_ARG;
+  }
+  else if ( result == Status::ERR_OK )
+  {
+    memset( mMemory.data() + address, 0xFF, length );
+  }
+
+  finish();
+  return result;
+}
+
+
+Status RamDevice::erase( const Aurora::Memory::Chunk chunk, const size_t id )
+{
+  size_t size = 0;
+
+  switch ( chunk )
+  {
+    case Aurora::Memory::Chunk::PAGE:
+      size = PAGE_SIZE;
+      break;
+
+    case Aurora::Memory::Chunk::BLOCK:
+      size = mBlockSize;
+      break;
+
+    case Aurora::Memory::Chunk::SECTOR:
+      size = SECTOR_SIZE;
+      break;
+
+    default:
+      break;
+  };
+
+  auto result = record( { Access::ERASE_CHUNK, id, size } );
+
+  if ( ( result == Status::ERR_OK ) && ( !size || !inRange( size * id, size ) ) )
+  {
+    result = Status::ERR_BAD_ARG;
+  }
+  else if ( result == Status::ERR_OK )
+  {
+    memset( mMemory.data() + ( size * id ), 0xFF, size );
+  }
+
+  finish();
+  return result;
+}
+
+
+Status RamDevice::eraseChip()
+{
+  auto result = record( { Access::ERASE_CHIP, 0, mMemory.size() } );
+
+  if ( result == Status::ERR_OK )
+  {
+    std::fill( mMemory.begin(), mMemory.end(), 0xFF );
+  }
+
+  finish();
+  return result;
+}
+
+
+Status RamDevice::flush()
+{
+  return Status::ERR_OK;
+}
+
+
+Status RamDevice::pendEvent( const Aurora::Memory::Event event, const size_t timeout )
+{
+  auto result = record( { Access::PEND, 0, 0 } );
+  finish();
+  return result;
+}
+
+
+Status RamDevice::onEvent( const Aurora::Memory::Event event, void ( *func )( const size_t ) )
+{
+  return Status::ERR_UNSUPPORTED;
+}
+
+
+Status RamDevice::writeProtect( const bool enable, const Aurora::Memory::Chunk chunk, const size_t id )
+{
+  return Status::ERR_UNSUPPORTED;
+}
+
+
+Status RamDevice::readProtect( const bool enable, const Aurora::Memory::Chunk chunk, const size_t id )
+{
+  return Status::ERR_UNSUPPORTED;
+}
+
+
+Aurora::Memory::Properties RamDevice::getDeviceProperties()
+{
+  Aurora::Memory::Properties props;
+  props.clear();
+
+  props.pageSize     = PAGE_SIZE;
+  props.numPages     = mMemory.size() / PAGE_SIZE;
+  props.blockSize    = mBlockSize;
+  props.numBlocks    = mBlockSize ? ( mMemory.size() / mBlockSize ) : 0;
+  props.sectorSize   = SECTOR_SIZE;
+  props.numSectors   = mMemory.size() / SECTOR_SIZE;
+  props.startAddress = 0;
+  props.endAddress   = mMemory.size();
+
+  return props;
+}
+
+
+uint8_t *RamDevice::memory()
+{
+  return mMemory.data();
+}
+
+
+std::vector<DeviceAccess> RamDevice::log()
+{
+  std::lock_guard<std::mutex> guard( mLock );
+  return mLog;
+}
+
+
+size_t RamDevice::count( const Access type )
+{
+  std::lock_guard<std::mutex> guard( mLock );
+  return std::count_if( mLog.begin(), mLog.end(), [ type ]( const DeviceAccess &x ) { return x.type == type; } );
+}
+
+
+void RamDevice::clearLog()
+{
+  std::lock_guard<std::mutex> guard( mLock );
+  mLog.clear();
+}
+
+
+void RamDevice::failWith( const Access type, const Status status )
+{
+  std::lock_guard<std::mutex> guard( mLock );
+  mFailures[ static_cast<size_t>( type ) ] = status;
+}
+
+
+void RamDevice::onAccess( std::function<void( const DeviceAccess & )> hook )
+{
+  std::lock_guard<std::mutex> guard( mLock );
+  mHook = hook;
+}
+
+
+size_t RamDevice::maxConcurrent() const
+{
+  return mMaxActive;
+}
+
+
+Status RamDevice::record( const DeviceAccess &access )
+{
+  /*-------------------------------------------------
+  Track overlapping calls before the hook gets a chance
+  to hold this one open
+  -------------------------------------------------*/
+  const size_t active = ++mActive;
+  size_t peak         = mMaxActive;
+
+  while ( ( active > peak ) && !mMaxActive.compare_exchange_weak( peak, active ) )
+  {
+  }
+
+  std::function<void( const DeviceAccess & )> hook;
+  Status result;
+
+  {
+    std::lock_guard<std::mutex> guard( mLock );
+    mLog.push_back( access );
+    hook   = mHook;
+    result = mFailures[ static_cast<size_t>( access.type ) ];
+  }
+
+  if ( hook )
+  {
+    hook( access );
+  }
+
+  return result;
+}
+
+
+void RamDevice::finish()
+{
+  --mActive;
+}
+
+
+bool RamDevice::inRange( const size_t address, const size_t length ) const
+{
+  return ( address < mMemory.size() ) && ( length <= ( mMemory.size() - address ) );
+}
+
+
+/*-------------------------------------------------------------------------------
+Chimera System Backend
+-------------------------------------------------------------------------------*/
+namespace Chimera
+{
+  static const auto s_start = std::chrono::steady_clock::now();
+
+  size_t millis()
+  {
+    const auto elapsed = std::chrono::steady_clock::now() - s_start;
+    return static_cast<size_t>( std::chrono::duration_cast<std::chrono::milliseconds>( elapsed ).count() );
+  }
+
+
+  size_t micros()
+  {
+    const auto elapsed = std::chrono::steady_clock::now() - s_start;
+    return static_cast<size_t>( std::chrono::duration_cast<std::chrono::microseconds>( elapsed ).count() );
+  }
+
+
+  void delayMilliseconds( const size_t val )
+  {
+    std::this_thread::sleep_for( std::chrono::milliseconds( val ) );
+  }
+
+
+  void delayMicroseconds( const size_t val )
+  {
+    std::this_thread::sleep_for( std::chrono::microseconds( val ) );
+  }
+}  // namespace Chimera
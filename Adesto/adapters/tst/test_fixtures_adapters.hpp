@@ -0,0 +1,192 @@
+/********************************************************************************
+ *  File Name:
+ *    test_fixtures_adapters.hpp
+ *
+ *  Description:
+ *    Provides the RAM backed device and fixtures used in testing the adapters
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+#pragma once
+#ifndef ADESTO_ADAPTERS_TEST_FIXTURES_HPP
+#define ADESTO_ADAPTERS_TEST_FIXTURES_HPP
+
+/* STL Includes */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/* Aurora Includes */
+#include <Aurora/memory>
+
+/* Test Includes */
+#include <gtest/gtest.h>
+
+using Status = Aurora::Memory::Status;
+
+/*-------------------------------------------------------------------------------
+Enumerations
+-------------------------------------------------------------------------------*/
+enum class Access : uint8_t
+{
+  READ,
+  WRITE,
+  ERASE,
+  ERASE_CHUNK,
+  ERASE_CHIP,
+  PEND
+};
+
+/*-------------------------------------------------------------------------------
+Structures
+-------------------------------------------------------------------------------*/
+struct DeviceAccess
+{
+  Access type;    /**< Which call was made */
+  size_t address; /**< Address, or chunk id for chunk erases */
+  size_t length;  /**< Number of bytes */
+};
+
+/*-------------------------------------------------------------------------------
+Classes
+-------------------------------------------------------------------------------*/
+/**
+ *  Generic memory device held entirely in RAM. Writes follow NOR semantics
+ *  and can only clear bits, erases set bytes to 0xFF. Every call is recorded
+ *  in order so tests can check exactly what an adapter asked the device for.
+ */
+class RamDevice : public Aurora::Memory::IGenericDevice
+{
+public:
+  static constexpr size_t PAGE_SIZE   = 256;
+  static constexpr size_t BLOCK_SIZE  = 4096;
+  static constexpr size_t SECTOR_SIZE = 65536;
+
+  /**
+   *  @param[in]  size        Capacity in bytes
+   *  @param[in]  blockSize   Reported erase block size, zero if unknown
+   */
+  RamDevice( const size_t size, const size_t blockSize = BLOCK_SIZE );
+  ~RamDevice() = default;
+
+  /*-------------------------------------------------
+  Generic Memory Device Interface
+  -------------------------------------------------*/
+  Status open() final override;
+  Status close() final override;
+  Status write( const size_t address, const void *const data, const size_t length ) final override;
+  Status read( const size_t address, void *const data, const size_t length ) final override;
+  Status erase( const size_t address, const size_t length ) final override;
+  Status erase( const Aurora::Memory::Chunk chunk, const size_t id ) final override;
+  Status eraseChip() final override;
+  Status flush() final override;
+  Status pendEvent( const Aurora::Memory::Event event, const size_t timeout ) final override;
+  Status onEvent( const Aurora::Memory::Event event, void ( *func )( const size_t ) ) final override;
+  Status writeProtect( const bool enable, const Aurora::Memory::Chunk chunk, const size_t id ) final override;
+  Status readProtect( const bool enable, const Aurora::Memory::Chunk chunk, const size_t id ) final override;
+  Aurora::Memory::Properties getDeviceProperties() final override;
+
+  /*-------------------------------------------------
+  Test Interface
+  -------------------------------------------------*/
+  /**
+   *  Gets direct access to the memory array
+   */
+  uint8_t *memory();
+
+  /**
+   *  Gets every call made since the last clearLog(), in order
+   */
+  std::vector<DeviceAccess> log();
+
+  /**
+   *  Counts the logged calls of one type
+   */
+  size_t count( const Access type );
+
+  /**
+   *  Forgets the logged calls
+   */
+  void clearLog();
+
+  /**
+   *  Makes calls of one type fail with the given status until cleared
+   *  with Status::ERR_OK
+   */
+  void failWith( const Access type, const Status status );
+
+  /**
+   *  Installs a function that runs at the start of every call, from the
+   *  calling thread, so tests can hold the device in the middle of a call
+   */
+  void onAccess( std::function<void( const DeviceAccess & )> hook );
+
+  /**
+   *  Gets the most calls that were ever in progress at the same time
+   */
+  size_t maxConcurrent() const;
+
+private:
+  std::vector<uint8_t> mMemory;
+  size_t mBlockSize;
+  std::mutex mLock;
+  std::vector<DeviceAccess> mLog;
+  std::array<Status, static_cast<size_t>( Access::PEND ) + 1> mFailures;
+  std::function<void( const DeviceAccess & )> mHook;
+  std::atomic<size_t> mActive;
+  std::atomic<size_t> mMaxActive;
+
+  Status record( const DeviceAccess &access );
+  void finish();
+  bool inRange( const size_t address, const size_t length ) const;
+};
+
+
+/**
+ *  Provides a RAM backed device for an adapter to wrap
+ */
+class RamBacked : public ::testing::Test
+{
+protected:
+  static constexpr size_t DEVICE_SIZE = 16 * RamDevice::SECTOR_SIZE;
+
+  RamDevice device;
+
+  RamBacked() : device( DEVICE_SIZE )
+  {
+  }
+
+  virtual ~RamBacked() = default;
+
+  /**
+   *  Fills a buffer with a pattern that differs between seeds and never
+   *  repeats within a page, so misplaced bytes can't go unnoticed.
+   */
+  template<size_t L>
+  void pattern( std::array<uint8_t, L> &data, const uint8_t seed )
+  {
+    for ( size_t x = 0; x < L; x++ )
+    {
+      data[ x ] = static_cast<uint8_t>( ( x * 7 ) + ( x >> 8 ) + seed );
+    }
+  }
+
+  /**
+   *  Fills the device array with its own address pattern
+   */
+  void patternDevice()
+  {
+    for ( size_t x = 0; x < DEVICE_SIZE; x++ )
+    {
+      device.memory()[ x ] = static_cast<uint8_t>( ( x * 7 ) + ( x >> 8 ) );
+    }
+  }
+};
+
+#endif /* !ADESTO_ADAPTERS_TEST_FIXTURES_HPP */
@@ -0,0 +1,227 @@
+/********************************************************************************
+ *  File Name:
+ *    test_page_cache.cpp
+ *
+ *  Description:
+ *    Tests the LRU page read cache adapter
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <cstring>
+
+/* Adesto Includes */
+#include <Adesto/adapters/page_cache.hpp>
+
+/* Test Includes */
+#include <gtest/gtest.h>
+#include "test_fixtures_adapters.hpp"
+
+using namespace Adesto::Adapter;
+
+static constexpr size_t PAGE  = RamDevice::PAGE_SIZE;
+static constexpr size_t LINES = 3;
+
+using Cache = PageCache<PAGE, LINES>;
+
+/**
+ *  Reads a single byte from each page given, in order
+ */
+template<size_t N>
+static void touch( Cache &cache, const std::array<size_t, N> &pages )
+{
+  uint8_t value = 0;
+  for ( auto page : pages )
+  {
+    ASSERT_EQ( Status::ERR_OK, cache.read( page * PAGE, &value, 1 ) );
+  }
+}
+
+/*-------------------------------------------------
+Lookups
+-------------------------------------------------*/
+TEST_F( RamBacked, Cache_MissFillsWholePage )
+{
+  std::array<uint8_t, 10> readData;
+  Cache cache( device );
+  patternDevice();
+
+  ASSERT_EQ( Status::ERR_OK, cache.read( 300, readData.data(), readData.size() ) );
+  EXPECT_EQ( 0, memcmp( readData.data(), device.memory() + 300, readData.size() ) );
+
+  const auto log = device.log();
+  ASSERT_EQ( 1u, log.size() );
+  EXPECT_EQ( Access::READ, log[ 0 ].type );
+  EXPECT_EQ( PAGE, log[ 0 ].address );
+  EXPECT_EQ( PAGE, log[ 0 ].length );
+  EXPECT_EQ( 1u, cache.getStats().misses );
+}
+
+TEST_F( RamBacked, Cache_HitServedFromRam )
+{
+  std::array<uint8_t, 10> readData;
+  Cache cache( device );
+  patternDevice();
+
+  ASSERT_EQ( Status::ERR_OK, cache.read( 300, readData.data(), readData.size() ) );
+  ASSERT_EQ( Status::ERR_OK, cache.read( 400, readData.data(), readData.size() ) );
+
+  EXPECT_EQ( 0, memcmp( readData.data(), device.memory() + 400, readData.size() ) );
+  EXPECT_EQ( 1u, device.count( Access::READ ) );
+  EXPECT_EQ( 1u, cache.getStats().hits );
+  EXPECT_EQ( 1u, cache.getStats().misses );
+}
+
+TEST_F( RamBacked, Cache_ReadSpansPages )
+{
+  std::array<uint8_t, 2 * PAGE> readData;
+  Cache cache( device );
+  patternDevice();
+
+  ASSERT_EQ( Status::ERR_OK, cache.read( 100, readData.data(), readData.size() ) );
+  EXPECT_EQ( 0, memcmp( readData.data(), device.memory() + 100, readData.size() ) );
+  EXPECT_EQ( 3u, device.count( Access::READ ) );
+}
+
+TEST_F( RamBacked, Cache_BadArguments )
+{
+  uint8_t value = 0;
+  Cache cache( device );
+
+  EXPECT_EQ( Status::ERR_BAD_ARG, cache.read( 0, nullptr, 1 ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, cache.read( 0, &value, 0 ) );
+  EXPECT_EQ( 0u, device.log().size() );
+}
+
+TEST_F( RamBacked, Cache_FailedFillIsNotKept )
+{
+  uint8_t value = 0;
+  Cache cache( device );
+
+  device.failWith( Access::READ, Status::ERR_DRIVER_ERR );
+  EXPECT_EQ( Status::ERR_DRIVER_ERR, cache.read( 0, &value, 1 ) );
+
+  device.failWith( Access::READ, Status::ERR_OK );
+  EXPECT_EQ( Status::ERR_OK, cache.read( 0, &value, 1 ) );
+  EXPECT_EQ( 2u, device.count( Access::READ ) );
+  EXPECT_EQ( 0u, cache.getStats().hits );
+}
+
+/*-------------------------------------------------
+Eviction
+-------------------------------------------------*/
+TEST_F( RamBacked, Cache_EvictsLeastRecentlyUsed )
+{
+  Cache cache( device );
+
+  /*-------------------------------------------------
+  Page 0 is refreshed after page 1 was loaded, which
+  leaves page 1 as the oldest when page 3 needs a line.
+  -------------------------------------------------*/
+  touch( cache, std::array<size_t, 5>{ 0, 1, 2, 0, 3 } );
+  EXPECT_EQ( 4u, device.count( Access::READ ) );
+
+  device.clearLog();
+  touch( cache, std::array<size_t, 3>{ 0, 2, 3 } );
+  EXPECT_EQ( 0u, device.count( Access::READ ) );
+
+  touch( cache, std::array<size_t, 1>{ 1 } );
+  ASSERT_EQ( 1u, device.count( Access::READ ) );
+  EXPECT_EQ( PAGE, device.log()[ 0 ].address );
+}
+
+TEST_F( RamBacked, Cache_EvictionFollowsEveryHit )
+{
+  Cache cache( device );
+
+  /*-------------------------------------------------
+  Hits reorder the lines too, so after these accesses
+  page 2 is the oldest rather than page 0.
+  -------------------------------------------------*/
+  touch( cache, std::array<size_t, 6>{ 0, 1, 2, 1, 0, 4 } );
+  device.clearLog();
+
+  touch( cache, std::array<size_t, 2>{ 0, 1 } );
+  EXPECT_EQ( 0u, device.count( Access::READ ) );
+
+  touch( cache, std::array<size_t, 1>{ 2 } );
+  EXPECT_EQ( 1u, device.count( Access::READ ) );
+}
+
+/*-------------------------------------------------
+Coherency
+-------------------------------------------------*/
+TEST_F( RamBacked, Cache_WriteInvalidatesOverlappingPages )
+{
+  const std::array<uint8_t, 2> data = { 0x12, 0x34 };
+  std::array<uint8_t, 2> readData;
+
+  Cache cache( device );
+  touch( cache, std::array<size_t, 3>{ 0, 1, 2 } );
+  device.clearLog();
+
+  /*-------------------------------------------------
+  The write straddles pages 0 and 1, page 2 is untouched
+  -------------------------------------------------*/
+  ASSERT_EQ( Status::ERR_OK, cache.write( PAGE - 1, data.data(), data.size() ) );
+  ASSERT_EQ( Status::ERR_OK, cache.read( PAGE - 1, readData.data(), readData.size() ) );
+  EXPECT_EQ( 0, memcmp( readData.data(), data.data(), data.size() ) );
+  EXPECT_EQ( 2u, device.count( Access::READ ) );
+
+  touch( cache, std::array<size_t, 1>{ 2 } );
+  EXPECT_EQ( 2u, device.count( Access::READ ) );
+}
+
+TEST_F( RamBacked, Cache_EraseInvalidatesRange )
+{
+  static constexpr size_t firstPage = RamDevice::BLOCK_SIZE / PAGE;
+
+  uint8_t value = 0;
+  Cache cache( device );
+  memset( device.memory(), 0, 2 * RamDevice::BLOCK_SIZE );
+
+  touch( cache, std::array<size_t, 2>{ 0, firstPage } );
+  device.clearLog();
+
+  ASSERT_EQ( Status::ERR_OK, cache.erase( RamDevice::BLOCK_SIZE, RamDevice::BLOCK_SIZE ) );
+  ASSERT_EQ( Status::ERR_OK, cache.read( firstPage * PAGE, &value, 1 ) );
+  EXPECT_EQ( 0xFF, value );
+  EXPECT_EQ( 1u, device.count( Access::READ ) );
+
+  ASSERT_EQ( Status::ERR_OK, cache.read( 0, &value, 1 ) );
+  EXPECT_EQ( 0x00, value );
+  EXPECT_EQ( 1u, device.count( Access::READ ) );
+}
+
+TEST_F( RamBacked, Cache_EraseChunkInvalidatesChunk )
+{
+  static constexpr size_t firstPage = RamDevice::BLOCK_SIZE / PAGE;
+
+  uint8_t value = 0;
+  Cache cache( device );
+  memset( device.memory(), 0, 2 * RamDevice::BLOCK_SIZE );
+
+  touch( cache, std::array<size_t, 3>{ 0, firstPage, ( 2 * firstPage ) - 1 } );
+  device.clearLog();
+
+  ASSERT_EQ( Status::ERR_OK, cache.erase( Aurora::Memory::Chunk::BLOCK, 1 ) );
+  touch( cache, std::array<size_t, 1>{ 0 } );
+  EXPECT_EQ( 0u, device.count( Access::READ ) );
+
+  ASSERT_EQ( Status::ERR_OK, cache.read( ( ( 2 * firstPage ) - 1 ) * PAGE, &value, 1 ) );
+  EXPECT_EQ( 0xFF, value );
+  EXPECT_EQ( 1u, device.count( Access::READ ) );
+}
+
+TEST_F( RamBacked, Cache_EraseChipInvalidatesEverything )
+{
+  Cache cache( device );
+  touch( cache, std::array<size_t, 3>{ 0, 1, 2 } );
+  device.clearLog();
+
+  ASSERT_EQ( Status::ERR_OK, cache.eraseChip() );
+  touch( cache, std::array<size_t, 3>{ 0, 1, 2 } );
+  EXPECT_EQ( 3u, device.count( Access::READ ) );
+}
@@ -0,0 +1,233 @@
+/********************************************************************************
+ *  File Name:
+ *    test_read_ahead.cpp
+ *
+ *  Description:
+ *    Tests the sequential read-ahead adapter
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <cstring>
+
+/* Adesto Includes */
+#include <Adesto/adapters/read_ahead.hpp>
+
+/* Test Includes */
+#include <gtest/gtest.h>
+#include "test_fixtures_adapters.hpp"
+
+using namespace Adesto::Adapter;
+
+static constexpr size_t WINDOW = 1024;
+static constexpr size_t START  = 5000;
+static constexpr size_t LEN    = 16;
+
+using Window = ReadAhead<WINDOW>;
+
+/**
+ *  Starts a sequential stream at START, leaving a full window buffered
+ *  from START + LEN
+ */
+static void startStream( Window &adapter, RamDevice &device )
+{
+  std::array<uint8_t, LEN> readData;
+
+  ASSERT_EQ( Status::ERR_OK, adapter.read( START, readData.data(), readData.size() ) );
+  ASSERT_EQ( Status::ERR_OK, adapter.read( START + LEN, readData.data(), readData.size() ) );
+  ASSERT_EQ( 1u, adapter.getStats().prefetches );
+  device.clearLog();
+}
+
+/*-------------------------------------------------
+Stream Detection
+-------------------------------------------------*/
+TEST_F( RamBacked, ReadAhead_RandomReadBypasses )
+{
+  std::array<uint8_t, LEN> readData;
+  Window adapter( device );
+  patternDevice();
+
+  ASSERT_EQ( Status::ERR_OK, adapter.read( START, readData.data(), readData.size() ) );
+  EXPECT_EQ( 0, memcmp( readData.data(), device.memory() + START, LEN ) );
+
+  const auto log = device.log();
+  ASSERT_EQ( 1u, log.size() );
+  EXPECT_EQ( START, log[ 0 ].address );
+  EXPECT_EQ( LEN, log[ 0 ].length );
+  EXPECT_EQ( 1u, adapter.getStats().bypassed );
+}
+
+TEST_F( RamBacked, ReadAhead_SequentialReadFetchesWindow )
+{
+  std::array<uint8_t, LEN> readData;
+  Window adapter( device );
+  patternDevice();
+
+  ASSERT_EQ( Status::ERR_OK, adapter.read( START, readData.data(), readData.size() ) );
+  ASSERT_EQ( Status::ERR_OK, adapter.read( START + LEN, readData.data(), readData.size() ) );
+  EXPECT_EQ( 0, memcmp( readData.data(), device.memory() + START + LEN, LEN ) );
+
+  const auto log = device.log();
+  ASSERT_EQ( 2u, log.size() );
+  EXPECT_EQ( START + LEN, log[ 1 ].address );
+  EXPECT_EQ( WINDOW, log[ 1 ].length );
+}
+
+TEST_F( RamBacked, ReadAhead_StreamServedFromWindow )
+{
+  std::array<uint8_t, LEN> readData;
+  Window adapter( device );
+  patternDevice();
+  startStream( adapter, device );
+
+  for ( size_t addr = START + ( 2 * LEN ); addr < ( START + LEN + WINDOW ); addr += LEN )
+  {
+    ASSERT_EQ( Status::ERR_OK, adapter.read( addr, readData.data(), readData.size() ) );
+    ASSERT_EQ( 0, memcmp( readData.data(), device.memory() + addr, LEN ) );
+  }
+
+  EXPECT_EQ( 0u, device.log().size() );
+  EXPECT_EQ( ( WINDOW / LEN ) - 1, adapter.getStats().hits );
+}
+
+TEST_F( RamBacked, ReadAhead_StraddlingReadRefills )
+{
+  std::array<uint8_t, 2 * LEN> readData;
+  Window adapter( device );
+  patternDevice();
+  startStream( adapter, device );
+
+  /*-------------------------------------------------
+  The head comes from the old window and the rest from
+  a new one starting right where the old one ended.
+  -------------------------------------------------*/
+  const size_t windowEnd = START + LEN + WINDOW;
+
+  ASSERT_EQ( Status::ERR_OK, adapter.read( windowEnd - LEN, readData.data(), readData.size() ) );
+  EXPECT_EQ( 0, memcmp( readData.data(), device.memory() + windowEnd - LEN, readData.size() ) );
+
+  const auto log = device.log();
+  ASSERT_EQ( 1u, log.size() );
+  EXPECT_EQ( windowEnd, log[ 0 ].address );
+  EXPECT_EQ( WINDOW, log[ 0 ].length );
+}
+
+TEST_F( RamBacked, ReadAhead_JumpRestartsStream )
+{
+  static constexpr size_t elsewhere = 3 * START;
+
+  std::array<uint8_t, LEN> readData;
+  Window adapter( device );
+  patternDevice();
+  startStream( adapter, device );
+
+  /*-------------------------------------------------
+  Leaving the stream goes straight to the device, and
+  the window only follows once the new stream continues.
+  -------------------------------------------------*/
+  ASSERT_EQ( Status::ERR_OK, adapter.read( elsewhere, readData.data(), readData.size() ) );
+  EXPECT_EQ( 2u, adapter.getStats().bypassed );
+  EXPECT_EQ( LEN, device.log()[ 0 ].length );
+
+  ASSERT_EQ( Status::ERR_OK, adapter.read( elsewhere + LEN, readData.data(), readData.size() ) );
+  EXPECT_EQ( 0, memcmp( readData.data(), device.memory() + elsewhere + LEN, LEN ) );
+  EXPECT_EQ( 2u, adapter.getStats().prefetches );
+
+  const auto log = device.log();
+  ASSERT_EQ( 2u, log.size() );
+  EXPECT_EQ( elsewhere + LEN, log[ 1 ].address );
+  EXPECT_EQ( WINDOW, log[ 1 ].length );
+}
+
+TEST_F( RamBacked, ReadAhead_SkipAheadBypasses )
+{
+  std::array<uint8_t, LEN> readData;
+  Window adapter( device );
+  startStream( adapter, device );
+
+  ASSERT_EQ( Status::ERR_OK, adapter.read( START + LEN + WINDOW + 1, readData.data(), readData.size() ) );
+  EXPECT_EQ( 2u, adapter.getStats().bypassed );
+  EXPECT_EQ( 1u, adapter.getStats().prefetches );
+}
+
+TEST_F( RamBacked, ReadAhead_LargeReadBypasses )
+{
+  std::array<uint8_t, WINDOW> readData;
+  Window adapter( device );
+  patternDevice();
+
+  ASSERT_EQ( Status::ERR_OK, adapter.read( START, readData.data(), LEN ) );
+  ASSERT_EQ( Status::ERR_OK, adapter.read( START + LEN, readData.data(), readData.size() ) );
+
+  EXPECT_EQ( 0, memcmp( readData.data(), device.memory() + START + LEN, readData.size() ) );
+  EXPECT_EQ( 0u, adapter.getStats().prefetches );
+  EXPECT_EQ( 2u, adapter.getStats().bypassed );
+}
+
+TEST_F( RamBacked, ReadAhead_WindowClippedAtDeviceEnd )
+{
+  std::array<uint8_t, LEN> readData;
+  Window adapter( device );
+
+  ASSERT_EQ( Status::ERR_OK, adapter.read( DEVICE_SIZE - ( 3 * LEN ), readData.data(), readData.size() ) );
+  ASSERT_EQ( Status::ERR_OK, adapter.read( DEVICE_SIZE - ( 2 * LEN ), readData.data(), readData.size() ) );
+
+  const auto log = device.log();
+  ASSERT_EQ( 2u, log.size() );
+  EXPECT_EQ( 2 * LEN, log[ 1 ].length );
+}
+
+/*-------------------------------------------------
+Configuration and Coherency
+-------------------------------------------------*/
+TEST_F( RamBacked, ReadAhead_WindowSize )
+{
+  std::array<uint8_t, LEN> readData;
+  Window adapter( device );
+
+  EXPECT_EQ( Status::ERR_BAD_ARG, adapter.setWindowSize( 0 ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, adapter.setWindowSize( WINDOW + 1 ) );
+  EXPECT_EQ( WINDOW, adapter.getWindowSize() );
+
+  ASSERT_EQ( Status::ERR_OK, adapter.setWindowSize( 4 * LEN ) );
+  ASSERT_EQ( Status::ERR_OK, adapter.read( 0, readData.data(), readData.size() ) );
+  EXPECT_EQ( 4 * LEN, device.log()[ 0 ].length );
+}
+
+TEST_F( RamBacked, ReadAhead_WriteDropsOverlappingWindow )
+{
+  const uint8_t value = 0x00;
+  uint8_t readValue   = 0xFF;
+
+  Window adapter( device );
+  startStream( adapter, device );
+
+  /*-------------------------------------------------
+  Writes outside the window leave it alone
+  -------------------------------------------------*/
+  ASSERT_EQ( Status::ERR_OK, adapter.write( START, &value, 1 ) );
+  ASSERT_EQ( Status::ERR_OK, adapter.read( START + ( 2 * LEN ), &readValue, 1 ) );
+  EXPECT_EQ( 0u, device.count( Access::READ ) );
+
+  ASSERT_EQ( Status::ERR_OK, adapter.write( START + ( 3 * LEN ), &value, 1 ) );
+  ASSERT_EQ( Status::ERR_OK, adapter.read( START + ( 3 * LEN ), &readValue, 1 ) );
+  EXPECT_EQ( value, readValue );
+  EXPECT_EQ( 1u, device.count( Access::READ ) );
+}
+
+TEST_F( RamBacked, ReadAhead_EraseDropsOverlappingWindow )
+{
+  uint8_t readValue = 0x00;
+
+  Window adapter( device );
+  memset( device.memory(), 0, 2 * RamDevice::BLOCK_SIZE );
+  startStream( adapter, device );
+
+  ASSERT_EQ( Status::ERR_OK, adapter.erase( RamDevice::BLOCK_SIZE, RamDevice::BLOCK_SIZE ) );
+  ASSERT_EQ( Status::ERR_OK, adapter.read( START + ( 2 * LEN ), &readValue, 1 ) );
+  EXPECT_EQ( 0xFF, readValue );
+  EXPECT_EQ( 1u, device.count( Access::READ ) );
+}
@@ -0,0 +1,335 @@
+/********************************************************************************
+ *  File Name:
+ *    test_scheduler.cpp
+ *
+ *  Description:
+ *    Tests the priority request scheduler adapter
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/* Adesto Includes */
+#include <Adesto/adapters/scheduler.hpp>
+
+/* Test Includes */
+#include <gtest/gtest.h>
+#include "test_fixtures_adapters.hpp"
+
+using namespace Adesto::Adapter;
+
+static constexpr size_t PAGE   = RamDevice::PAGE_SIZE;
+static constexpr size_t BLOCK  = RamDevice::BLOCK_SIZE;
+static constexpr size_t SECTOR = RamDevice::SECTOR_SIZE;
+
+using Sched = Scheduler<4, PAGE>;
+
+/**
+ *  Holds the first write step of a request on the device until a condition
+ *  is met, so other threads can queue up behind it in a known state
+ */
+class HeldWrite
+{
+public:
+  HeldWrite( RamDevice &device, std::function<bool()> release ) : mStarted( false )
+  {
+    device.onAccess( [ this, release ]( const DeviceAccess &access ) {
+      if ( ( access.type == Access::WRITE ) && !mStarted.exchange( true ) )
+      {
+        while ( !release() )
+        {
+          std::this_thread::yield();
+        }
+      }
+    } );
+  }
+
+  /**
+   *  Blocks until the held step has reached the device
+   */
+  void awaitStart()
+  {
+    while ( !mStarted )
+    {
+      std::this_thread::yield();
+    }
+  }
+
+private:
+  std::atomic<bool> mStarted;
+};
+
+/*-------------------------------------------------
+Input Protection
+-------------------------------------------------*/
+TEST_F( RamBacked, Sched_BadArguments )
+{
+  uint8_t value = 0;
+  Sched sched( device );
+
+  EXPECT_EQ( Status::ERR_BAD_ARG, sched.read( Priority::NORMAL, 0, nullptr, 1 ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, sched.read( Priority::NORMAL, 0, &value, 0 ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, sched.read( Priority::NUM_OPTIONS, 0, &value, 1 ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, sched.write( Priority::NORMAL, 0, nullptr, 1 ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, sched.erase( Priority::NORMAL, 0, 0 ) );
+  EXPECT_EQ( 0u, device.log().size() );
+}
+
+/*-------------------------------------------------
+Step Clipping
+-------------------------------------------------*/
+TEST_F( RamBacked, Sched_ReadStepsStopAtPages )
+{
+  std::array<uint8_t, 600> readData;
+  Sched sched( device );
+  patternDevice();
+
+  ASSERT_EQ( Status::ERR_OK, sched.read( Priority::NORMAL, 100, readData.data(), readData.size() ) );
+  EXPECT_EQ( 0, memcmp( readData.data(), device.memory() + 100, readData.size() ) );
+
+  const auto log = device.log();
+  ASSERT_EQ( 3u, log.size() );
+  EXPECT_EQ( 100u, log[ 0 ].address );
+  EXPECT_EQ( PAGE - 100, log[ 0 ].length );
+  EXPECT_EQ( PAGE, log[ 1 ].address );
+  EXPECT_EQ( PAGE, log[ 1 ].length );
+  EXPECT_EQ( 2 * PAGE, log[ 2 ].address );
+  EXPECT_EQ( 700 - ( 2 * PAGE ), log[ 2 ].length );
+}
+
+TEST_F( RamBacked, Sched_WriteStepsStopAtPages )
+{
+  std::array<uint8_t, 2 * PAGE> data;
+  Sched sched( device );
+  pattern( data, 4 );
+
+  ASSERT_EQ( Status::ERR_OK, sched.write( Priority::BULK, PAGE / 2, data.data(), data.size() ) );
+  EXPECT_EQ( 0, memcmp( device.memory() + ( PAGE / 2 ), data.data(), data.size() ) );
+
+  const auto log = device.log();
+  ASSERT_EQ( 3u, log.size() );
+  EXPECT_EQ( PAGE / 2, log[ 0 ].length );
+  EXPECT_EQ( PAGE, log[ 1 ].length );
+  EXPECT_EQ( PAGE / 2, log[ 2 ].length );
+}
+
+TEST_F( RamBacked, Sched_EraseStepsStopAtSectors )
+{
+  Sched sched( device );
+
+  ASSERT_EQ( Status::ERR_OK, sched.erase( Priority::NORMAL, SECTOR / 2, 2 * SECTOR ) );
+
+  const auto log = device.log();
+  ASSERT_EQ( 3u, log.size() );
+  EXPECT_EQ( SECTOR / 2, log[ 0 ].address );
+  EXPECT_EQ( SECTOR / 2, log[ 0 ].length );
+  EXPECT_EQ( SECTOR, log[ 1 ].address );
+  EXPECT_EQ( SECTOR, log[ 1 ].length );
+  EXPECT_EQ( 2 * SECTOR, log[ 2 ].address );
+  EXPECT_EQ( SECTOR / 2, log[ 2 ].length );
+}
+
+TEST_F( RamBacked, Sched_AlignedSectorEraseIsOneStep )
+{
+  Sched sched( device );
+
+  /*-------------------------------------------------
+  Splitting this into blocks would stop the device from
+  using its single sector erase.
+  -------------------------------------------------*/
+  ASSERT_EQ( Status::ERR_OK, sched.erase( Priority::NORMAL, SECTOR, SECTOR ) );
+  ASSERT_EQ( 1u, device.log().size() );
+  EXPECT_EQ( SECTOR, device.log()[ 0 ].length );
+}
+
+TEST( Scheduler, Sched_EraseWithoutBlockSizeIsOneStep )
+{
+  RamDevice device( 4 * BLOCK, 0 );
+  Sched sched( device );
+
+  ASSERT_EQ( Status::ERR_OK, sched.erase( Priority::NORMAL, 100, 3 * BLOCK ) );
+  ASSERT_EQ( 1u, device.log().size() );
+  EXPECT_EQ( 3 * BLOCK, device.log()[ 0 ].length );
+}
+
+TEST_F( RamBacked, Sched_FailedStepEndsRequest )
+{
+  std::array<uint8_t, 3 * PAGE> data;
+  Sched sched( device );
+  pattern( data, 1 );
+
+  device.failWith( Access::WRITE, Status::ERR_DRIVER_ERR );
+  EXPECT_EQ( Status::ERR_DRIVER_ERR, sched.write( Priority::NORMAL, 0, data.data(), data.size() ) );
+  EXPECT_EQ( 1u, device.count( Access::WRITE ) );
+  EXPECT_EQ( 0u, sched.pending() );
+}
+
+/*-------------------------------------------------
+Priority Selection
+-------------------------------------------------*/
+TEST_F( RamBacked, Sched_UrgentRequestsGoFirst )
+{
+  std::array<uint8_t, 4 * PAGE> data;
+  std::array<uint8_t, 16> normalData;
+  std::array<uint8_t, 16> urgentData;
+
+  Sched sched( device );
+  HeldWrite held( device, [ &sched ] { return sched.pending() == 3; } );
+  pattern( data, 2 );
+
+  /*-------------------------------------------------
+  A bulk write is in progress when a normal and then a
+  realtime read arrive. Both reads jump the rest of it,
+  the realtime one first despite arriving last.
+  -------------------------------------------------*/
+  std::thread bulk( [ & ] { EXPECT_EQ( Status::ERR_OK, sched.write( Priority::BULK, 0, data.data(), data.size() ) ); } );
+  held.awaitStart();
+
+  std::thread normal( [ & ] { EXPECT_EQ( Status::ERR_OK, sched.read( Priority::NORMAL, 8 * BLOCK, normalData.data(), 16 ) ); } );
+  while ( sched.pending() < 2 )
+  {
+    std::this_thread::yield();
+  }
+
+  std::thread urgent( [ & ] { EXPECT_EQ( Status::ERR_OK, sched.read( Priority::REALTIME, 9 * BLOCK, urgentData.data(), 16 ) ); } );
+
+  bulk.join();
+  normal.join();
+  urgent.join();
+
+  const auto log = device.log();
+  ASSERT_EQ( 6u, log.size() );
+  EXPECT_EQ( Access::WRITE, log[ 0 ].type );
+  EXPECT_EQ( 9 * BLOCK, log[ 1 ].address );
+  EXPECT_EQ( 8 * BLOCK, log[ 2 ].address );
+
+  for ( size_t idx = 3; idx < log.size(); idx++ )
+  {
+    EXPECT_EQ( Access::WRITE, log[ idx ].type );
+  }
+
+  EXPECT_EQ( 0, memcmp( device.memory(), data.data(), data.size() ) );
+  EXPECT_EQ( 1u, sched.getStats( Priority::REALTIME ).requests );
+  EXPECT_EQ( 1u, sched.getStats( Priority::NORMAL ).requests );
+  EXPECT_EQ( 1u, sched.getStats( Priority::BULK ).requests );
+}
+
+TEST_F( RamBacked, Sched_SameClassRunsInArrivalOrder )
+{
+  std::array<uint8_t, 2 * PAGE> data;
+  std::array<std::array<uint8_t, 16>, 2> readData;
+
+  Sched sched( device );
+  HeldWrite held( device, [ &sched ] { return sched.pending() == 3; } );
+  pattern( data, 6 );
+
+  std::thread writer( [ & ] { EXPECT_EQ( Status::ERR_OK, sched.write( Priority::NORMAL, 0, data.data(), data.size() ) ); } );
+  held.awaitStart();
+
+  std::thread first( [ & ] { EXPECT_EQ( Status::ERR_OK, sched.read( Priority::NORMAL, 5 * BLOCK, readData[ 0 ].data(), 16 ) ); } );
+  while ( sched.pending() < 2 )
+  {
+    std::this_thread::yield();
+  }
+
+  std::thread second( [ & ] { EXPECT_EQ( Status::ERR_OK, sched.read( Priority::NORMAL, 6 * BLOCK, readData[ 1 ].data(), 16 ) ); } );
+
+  writer.join();
+  first.join();
+  second.join();
+
+  /*-------------------------------------------------
+  The earlier write keeps its place ahead of both reads
+  -------------------------------------------------*/
+  const auto log = device.log();
+  ASSERT_EQ( 4u, log.size() );
+  EXPECT_EQ( Access::WRITE, log[ 0 ].type );
+  EXPECT_EQ( Access::WRITE, log[ 1 ].type );
+  EXPECT_EQ( 5 * BLOCK, log[ 2 ].address );
+  EXPECT_EQ( 6 * BLOCK, log[ 3 ].address );
+}
+
+TEST_F( RamBacked, Sched_FullQueueWaitsForSpace )
+{
+  std::array<uint8_t, 2 * PAGE> data;
+  std::array<uint8_t, 16> readData;
+
+  Scheduler<1, PAGE> sched( device );
+  HeldWrite held( device, [ &sched ] { return sched.getStats( Priority::REALTIME ).queueFull == 1; } );
+  pattern( data, 8 );
+
+  std::thread writer( [ & ] { EXPECT_EQ( Status::ERR_OK, sched.write( Priority::BULK, 0, data.data(), data.size() ) ); } );
+  held.awaitStart();
+
+  std::thread reader( [ & ] { EXPECT_EQ( Status::ERR_OK, sched.read( Priority::REALTIME, 0, readData.data(), readData.size() ) ); } );
+
+  writer.join();
+  reader.join();
+
+  /*-------------------------------------------------
+  The read couldn't get ahead of a write that already
+  held the only slot, so it sees all of it.
+  -------------------------------------------------*/
+  EXPECT_EQ( 0, memcmp( readData.data(), data.data(), readData.size() ) );
+  EXPECT_EQ( Access::READ, device.log().back().type );
+  EXPECT_EQ( 0u, sched.pending() );
+}
+
+/*-------------------------------------------------
+Concurrency
+-------------------------------------------------*/
+TEST_F( RamBacked, Sched_ManyThreadsShareDevice )
+{
+  static constexpr size_t numThreads = 8;
+  static constexpr size_t span       = 4 * PAGE;
+
+  std::array<std::array<uint8_t, span>, numThreads> data;
+  std::array<std::array<uint8_t, span>, numThreads> readData;
+  std::vector<std::thread> threads;
+
+  Sched sched( device );
+
+  for ( size_t idx = 0; idx < numThreads; idx++ )
+  {
+    pattern( data[ idx ], static_cast<uint8_t>( idx ) );
+  }
+
+  /*-------------------------------------------------
+  More threads than queue slots, each writing and then
+  reading back its own range at its own priority
+  -------------------------------------------------*/
+  for ( size_t idx = 0; idx < numThreads; idx++ )
+  {
+    threads.emplace_back( [ &, idx ] {
+      const auto priority  = static_cast<Priority>( idx % static_cast<size_t>( Priority::NUM_OPTIONS ) );
+      const size_t address = idx * BLOCK;
+
+      for ( size_t pass = 0; pass < 4; pass++ )
+      {
+        EXPECT_EQ( Status::ERR_OK, sched.erase( priority, address, BLOCK ) );
+        EXPECT_EQ( Status::ERR_OK, sched.write( priority, address, data[ idx ].data(), span ) );
+        EXPECT_EQ( Status::ERR_OK, sched.read( priority, address, readData[ idx ].data(), span ) );
+      }
+    } );
+  }
+
+  for ( auto &thread : threads )
+  {
+    thread.join();
+  }
+
+  for ( size_t idx = 0; idx < numThreads; idx++ )
+  {
+    EXPECT_EQ( 0, memcmp( readData[ idx ].data(), data[ idx ].data(), span ) );
+  }
+
+  EXPECT_EQ( 1u, device.maxConcurrent() );
+  EXPECT_EQ( 0u, sched.pending() );
+}
@@ -0,0 +1,357 @@
+/********************************************************************************
+ *  File Name:
+ *    test_stripe.cpp
+ *
+ *  Description:
+ *    Tests the striped device adapter
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/* Adesto Includes */
+#include <Adesto/adapters/stripe.hpp>
+
+/* Test Includes */
+#include <gtest/gtest.h>
+#include "test_fixtures_adapters.hpp"
+
+using namespace Adesto::Adapter;
+
+static constexpr size_t PAGE   = RamDevice::PAGE_SIZE;
+static constexpr size_t BLOCK  = RamDevice::BLOCK_SIZE;
+static constexpr size_t SECTOR = RamDevice::SECTOR_SIZE;
+
+/**
+ *  Provides identical RAM backed devices to stripe over, with a shared
+ *  record of which device each call went to
+ */
+template<size_t N>
+class RamStripe
+{
+public:
+  static constexpr size_t DEVICE_SIZE = 4 * SECTOR;
+
+  std::array<RamDevice, N> devices;
+
+  RamStripe() : devices( make( std::make_index_sequence<N>() ) )
+  {
+    for ( size_t idx = 0; idx < N; idx++ )
+    {
+      devices[ idx ].onAccess( [ this, idx ]( const DeviceAccess &access ) {
+        std::lock_guard<std::mutex> guard( mLock );
+        mOrder.push_back( idx );
+      } );
+    }
+  }
+
+  typename Stripe<N, PAGE>::DeviceList list()
+  {
+    typename Stripe<N, PAGE>::DeviceList result;
+    for ( size_t idx = 0; idx < N; idx++ )
+    {
+      result[ idx ] = &devices[ idx ];
+    }
+
+    return result;
+  }
+
+  /**
+   *  Gets the device index of every call made so far, in order
+   */
+  std::vector<size_t> order()
+  {
+    std::lock_guard<std::mutex> guard( mLock );
+    return mOrder;
+  }
+
+private:
+  std::mutex mLock;
+  std::vector<size_t> mOrder;
+
+  template<size_t... I>
+  static std::array<RamDevice, N> make( std::index_sequence<I...> )
+  {
+    return { { ( static_cast<void>( I ), RamDevice( DEVICE_SIZE ) )... } };
+  }
+};
+
+/*-------------------------------------------------
+Address Mapping
+-------------------------------------------------*/
+TEST( Stripe, Stripe_AddressMapping )
+{
+  using Three = Stripe<3, PAGE>;
+
+  EXPECT_EQ( 0u, Three::deviceOf( 0 ) );
+  EXPECT_EQ( 0u, Three::deviceOf( PAGE - 1 ) );
+  EXPECT_EQ( 1u, Three::deviceOf( PAGE ) );
+  EXPECT_EQ( 2u, Three::deviceOf( ( 2 * PAGE ) + 10 ) );
+  EXPECT_EQ( 0u, Three::deviceOf( 3 * PAGE ) );
+
+  EXPECT_EQ( 10u, Three::deviceAddress( 10 ) );
+  EXPECT_EQ( 10u, Three::deviceAddress( PAGE + 10 ) );
+  EXPECT_EQ( 10u, Three::deviceAddress( ( 2 * PAGE ) + 10 ) );
+  EXPECT_EQ( PAGE + 10, Three::deviceAddress( ( 3 * PAGE ) + 10 ) );
+  EXPECT_EQ( ( 2 * PAGE ) + 10, Three::deviceAddress( ( 7 * PAGE ) + 10 ) );
+}
+
+/*-------------------------------------------------
+Geometry
+-------------------------------------------------*/
+TEST( Stripe, Stripe_PropertiesScaleWithDevices )
+{
+  RamStripe<2> ram;
+  Stripe<2, PAGE> stripe( ram.list() );
+
+  ASSERT_EQ( Status::ERR_OK, stripe.open() );
+
+  const auto props = stripe.getDeviceProperties();
+  EXPECT_EQ( PAGE, props.pageSize );
+  EXPECT_EQ( 2 * BLOCK, props.blockSize );
+  EXPECT_EQ( 2 * SECTOR, props.sectorSize );
+  EXPECT_EQ( 0u, props.startAddress );
+  EXPECT_EQ( 2 * RamStripe<2>::DEVICE_SIZE, props.endAddress );
+  EXPECT_EQ( RamStripe<2>::DEVICE_SIZE / BLOCK, props.numBlocks );
+  EXPECT_EQ( ( 2 * RamStripe<2>::DEVICE_SIZE ) / PAGE, props.numPages );
+}
+
+TEST( Stripe, Stripe_WideStripesSetBlockSize )
+{
+  static constexpr size_t wide = 2 * BLOCK;
+
+  RamDevice first( 4 * SECTOR );
+  RamDevice second( 4 * SECTOR );
+  Stripe<2, wide> stripe( { &first, &second } );
+
+  ASSERT_EQ( Status::ERR_OK, stripe.open() );
+
+  const auto props = stripe.getDeviceProperties();
+  EXPECT_EQ( PAGE, props.pageSize );
+  EXPECT_EQ( 2 * wide, props.blockSize );
+  EXPECT_EQ( 2 * SECTOR, props.sectorSize );
+}
+
+TEST( Stripe, Stripe_MismatchedDevicesRejected )
+{
+  RamDevice first( 4 * SECTOR );
+  RamDevice smaller( 2 * SECTOR );
+  RamDevice noBlocks( 4 * SECTOR, 0 );
+
+  EXPECT_EQ( Status::ERR_UNSUPPORTED, ( Stripe<2, PAGE>( { &first, &smaller } ).open() ) );
+  EXPECT_EQ( Status::ERR_UNSUPPORTED, ( Stripe<2, PAGE>( { &first, &noBlocks } ).open() ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, ( Stripe<2, PAGE>( { &first, nullptr } ).open() ) );
+}
+
+TEST( Stripe, Stripe_ClosedStripeRejectsAccess )
+{
+  uint8_t value = 0;
+  RamStripe<2> ram;
+  Stripe<2, PAGE> stripe( ram.list() );
+
+  EXPECT_EQ( Status::ERR_BAD_ARG, stripe.read( 0, &value, 1 ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, stripe.write( 0, &value, 1 ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, stripe.erase( 0, 2 * BLOCK ) );
+  EXPECT_TRUE( ram.order().empty() );
+}
+
+/*-------------------------------------------------
+Data Routing
+-------------------------------------------------*/
+TEST( Stripe, Stripe_WriteVisitsDevicesInTurn )
+{
+  std::array<uint8_t, 4 * PAGE> data;
+  RamStripe<3> ram;
+  Stripe<3, PAGE> stripe( ram.list() );
+
+  ASSERT_EQ( Status::ERR_OK, stripe.open() );
+  for ( size_t x = 0; x < data.size(); x++ )
+  {
+    data[ x ] = static_cast<uint8_t>( ( x * 7 ) + ( x >> 8 ) );
+  }
+
+  ASSERT_EQ( Status::ERR_OK, stripe.write( 0, data.data(), data.size() ) );
+
+  /*-------------------------------------------------
+  One stripe per device in turn, then every device that
+  took a stripe is waited on exactly once.
+  -------------------------------------------------*/
+  const std::vector<size_t> expected = { 0, 1, 2, 0, 0, 1, 2 };
+  EXPECT_EQ( expected, ram.order() );
+
+  EXPECT_EQ( 0, memcmp( ram.devices[ 0 ].memory(), data.data(), PAGE ) );
+  EXPECT_EQ( 0, memcmp( ram.devices[ 1 ].memory(), data.data() + PAGE, PAGE ) );
+  EXPECT_EQ( 0, memcmp( ram.devices[ 2 ].memory(), data.data() + ( 2 * PAGE ), PAGE ) );
+  EXPECT_EQ( 0, memcmp( ram.devices[ 0 ].memory() + PAGE, data.data() + ( 3 * PAGE ), PAGE ) );
+
+  for ( auto &device : ram.devices )
+  {
+    EXPECT_EQ( 1u, device.count( Access::PEND ) );
+  }
+}
+
+TEST( Stripe, Stripe_UnalignedReadSplitsAtStripes )
+{
+  std::array<uint8_t, 600> readData;
+  RamStripe<2> ram;
+  Stripe<2, PAGE> stripe( ram.list() );
+
+  ASSERT_EQ( Status::ERR_OK, stripe.open() );
+  memset( ram.devices[ 0 ].memory(), 0xA0, RamStripe<2>::DEVICE_SIZE );
+  memset( ram.devices[ 1 ].memory(), 0xB1, RamStripe<2>::DEVICE_SIZE );
+
+  ASSERT_EQ( Status::ERR_OK, stripe.read( 100, readData.data(), readData.size() ) );
+
+  const auto first  = ram.devices[ 0 ].log();
+  const auto second = ram.devices[ 1 ].log();
+  ASSERT_EQ( 2u, first.size() );
+  ASSERT_EQ( 1u, second.size() );
+
+  EXPECT_EQ( 100u, first[ 0 ].address );
+  EXPECT_EQ( PAGE - 100, first[ 0 ].length );
+  EXPECT_EQ( 0u, second[ 0 ].address );
+  EXPECT_EQ( PAGE, second[ 0 ].length );
+  EXPECT_EQ( PAGE, first[ 1 ].address );
+  EXPECT_EQ( 700 - ( 2 * PAGE ), first[ 1 ].length );
+
+  EXPECT_EQ( 0xA0, readData[ 0 ] );
+  EXPECT_EQ( 0xB1, readData[ PAGE - 100 ] );
+  EXPECT_EQ( 0xA0, readData[ ( 2 * PAGE ) - 100 ] );
+  EXPECT_EQ( 0u, ram.devices[ 0 ].count( Access::PEND ) );
+}
+
+TEST( Stripe, Stripe_WriteReadRoundTrip )
+{
+  std::array<uint8_t, ( 5 * PAGE ) + 33> data;
+  std::array<uint8_t, data.size()> readData;
+  RamStripe<3> ram;
+  Stripe<3, PAGE> stripe( ram.list() );
+
+  ASSERT_EQ( Status::ERR_OK, stripe.open() );
+  for ( size_t x = 0; x < data.size(); x++ )
+  {
+    data[ x ] = static_cast<uint8_t>( ( x * 13 ) + ( x >> 8 ) );
+  }
+
+  ASSERT_EQ( Status::ERR_OK, stripe.write( 1000, data.data(), data.size() ) );
+  ASSERT_EQ( Status::ERR_OK, stripe.read( 1000, readData.data(), readData.size() ) );
+  EXPECT_EQ( 0, memcmp( readData.data(), data.data(), data.size() ) );
+
+  for ( size_t x = 0; x < data.size(); x++ )
+  {
+    const size_t addr = 1000 + x;
+    ASSERT_EQ( data[ x ], ram.devices[ stripe.deviceOf( addr ) ].memory()[ stripe.deviceAddress( addr ) ] );
+  }
+}
+
+TEST( Stripe, Stripe_FailedWriteStopsAndSettles )
+{
+  std::array<uint8_t, 4 * PAGE> data;
+  RamStripe<2> ram;
+  Stripe<2, PAGE> stripe( ram.list() );
+
+  ASSERT_EQ( Status::ERR_OK, stripe.open() );
+  data.fill( 0x00 );
+
+  /*-------------------------------------------------
+  Only the device that accepted its stripe is waited on
+  -------------------------------------------------*/
+  ram.devices[ 1 ].failWith( Access::WRITE, Status::ERR_DRIVER_ERR );
+  EXPECT_EQ( Status::ERR_DRIVER_ERR, stripe.write( 0, data.data(), data.size() ) );
+
+  EXPECT_EQ( 1u, ram.devices[ 0 ].count( Access::WRITE ) );
+  EXPECT_EQ( 1u, ram.devices[ 0 ].count( Access::PEND ) );
+  EXPECT_EQ( 0u, ram.devices[ 1 ].count( Access::PEND ) );
+}
+
+/*-------------------------------------------------
+Erasing
+-------------------------------------------------*/
+TEST( Stripe, Stripe_EraseSplitsAcrossDevices )
+{
+  RamStripe<2> ram;
+  Stripe<2, PAGE> stripe( ram.list() );
+
+  ASSERT_EQ( Status::ERR_OK, stripe.open() );
+  for ( auto &device : ram.devices )
+  {
+    memset( device.memory(), 0, RamStripe<2>::DEVICE_SIZE );
+  }
+
+  const size_t blockSize = stripe.getDeviceProperties().blockSize;
+  ASSERT_EQ( Status::ERR_OK, stripe.erase( blockSize, 3 * blockSize ) );
+
+  /*-------------------------------------------------
+  Each device erases its share as one range, then all of
+  them are waited on.
+  -------------------------------------------------*/
+  const std::vector<size_t> expected = { 0, 1, 0, 1 };
+  EXPECT_EQ( expected, ram.order() );
+
+  for ( auto &device : ram.devices )
+  {
+    const auto log = device.log();
+    ASSERT_EQ( 2u, log.size() );
+    EXPECT_EQ( Access::ERASE, log[ 0 ].type );
+    EXPECT_EQ( BLOCK, log[ 0 ].address );
+    EXPECT_EQ( 3 * BLOCK, log[ 0 ].length );
+
+    EXPECT_EQ( 0x00, device.memory()[ BLOCK - 1 ] );
+    EXPECT_EQ( 0xFF, device.memory()[ BLOCK ] );
+    EXPECT_EQ( 0xFF, device.memory()[ ( 4 * BLOCK ) - 1 ] );
+    EXPECT_EQ( 0x00, device.memory()[ 4 * BLOCK ] );
+  }
+}
+
+TEST( Stripe, Stripe_EraseNeedsWholeBlocks )
+{
+  RamStripe<2> ram;
+  Stripe<2, PAGE> stripe( ram.list() );
+
+  ASSERT_EQ( Status::ERR_OK, stripe.open() );
+
+  EXPECT_EQ( Status::ERR_BAD_ARG, stripe.erase( BLOCK, 2 * BLOCK ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, stripe.erase( 0, BLOCK ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, stripe.erase( 0, 0 ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, stripe.erase( 0, 4 * RamStripe<2>::DEVICE_SIZE ) );
+  EXPECT_TRUE( ram.order().empty() );
+}
+
+TEST( Stripe, Stripe_ChunkEraseUsesStripedGeometry )
+{
+  RamStripe<2> ram;
+  Stripe<2, PAGE> stripe( ram.list() );
+
+  ASSERT_EQ( Status::ERR_OK, stripe.open() );
+
+  ASSERT_EQ( Status::ERR_OK, stripe.erase( Aurora::Memory::Chunk::SECTOR, 1 ) );
+  for ( auto &device : ram.devices )
+  {
+    ASSERT_EQ( 1u, device.count( Access::ERASE ) );
+    EXPECT_EQ( SECTOR, device.log()[ 0 ].address );
+    EXPECT_EQ( SECTOR, device.log()[ 0 ].length );
+  }
+
+  EXPECT_EQ( Status::ERR_BAD_ARG, stripe.erase( Aurora::Memory::Chunk::PAGE, 0 ) );
+}
+
+TEST( Stripe, Stripe_EraseChipReachesEveryDevice )
+{
+  RamStripe<3> ram;
+  Stripe<3, PAGE> stripe( ram.list() );
+
+  ASSERT_EQ( Status::ERR_OK, stripe.open() );
+  ASSERT_EQ( Status::ERR_OK, stripe.eraseChip() );
+
+  for ( auto &device : ram.devices )
+  {
+    EXPECT_EQ( 1u, device.count( Access::ERASE_CHIP ) );
+    EXPECT_EQ( 1u, device.count( Access::PEND ) );
+  }
+}
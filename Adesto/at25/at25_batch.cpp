@@ -0,0 +1,146 @@
+/********************************************************************************
+ *  File Name:
+ *    at25_batch.cpp
+ *
+ *  Description:
+ *    Batched operation sessions for the AT25 driver
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* Adesto Includes */
+#include <Adesto/at25/at25_batch.hpp>
+#include <Adesto/at25/at25_driver.hpp>
+
+namespace Adesto::AT25
+{
+  /*-------------------------------------------------------------------------------
+  Batch Implementation
+  -------------------------------------------------------------------------------*/
+  Batch::Batch( Driver &driver ) : mDriver( &driver ), mOpen( true ), mCount( 0 )
+  {
+  }
+
+
+  Batch::~Batch()
+  {
+  }
+
+
+  Aurora::Memory::Status Batch::read( const size_t address, void *const data, const size_t length )
+  {
+    if ( !data || !length )
+    {
+      return Aurora::Memory::Status::ERR_BAD_ARG;
+    }
+
+    return enqueue( { OpType::READ, address, nullptr, data, length } );
+  }
+
+
+  Aurora::Memory::Status Batch::write( const size_t address, const void *const data, const size_t length )
+  {
+    if ( !data || !length )
+    {
+      return Aurora::Memory::Status::ERR_BAD_ARG;
+    }
+
+    return enqueue( { OpType::WRITE, address, data, nullptr, length } );
+  }
+
+
+  Aurora::Memory::Status Batch::erase( const size_t address, const size_t length )
+  {
+    if ( !length )
+    {
+      return Aurora::Memory::Status::ERR_BAD_ARG;
+    }
+
+    return enqueue( { OpType::ERASE, address, nullptr, nullptr, length } );
+  }
+
+
+  Aurora::Memory::Status Batch::wait( const size_t timeout )
+  {
+    return enqueue( { OpType::WAIT, 0, nullptr, nullptr, timeout } );
+  }
+
+
+  Aurora::Memory::Status Batch::commit()
+  {
+    if ( !mOpen )
+    {
+      return Aurora::Memory::Status::ERR_UNSUPPORTED;
+    }
+
+    /*-------------------------------------------------
+    Take both locks for the whole session and keep the
+    bus through any waits, then run each operation back
+    to back using the unlocked implementations.
+    -------------------------------------------------*/
+    mDriver->lock();
+    mDriver->mSPI->lock();
+    mDriver->mHoldBus = true;
+
+    auto result = Aurora::Memory::Status::ERR_OK;
+
+    for ( size_t idx = 0; idx < mCount; idx++ )
+    {
+      const Op &op = mOps[ idx ];
+
+      switch ( op.type )
+      {
+        case OpType::READ:
+          result = mDriver->performRead( op.address, op.rxData, op.length );
+          break;
+
+        case OpType::WRITE:
+          result = mDriver->performWrite( op.address, op.txData, op.length );
+          break;
+
+        case OpType::ERASE:
+          result = mDriver->performErase( op.address, op.length );
+          break;
+
+        case OpType::WAIT:
+          result = mDriver->mJob.active ? mDriver->awaitJob( op.length ) : mDriver->awaitIdle( op.length );
+          break;
+
+        default:
+          result = Aurora::Memory::Status::ERR_UNSUPPORTED;
+          break;
+      };
+
+      if ( result != Aurora::Memory::Status::ERR_OK )
+      {
+        break;
+      }
+    }
+
+    mDriver->mHoldBus = false;
+    mDriver->mSPI->unlock();
+    mDriver->unlock();
+
+    mOpen  = false;
+    mCount = 0;
+    return result;
+  }
+
+
+  size_t Batch::size() const
+  {
+    return mCount;
+  }
+
+
+  Aurora::Memory::Status Batch::enqueue( const Op &op )
+  {
+    if ( !mOpen || ( mCount >= mOps.size() ) )
+    {
+      return Aurora::Memory::Status::ERR_UNSUPPORTED;
+    }
+
+    mOps[ mCount++ ] = op;
+    return Aurora::Memory::Status::ERR_OK;
+  }
+}  // namespace Adesto::AT25
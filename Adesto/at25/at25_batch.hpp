@@ -0,0 +1,133 @@
+/********************************************************************************
+ *  File Name:
+ *    at25_batch.hpp
+ *
+ *  Description:
+ *    Batched operation sessions for the AT25 driver
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+#pragma once
+#ifndef ADESTO_AT25_BATCH_HPP
+#define ADESTO_AT25_BATCH_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+
+/* Aurora Includes */
+#include <Aurora/memory>
+
+/* Adesto Includes */
+#include <Adesto/at25/at25_constants.hpp>
+#include <Adesto/at25/at25_types.hpp>
+
+namespace Adesto::AT25
+{
+  /**
+   *  A sequence of operations that runs against a driver while holding
+   *  the driver and SPI locks exactly once. Operations are only queued
+   *  when added, without taking any locks. Nothing touches the bus until
+   *  commit() is called, which acquires both locks, executes the queue
+   *  back-to-back in order and only then releases them. The SPI bus is
+   *  not handed to other users while waiting on the device in between.
+   *
+   *  Buffers handed to the batch must stay valid until commit() returns.
+   *  A batch can only be committed once.
+   */
+  class Batch
+  {
+  public:
+    ~Batch();
+
+    Batch( const Batch & ) = delete;
+    Batch( Batch && )      = delete;
+    Batch &operator=( const Batch & ) = delete;
+    Batch &operator=( Batch && ) = delete;
+
+    /**
+     *  Queues a read of any length from the device
+     *
+     *  @param[in]  address     Address to start reading from
+     *  @param[out] data        Where to place the data
+     *  @param[in]  length      Number of bytes to read
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status read( const size_t address, void *const data, const size_t length );
+
+    /**
+     *  Queues a program of any length and alignment
+     *
+     *  @param[in]  address     Address to start writing at
+     *  @param[in]  data        Data to be written
+     *  @param[in]  length      Number of bytes to write
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status write( const size_t address, const void *const data, const size_t length );
+
+    /**
+     *  Queues an erase of a range aligned to the smallest erase chunk
+     *
+     *  @param[in]  address     Address to start erasing at
+     *  @param[in]  length      Number of bytes to erase
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status erase( const size_t address, const size_t length );
+
+    /**
+     *  Queues a wait for the device to finish whatever it is busy with
+     *
+     *  @param[in]  timeout     How long to wait in milliseconds
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status wait( const size_t timeout );
+
+    /**
+     *  Locks the driver and SPI bus, runs all queued operations in order and
+     *  releases the locks again. Execution stops at the first operation that
+     *  fails.
+     *
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status commit();
+
+    /**
+     *  Gets the number of operations currently queued
+     *
+     *  @return size_t
+     */
+    size_t size() const;
+
+  private:
+    friend class Driver;
+
+    enum class OpType : uint8_t
+    {
+      READ,
+      WRITE,
+      ERASE,
+      WAIT
+    };
+
+    struct Op
+    {
+      OpType type;
+      size_t address;
+      const void *txData;
+      void *rxData;
+      size_t length;
+    };
+
+    Driver *mDriver;                    /**< Driver the batch executes against */
+    bool mOpen;                         /**< Whether operations may still be queued */
+    size_t mCount;                      /**< Number of queued operations */
+    std::array<Op, BATCH_MAX_OPS> mOps; /**< Queued operations */
+
+    Batch( Driver &driver );
+
+    Aurora::Memory::Status enqueue( const Op &op );
+  };
+}  // namespace Adesto::AT25
+
+#endif /* !ADESTO_AT25_BATCH_HPP */
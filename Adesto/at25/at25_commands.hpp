@@ -58,6 +58,18 @@ namespace Adesto::AT25::Command
   static constexpr uint8_t CHIP_ERASE_OPS_LEN = 1;
 
 
+  /*-------------------------------------------------------------------------------
+  Suspend Commands
+  -------------------------------------------------------------------------------*/
+  static constexpr uint8_t PROGRAM_ERASE_SUSPEND = 0x75;
+  static constexpr uint8_t PROGRAM_ERASE_SUSPEND_CMD_LEN = 1;
+  static constexpr uint8_t PROGRAM_ERASE_SUSPEND_OPS_LEN = 1;
+
+  static constexpr uint8_t PROGRAM_ERASE_RESUME = 0x7A;
+  static constexpr uint8_t PROGRAM_ERASE_RESUME_CMD_LEN = 1;
+  static constexpr uint8_t PROGRAM_ERASE_RESUME_OPS_LEN = 1;
+
+
   /*-------------------------------------------------------------------------------
   Protection Commands
   -------------------------------------------------------------------------------*/
@@ -97,6 +109,10 @@ namespace Adesto::AT25::Command
   static constexpr uint8_t READ_DEV_INFO_CMD_LEN = 1;
   static constexpr uint8_t READ_DEV_INFO_RSP_LEN = 3;
   static constexpr uint8_t READ_DEV_INFO_OPS_LEN = READ_DEV_INFO_CMD_LEN + READ_DEV_INFO_RSP_LEN;
+
+  static constexpr uint8_t READ_SFDP         = 0x5A;
+  static constexpr uint8_t READ_SFDP_CMD_LEN = 1;
+  static constexpr uint8_t READ_SFDP_OPS_LEN = 5; /**< CMD + 3 address bytes + 1 dummy byte */
 }  // namespace Adesto::AT25
 
 #endif  /* !ADESTO_AT25_COMMANDS_HPP */
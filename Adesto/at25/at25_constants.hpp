@@ -18,6 +18,8 @@
 
 /* Adesto Includes */
 #include <Adesto/common.hpp>
+#include <Adesto/at25/at25_commands.hpp>
+#include <Adesto/at25/at25_types.hpp>
 
 namespace Adesto::AT25
 {
@@ -34,21 +36,53 @@ namespace Adesto::AT25
   // There is also a 64k sector, but two 32kb sections can be erased if it's really a problem.
 
   /*-------------------------------------------------
-  List of device identifier codes as they would appear
-  shifted out in MSB mode.
+  Typical and worst case completion times for each of
+  the long running operations, in microseconds. See the
+  AC characteristics of the AT25SF081 datasheet. This
+  MUST be kept in the same order as the Operation enum.
   -------------------------------------------------*/
-  static const std::array<uint32_t, 1> SupportedDevices = {
-    0x001F8501,  // AT25SF081, 8Mb
-  };
+  static constexpr std::array<OperationTiming, static_cast<size_t>( Operation::NUM_OPTIONS )> OperationTimes = { {
+    { 0, 0 },                   /* NONE */
+    { 400, 5000 },              /* PAGE_PROGRAM: tPP */
+    { 60000, 300000 },          /* ERASE_4K: tBLKE */
+    { 350000, 1300000 },        /* ERASE_32K: tBLKE */
+    { 600000, 2000000 },        /* ERASE_64K: tBLKE */
+    { 12000000, 30000000 },     /* ERASE_CHIP: tCHPE */
+  } };
 
   /*-------------------------------------------------
-  Erase chunk sizing supported
+  Limits on how often the status register is polled
+  while waiting on an operation, in microseconds.
   -------------------------------------------------*/
-  static constexpr std::array<size_t, 3> EraseChunks = {
-    CHUNK_SIZE_4K,
-    CHUNK_SIZE_32K,
-    CHUNK_SIZE_64K
-  };
+  static constexpr size_t MIN_POLL_INTERVAL = 50;
+  static constexpr size_t MAX_POLL_DIVISOR  = 8; /**< Longest poll is this fraction of the max op time */
+
+  /*-------------------------------------------------
+  Sleeps at or above this many microseconds release the
+  SPI bus to other users, except inside a batch, and
+  use the millisecond delay.
+  -------------------------------------------------*/
+  static constexpr size_t BUS_RELEASE_THRESHOLD = 1000;
+
+  /*-------------------------------------------------
+  Time from a suspend command until the device accepts
+  reads (tSUS), and how long to keep checking before
+  giving up on the suspend, in microseconds.
+  -------------------------------------------------*/
+  static constexpr size_t SUSPEND_LATENCY = 20;
+  static constexpr size_t SUSPEND_TIMEOUT = 1000;
+
+  /*-------------------------------------------------
+  Size of the staging buffer used to gather a command
+  and its payload into one SPI transfer. Sized so that
+  a full page program always fits.
+  -------------------------------------------------*/
+  static constexpr size_t TRANSFER_BUFFER_SIZE = Command::MAX_CMD_LEN + PAGE_SIZE;
+
+  /*-------------------------------------------------
+  Max number of operations a single Batch may queue
+  -------------------------------------------------*/
+  static constexpr size_t BATCH_MAX_OPS = 16;
 
 }  // namespace Adesto::AT25
 
@@ -9,13 +9,17 @@
  *******************************************************************************/
 
 /* STL Includes */
+#include <algorithm>
 #include <array>
+#include <cstring>
 
 /* Adesto Includes */
 #include <Adesto/at25/at25_commands.hpp>
 #include <Adesto/at25/at25_constants.hpp>
 #include <Adesto/at25/at25_driver.hpp>
 #include <Adesto/at25/at25_register.hpp>
+#include <Adesto/at25/at25_sfdp.hpp>
+#include <Adesto/at25/at25_traits.hpp>
 #include <Adesto/at25/at25_types.hpp>
 
 /* Chimera Includes */
@@ -27,35 +31,60 @@ namespace Adesto::AT25
   /*-------------------------------------------------------------------------------
   Private Functions
   -------------------------------------------------------------------------------*/
-  static bool device_supported( const uint32_t devID )
+  static const Descriptor *find_device( const uint32_t devID )
   {
     uint32_t lsb_endian_id = 0;
     uint32_t msb_endian_id = 0;
 
-    for ( auto x = 0; x < SupportedDevices.size(); x++ )
+    for ( auto x = 0; x < Descriptors.size(); x++ )
     {
       /*-------------------------------------------------
       It's unknown which endianness the host device operates
       on, so compare against both possible options.
       -------------------------------------------------*/
-      msb_endian_id = SupportedDevices[ x ];
+      msb_endian_id = Descriptors[ x ].jedecID;
       lsb_endian_id = ( ( msb_endian_id & 0x00FF0000 ) >> 16 ) | ( ( msb_endian_id & 0x0000FF00 ) >> 0 )
                       | ( ( msb_endian_id & 0x000000FF ) << 16 );
 
       if ( ( msb_endian_id == devID ) || ( lsb_endian_id == devID ) )
       {
-        return true;
+        return &Descriptors[ x ];
       }
     }
 
-    return false;
+    return nullptr;
+  }
+
+
+  static size_t operation_timeout( const OperationTiming &timing )
+  {
+    /*-------------------------------------------------
+    Worst case completion time converted to milliseconds,
+    rounded up so short operations never get a zero timeout.
+    -------------------------------------------------*/
+    return ( timing.maximum / 1000 ) + 1;
   }
 
   /*-------------------------------------------------------------------------------
   Device Driver Implementation
   -------------------------------------------------------------------------------*/
-  Driver::Driver()
+  Driver::Driver() : Driver( nullptr )
+  {
+  }
+
+
+  Driver::Driver( const Device device ) :
+      Driver( ( device < Device::NUM_OPTIONS ) ? &Descriptors[ static_cast<size_t>( device ) ] : nullptr )
+  {
+  }
+
+
+  Driver::Driver( const Descriptor *const device ) :
+      mDevice( device ), mPinned( device != nullptr ), mPendingOp( Operation::NONE ), mOpStartTime( 0 ), mWB( {} ), mAsync( false ), mJob( {} ), mWriteNotify( {} ),
+      mEraseNotify( {} ), mHoldBus( false ), mSuspended( false ), mSuspendTime( 0 ), mSFDP( {} ), mDiscovered( {} )
   {
+    mWB.error = Aurora::Memory::Status::ERR_OK;
+    resetOperationStats();
   }
 
 
@@ -74,227 +103,59 @@ namespace Adesto::AT25
 
   Aurora::Memory::Status Driver::close()
   {
-    return Aurora::Memory::Status::ERR_OK;
+    return flush();
   }
 
 
   Aurora::Memory::Status Driver::write( const size_t address, const void *const data, const size_t length )
   {
     /*-------------------------------------------------
-    Input Protection: Writes greater than a page will
-    have hard to debug side-effects.
-    -------------------------------------------------*/
-    if ( !data || !length || ( length > PAGE_SIZE ) )
-    {
-      return Aurora::Memory::Status::ERR_BAD_ARG;
-    }
-
-    /*-------------------------------------------------
-    Acquire access to this driver
+    Acquire access to this driver and the SPI bus for
+    the entire duration of the write. This prevents lock
+    churn between pages and keeps other bus users from
+    interleaving with a multi-page operation.
     -------------------------------------------------*/
     this->lock();
-
-    /*-------------------------------------------------
-    Per datasheet specs, the write enable command must
-    be sent before issuing the actual data.
-    -------------------------------------------------*/
-    issueWriteEnable();
-
-    /*-------------------------------------------------
-    Initialize the command sequence
-    -------------------------------------------------*/
-    cmdBuffer[ 0 ] = Command::PAGE_PROGRAM;
-    cmdBuffer[ 1 ] = ( address & ADDRESS_BYTE_3_MSK ) >> ADDRESS_BYTE_3_POS;
-    cmdBuffer[ 2 ] = ( address & ADDRESS_BYTE_2_MSK ) >> ADDRESS_BYTE_2_POS;
-    cmdBuffer[ 3 ] = ( address & ADDRESS_BYTE_1_MSK ) >> ADDRESS_BYTE_1_POS;
-
-    /*-------------------------------------------------
-    Perform the SPI transaction
-    -------------------------------------------------*/
-    // Acquire the SPI and enable the memory chip
     mSPI->lock();
-    mSPI->setChipSelect( Chimera::GPIO::State::LOW );
 
-    // Tell the hardware which address to write into
-    mSPI->writeBytes( cmdBuffer.data(), Command::PAGE_PROGRAM_OPS_LEN );
-    mSPI->await( Chimera::Event::Trigger::TRIGGER_TRANSFER_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK );
+    auto result = performWrite( address, data, length );
 
-    // Dump the data
-    mSPI->writeBytes( data, length );
-    mSPI->await( Chimera::Event::Trigger::TRIGGER_TRANSFER_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK );
-
-    // Release the SPI and disable the memory chip
-    mSPI->setChipSelect( Chimera::GPIO::State::HIGH );
     mSPI->unlock();
-
-    /*-------------------------------------------------
-    Release access to this driver and exit
-    -------------------------------------------------*/
     this->unlock();
-    return Aurora::Memory::Status::ERR_OK;
+    return result;
   }
 
 
   Aurora::Memory::Status Driver::read( const size_t address, void *const data, const size_t length )
   {
     /*-------------------------------------------------
-    Input Protection
-    -------------------------------------------------*/
-    if ( !data || !length )
-    {
-      return Aurora::Memory::Status::ERR_BAD_ARG;
-    }
-
-    /*-------------------------------------------------
-    Acquire access to this driver
+    Acquire access to this driver and the SPI bus
     -------------------------------------------------*/
     this->lock();
-
-    /*-------------------------------------------------
-    Initialize the command sequence. The high speed
-    command works for all frequency ranges.
-    -------------------------------------------------*/
-    cmdBuffer[ 0 ] = Command::READ_ARRAY_HS;
-    cmdBuffer[ 1 ] = ( address & ADDRESS_BYTE_3_MSK ) >> ADDRESS_BYTE_3_POS;
-    cmdBuffer[ 2 ] = ( address & ADDRESS_BYTE_2_MSK ) >> ADDRESS_BYTE_2_POS;
-    cmdBuffer[ 3 ] = ( address & ADDRESS_BYTE_1_MSK ) >> ADDRESS_BYTE_1_POS;
-    cmdBuffer[ 4 ] = 0;  // Dummy byte
-
-    /*-------------------------------------------------
-    Perform the SPI transaction
-    -------------------------------------------------*/
     mSPI->lock();
-    mSPI->setChipSelect( Chimera::GPIO::State::LOW );
-
-    // Tell the hardware which address to read from
-    mSPI->writeBytes( cmdBuffer.data(), Command::READ_ARRAY_HS_OPS_LEN );
-    mSPI->await( Chimera::Event::Trigger::TRIGGER_TRANSFER_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK );
 
-    // Pull out all the data
-    mSPI->readBytes( data, length );
-    mSPI->await( Chimera::Event::Trigger::TRIGGER_TRANSFER_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK );
+    auto result = performRead( address, data, length );
 
-    mSPI->setChipSelect( Chimera::GPIO::State::HIGH );
     mSPI->unlock();
-
-    /*-------------------------------------------------
-    Release access to this driver and exit
-    -------------------------------------------------*/
     this->unlock();
-    return Aurora::Memory::Status::ERR_OK;
+    return result;
   }
 
 
   Aurora::Memory::Status Driver::erase( const size_t address, const size_t length )
   {
     /*-------------------------------------------------
-    Input Protection: Length Validity
-    -------------------------------------------------*/
-    bool validSize = false;
-    for ( auto idx = 0; idx < EraseChunks.size(); idx++ )
-    {
-      if ( length == EraseChunks[ idx ] )
-      {
-        validSize = true;
-        break;
-      }
-    }
-
-    if ( !validSize || !length )
-    {
-      return Aurora::Memory::Status::ERR_BAD_ARG;
-    }
-
-    /*-------------------------------------------------
-    Input Protection: Address Alignment
-    -------------------------------------------------*/
-    if ( ( address % length ) != 0 )
-    {
-      return Aurora::Memory::Status::ERR_BAD_ARG;
-    }
-
-    /*-------------------------------------------------
-    Acquire access to this driver
+    Acquire access to this driver and the SPI bus for
+    the entire erase sequence.
     -------------------------------------------------*/
     this->lock();
+    mSPI->lock();
 
-    /*-------------------------------------------------
-    Per datasheet specs, the write enable command must
-    be sent before issuing the actual data.
-    -------------------------------------------------*/
-    issueWriteEnable();
-
-    /*-------------------------------------------------
-    Determine the op-code to use based on the requested
-    chunk size to erase.
-    -------------------------------------------------*/
-    size_t eraseOpsLen = Command::BLOCK_ERASE_OPS_LEN;
-    switch ( length )
-    {
-      case CHUNK_SIZE_4K:
-        cmdBuffer[ 0 ] = Command::BLOCK_ERASE_4K;
-        break;
-
-      case CHUNK_SIZE_32K:
-        cmdBuffer[ 0 ] = Command::BLOCK_ERASE_32K;
-        break;
-
-      case CHUNK_SIZE_64K:
-        cmdBuffer[ 0 ] = Command::BLOCK_ERASE_64K;
-        break;
-
-      default:
-        /*-------------------------------------------------
-        Whole chip erase?
-        -------------------------------------------------*/
-        if ( length == densityToBytes( mInfo.density ) )
-        {
-          cmdBuffer[ 0 ] = Command::CHIP_ERASE;
-          eraseOpsLen    = Command::CHIP_ERASE_OPS_LEN;
-          break;
-        }
-
-        /*-------------------------------------------------
-        Should never get here...
-        -------------------------------------------------*/
-        Chimera::insert_debug_breakpoint();
-        this->unlock();
-        return Aurora::Memory::Status::ERR_UNSUPPORTED;
-        break;
-    }
-
-    /*-------------------------------------------------
-    Initialize the command sequence. If whole chip
-    erase command, these bytes will be ignored anyways.
-    -------------------------------------------------*/
-    cmdBuffer[ 1 ] = ( address & ADDRESS_BYTE_3_MSK ) >> ADDRESS_BYTE_3_POS;
-    cmdBuffer[ 2 ] = ( address & ADDRESS_BYTE_2_MSK ) >> ADDRESS_BYTE_2_POS;
-    cmdBuffer[ 3 ] = ( address & ADDRESS_BYTE_1_MSK ) >> ADDRESS_BYTE_1_POS;
-
-    /*-------------------------------------------------
-    Perform the SPI transaction
-    -------------------------------------------------*/
-    auto spiResult = Chimera::Status::OK;
+    auto result = performErase( address, length );
 
-    mSPI->lock();
-    spiResult |= mSPI->setChipSelect( Chimera::GPIO::State::LOW );
-    spiResult |= mSPI->readWriteBytes( cmdBuffer.data(), cmdBuffer.data(), eraseOpsLen );
-    spiResult |= mSPI->await( Chimera::Event::Trigger::TRIGGER_TRANSFER_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK );
-    spiResult |= mSPI->setChipSelect( Chimera::GPIO::State::HIGH );
     mSPI->unlock();
-
-    /*-------------------------------------------------
-    Release access to this driver
-    -------------------------------------------------*/
     this->unlock();
-    if ( spiResult == Chimera::Status::OK )
-    {
-      return Aurora::Memory::Status::ERR_OK;
-    }
-    else
-    {
-      return Aurora::Memory::Status::ERR_DRIVER_ERR;
-    }
+    return result;
   }
 
 
@@ -303,37 +164,13 @@ namespace Adesto::AT25
     /*-------------------------------------------------
     Get the size allocated to the chunk type
     -------------------------------------------------*/
-    size_t chunkSize = 0;
-    size_t maxIndex  = 0;
-
-    auto props = getDeviceProperties();
-
-    switch ( chunk )
-    {
-      case Aurora::Memory::Chunk::PAGE:
-        chunkSize = PAGE_SIZE;
-        maxIndex  = props.numPages;
-        break;
-
-      case Aurora::Memory::Chunk::BLOCK:
-        chunkSize = BLOCK_SIZE;
-        maxIndex  = props.numBlocks;
-        break;
-
-      case Aurora::Memory::Chunk::SECTOR:
-        chunkSize = SECTOR_SIZE;
-        maxIndex  = props.numSectors;
-        break;
-
-      default:
-        return Aurora::Memory::Status::ERR_BAD_ARG;
-        break;
-    };
+    const size_t chunkSize  = chunkSizeOf( chunk );
+    const size_t deviceSize = mDevice ? mDevice->size : 0;
 
     /*-------------------------------------------------
     Is this even a valid index for the selected chunk?
     -------------------------------------------------*/
-    if ( id >= maxIndex )
+    if ( !chunkSize || ( id >= ( deviceSize / chunkSize ) ) )
     {
       return Aurora::Memory::Status::ERR_BAD_ARG;
     }
@@ -349,10 +186,11 @@ namespace Adesto::AT25
   Aurora::Memory::Status Driver::eraseChip()
   {
     /*-------------------------------------------------
-    Per datasheet specs, the write enable command must
-    be sent before issuing the actual data.
+    Acquire access to this driver. Any buffered writes
+    are about to be wiped out, so just drop them.
     -------------------------------------------------*/
-    issueWriteEnable();
+    this->lock();
+    mWB.dirty = false;
 
     /*-------------------------------------------------
     Perform the SPI transaction
@@ -360,15 +198,35 @@ namespace Adesto::AT25
     auto spiResult = Chimera::Status::OK;
 
     mSPI->lock();
-    spiResult |= mSPI->setChipSelect( Chimera::GPIO::State::LOW );
-    spiResult |= mSPI->writeBytes( &Command::CHIP_ERASE, Command::CHIP_ERASE_OPS_LEN );
-    spiResult |= mSPI->await( Chimera::Event::Trigger::TRIGGER_TRANSFER_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK );
-    spiResult |= mSPI->setChipSelect( Chimera::GPIO::State::HIGH );
+    awaitJob( Chimera::Threading::TIMEOUT_BLOCK );
+
+    /*-------------------------------------------------
+    Per datasheet specs, the write enable command must
+    be sent before issuing the actual data.
+    -------------------------------------------------*/
+    issueWriteEnable();
+
+    const Segment segment = { &Command::CHIP_ERASE, nullptr, Command::CHIP_ERASE_OPS_LEN };
+    spiResult |= transfer( &segment, 1 );
     mSPI->unlock();
 
+    startOperation( Operation::ERASE_CHIP );
+
+    /*-------------------------------------------------
+    The chip erase is a single command, so the job only
+    exists to have process() report the completion.
+    -------------------------------------------------*/
+    if ( mAsync && ( spiResult == Chimera::Status::OK ) )
+    {
+      const size_t deviceSize = mDevice ? mDevice->size : 0;
+      mJob = { true, Aurora::Memory::Event::MEM_ERASE_COMPLETE, nullptr, deviceSize, 0, deviceSize, 0, deviceSize,
+               Aurora::Memory::Status::ERR_OK };
+    }
+
     /*-------------------------------------------------
     Release access to this driver
     -------------------------------------------------*/
+    this->unlock();
     if ( spiResult == Chimera::Status::OK )
     {
       return Aurora::Memory::Status::ERR_OK;
@@ -382,24 +240,41 @@ namespace Adesto::AT25
 
   Aurora::Memory::Status Driver::flush()
   {
-    return Aurora::Memory::Status::ERR_OK;
+    this->lock();
+    mSPI->lock();
+
+    auto result = awaitJob( Chimera::Threading::TIMEOUT_BLOCK );
+    if ( result == Aurora::Memory::Status::ERR_OK )
+    {
+      result = flushWriteBack();
+    }
+
+    /*-------------------------------------------------
+    Report a timed flush that failed in the background,
+    even if the data made it out this time.
+    -------------------------------------------------*/
+    if ( result == Aurora::Memory::Status::ERR_OK )
+    {
+      result = mWB.error;
+    }
+
+    mWB.error = Aurora::Memory::Status::ERR_OK;
+    mSPI->unlock();
+    this->unlock();
+    return result;
   }
 
+
   Aurora::Memory::Status Driver::pendEvent( const Aurora::Memory::Event event, const size_t timeout )
   {
     /*-------------------------------------------------
-    Decide the bits used to indicate events occurred.
+    Input Protection
     -------------------------------------------------*/
-    uint16_t eventBitMask = 0;  // Indicates bits to look at
-    size_t pollDelay      = 0;  // How long to wait between checks
-
     switch( event )
     {
       case Aurora::Memory::Event::MEM_ERASE_COMPLETE:
       case Aurora::Memory::Event::MEM_READ_COMPLETE:
       case Aurora::Memory::Event::MEM_WRITE_COMPLETE:
-        eventBitMask = Register::SR_RDY_BUSY;
-        pollDelay    = Chimera::Threading::TIMEOUT_5MS;
         break;
 
       default:
@@ -412,40 +287,48 @@ namespace Adesto::AT25
     RDY/BSY flag is set. Assuming this extends to other
     AT25 devices as well.
 
-    See Table 10-1 of device datasheet.
+    See Table 10-1 of device datasheet. A background job
+    may need several more commands before it is done.
     -------------------------------------------------*/
-    uint16_t statusRegister = readStatusRegister();
-    const size_t startTime  = Chimera::millis();
-
-    while ( statusRegister & eventBitMask )
-    {
-      /*-------------------------------------------------
-      Check for timeout, otherwise suspend this thread
-      and allow others to do something.
-      -------------------------------------------------*/
-      if( ( Chimera::millis() - startTime ) > timeout )
-      {
-        return Aurora::Memory::Status::ERR_TIMEOUT;
-        break;
-      }
-      else
-      {
-        Chimera::delayMilliseconds( pollDelay );
-      }
+    this->lock();
+    mSPI->lock();
 
-      /*-------------------------------------------------
-      Poll the latest info
-      -------------------------------------------------*/
-      statusRegister = readStatusRegister();
-    };
+    auto result = mJob.active ? awaitJob( timeout ) : awaitIdle( timeout );
 
-    return Aurora::Memory::Status::ERR_OK;
+    mSPI->unlock();
+    this->unlock();
+    return result;
   }
 
 
   Aurora::Memory::Status Driver::onEvent( const Aurora::Memory::Event event, void ( *func )( const size_t ) )
   {
-    return Aurora::Memory::Status::ERR_UNSUPPORTED;
+    /*-------------------------------------------------
+    Reads always complete before returning, so there is
+    nothing to report for them. A null function removes
+    the callback.
+    -------------------------------------------------*/
+    auto result = Aurora::Memory::Status::ERR_OK;
+
+    this->lock();
+
+    switch ( event )
+    {
+      case Aurora::Memory::Event::MEM_WRITE_COMPLETE:
+        mWriteNotify.callback = func;
+        break;
+
+      case Aurora::Memory::Event::MEM_ERASE_COMPLETE:
+        mEraseNotify.callback = func;
+        break;
+
+      default:
+        result = Aurora::Memory::Status::ERR_UNSUPPORTED;
+        break;
+    };
+
+    this->unlock();
+    return result;
   }
 
 
@@ -465,21 +348,24 @@ namespace Adesto::AT25
   {
     /*-------------------------------------------------
     Deduce the device properties. Assumes configure()
-    has already been called.
+    has already been called, or the device was given to
+    the constructor.
     -------------------------------------------------*/
     Aurora::Memory::Properties tmp;
     tmp.clear();
 
-    if ( size_t deviceSize = densityToBytes( mInfo.density ); deviceSize )
+    if ( mDevice )
     {
-      tmp.pageSize = PAGE_SIZE;
-      tmp.numPages = deviceSize / PAGE_SIZE;
+      const size_t deviceSize = mDevice->size;
 
-      tmp.blockSize = BLOCK_SIZE;
-      tmp.numBlocks = deviceSize / BLOCK_SIZE;
+      tmp.pageSize = chunkSizeOf( Aurora::Memory::Chunk::PAGE );
+      tmp.numPages = deviceSize / tmp.pageSize;
 
-      tmp.sectorSize = SECTOR_SIZE;
-      tmp.numSectors = deviceSize / SECTOR_SIZE;
+      tmp.blockSize = chunkSizeOf( Aurora::Memory::Chunk::BLOCK );
+      tmp.numBlocks = deviceSize / tmp.blockSize;
+
+      tmp.sectorSize = chunkSizeOf( Aurora::Memory::Chunk::SECTOR );
+      tmp.numSectors = deviceSize / tmp.sectorSize;
 
       tmp.jedec = mInfo.mfgID;
 
@@ -516,7 +402,43 @@ namespace Adesto::AT25
     Release access to this driver
     -------------------------------------------------*/
     this->unlock();
-    return ( mSPI != nullptr ) && readDeviceInfo( tmp );
+    if ( !mSPI )
+    {
+      return false;
+    }
+
+    /*-------------------------------------------------
+    Identify the part, then read its SFDP tables once so
+    later operations never have to go back to the device
+    for them. A part that isn't in the table can still be
+    run from what it reports about itself.
+    -------------------------------------------------*/
+    const bool known = readDeviceInfo( tmp );
+
+    this->lock();
+    mSPI->lock();
+
+    const bool discovered = discover();
+    if ( !known && !mPinned && discovered && ( tmp.jedecID != 0 ) && ( tmp.jedecID != 0x00FFFFFF ) )
+    {
+      mDiscovered.device        = Device::UNKNOWN;
+      mDiscovered.jedecID       = tmp.jedecID;
+      mDiscovered.size          = mSFDP.size;
+      mDiscovered.pageSize      = std::min( mSFDP.pageSize, PAGE_SIZE );
+      mDiscovered.addressBytes  = mSFDP.addressBytes;
+      mDiscovered.eraseTypes    = mSFDP.eraseTypes.data();
+      mDiscovered.numEraseTypes = mSFDP.numEraseTypes;
+      mDiscovered.readModes     = mSFDP.readModes.data();
+      mDiscovered.timing        = mSFDP.timing.data();
+
+      mDevice = &mDiscovered;
+    }
+
+    const bool supported = known || ( mDevice == &mDiscovered );
+
+    mSPI->unlock();
+    this->unlock();
+    return supported;
   }
 
 
@@ -538,17 +460,17 @@ namespace Adesto::AT25
     -------------------------------------------------*/
     auto spiResult = Chimera::Status::OK;
 
+    const Segment segment = { cmdBuffer.data(), cmdBuffer.data(), Command::READ_DEV_INFO_OPS_LEN };
+
     mSPI->lock();
-    spiResult |= mSPI->setChipSelect( Chimera::GPIO::State::LOW );
-    spiResult |= mSPI->readWriteBytes( cmdBuffer.data(), cmdBuffer.data(), Command::READ_DEV_INFO_OPS_LEN );
-    spiResult |= mSPI->await( Chimera::Event::Trigger::TRIGGER_TRANSFER_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK );
-    spiResult |= mSPI->setChipSelect( Chimera::GPIO::State::HIGH );
+    spiResult |= transfer( &segment, 1 );
     mSPI->unlock();
 
     /*-------------------------------------------------
     Reformat the read data properly. First returned byte
     is actually in the second position of the buffer.
     -------------------------------------------------*/
+    mInfo.jedecID = ( cmdBuffer[ 1 ] << 16 ) | ( cmdBuffer[ 2 ] << 8 ) | cmdBuffer[ 3 ];
     mInfo.mfgID   = cmdBuffer[ 1 ] & MFR_MSK;
     mInfo.family  = static_cast<FamilyCode>( ( cmdBuffer[ 2 ] >> FAMILY_CODE_POS ) & FAMILY_CODE_MSK );
     mInfo.density = static_cast<DensityCode>( ( cmdBuffer[ 2 ] >> DENSITY_CODE_POS ) & DENSITY_CODE_MSK );
@@ -558,76 +480,1188 @@ namespace Adesto::AT25
     info = mInfo;
 
     /*-------------------------------------------------
-    Validate the data
+    Validate the data. The descriptor is resolved here,
+    once, so no later operation has to look it up. A
+    driver built for a specific part only accepts that
+    part, and one identified through SFDP keeps accepting
+    the part it was built from.
     -------------------------------------------------*/
     uint32_t fullID = 0;
     memcpy( &fullID, &cmdBuffer[ 1 ], Command::READ_DEV_INFO_RSP_LEN );
 
+    const Descriptor *found = find_device( fullID );
+    if ( !found && ( mDevice == &mDiscovered ) && ( mDiscovered.jedecID == mInfo.jedecID ) )
+    {
+      found = &mDiscovered;
+    }
+
+    const bool supported    = found && ( !mPinned || ( found == mDevice ) );
+
+    if ( supported && !mPinned )
+    {
+      mDevice = found;
+    }
+
     /*-------------------------------------------------
     Release access to this driver
     -------------------------------------------------*/
     this->unlock();
-    return device_supported( fullID ) && ( spiResult == Chimera::Status::OK );
+    return supported && ( spiResult == Chimera::Status::OK );
   }
 
 
   uint16_t Driver::readStatusRegister()
   {
     /*-------------------------------------------------
-    Acquire access to this driver
+    Acquire access to this driver and the SPI bus
     -------------------------------------------------*/
     this->lock();
+    mSPI->lock();
+
+    uint16_t result = issueStatusRead();
 
     /*-------------------------------------------------
-    Initialize the command sequence
+    Release access to this driver
     -------------------------------------------------*/
-    cmdBuffer.fill( 0 );
-    uint16_t result = 0;
+    mSPI->unlock();
+    this->unlock();
+    return result;
+  }
+
+
+  const Descriptor *Driver::getDescriptor() const
+  {
+    return mDevice;
+  }
+
+
+  SFDPInfo Driver::getSFDP()
+  {
+    this->lock();
+    const SFDPInfo info = mSFDP;
+    this->unlock();
+
+    return info;
+  }
+
+
+  OperationStats Driver::getOperationStats( const Operation op )
+  {
+    OperationStats tmp = {};
+
+    if ( op < Operation::NUM_OPTIONS )
+    {
+      this->lock();
+      tmp = mOpStats[ static_cast<size_t>( op ) ];
+      this->unlock();
+    }
+
+    return tmp;
+  }
+
+
+  void Driver::resetOperationStats()
+  {
+    this->lock();
+    for ( auto &stats : mOpStats )
+    {
+      stats = {};
+    }
+    this->unlock();
+  }
+
+
+  Aurora::Memory::Status Driver::setWriteBack( const bool enable, const size_t threshold, const size_t timeout )
+  {
+    this->lock();
+    mSPI->lock();
 
     /*-------------------------------------------------
-    Perform the SPI transaction
+    Make sure nothing is left stranded in the buffer
+    before the behavior changes.
     -------------------------------------------------*/
+    auto result = flushWriteBack();
+
+    mWB.enabled   = enable;
+    mWB.threshold = ( threshold && ( threshold < PAGE_SIZE ) ) ? threshold : PAGE_SIZE;
+    mWB.timeout   = timeout;
+
+    mSPI->unlock();
+    this->unlock();
+    return result;
+  }
+
+
+  Aurora::Memory::Status Driver::setAsync( const bool enable )
+  {
+    this->lock();
     mSPI->lock();
 
-    // Read out byte 1
-    cmdBuffer[ 0 ] = Command::READ_SR_BYTE1;
-    mSPI->setChipSelect( Chimera::GPIO::State::LOW );
-    mSPI->readWriteBytes( cmdBuffer.data(), cmdBuffer.data(), Command::READ_SR_BYTE1_OPS_LEN );
-    mSPI->await( Chimera::Event::Trigger::TRIGGER_TRANSFER_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK );
-    mSPI->setChipSelect( Chimera::GPIO::State::HIGH );
+    auto result = awaitJob( Chimera::Threading::TIMEOUT_BLOCK );
+    mAsync      = enable;
+
+    mSPI->unlock();
+    this->unlock();
+    return result;
+  }
 
-    result |= cmdBuffer[ 1 ];
 
-    // Read out byte 2
-    cmdBuffer[ 0 ] = Command::READ_SR_BYTE2;
-    cmdBuffer[ 1 ] = 0;
-    mSPI->setChipSelect( Chimera::GPIO::State::LOW );
-    mSPI->readWriteBytes( cmdBuffer.data(), cmdBuffer.data(), Command::READ_SR_BYTE2_OPS_LEN );
-    mSPI->await( Chimera::Event::Trigger::TRIGGER_TRANSFER_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK );
-    mSPI->setChipSelect( Chimera::GPIO::State::HIGH );
+  Aurora::Memory::Status Driver::suspend()
+  {
+    this->lock();
+    mSPI->lock();
+
+    auto result = issueSuspend();
+
+    mSPI->unlock();
+    this->unlock();
+    return result;
+  }
+
+
+  Aurora::Memory::Status Driver::resume()
+  {
+    this->lock();
+    mSPI->lock();
 
-    result |= ( cmdBuffer[ 1 ] << 8 );
+    auto result = Aurora::Memory::Status::ERR_OK;
+    if ( issueResume() != Chimera::Status::OK )
+    {
+      result = Aurora::Memory::Status::ERR_DRIVER_ERR;
+    }
 
     mSPI->unlock();
+    this->unlock();
+    return result;
+  }
+
+
+  bool Driver::isSuspended()
+  {
+    this->lock();
+    const bool suspended = mSuspended;
+    this->unlock();
+
+    return suspended;
+  }
+
+
+  void Driver::process()
+  {
+    this->lock();
 
     /*-------------------------------------------------
-    Release access to this driver
+    Move the background job along once the device has
+    finished the step in progress. A device that stays
+    busy past the worst case time isn't coming back.
+    -------------------------------------------------*/
+    if ( mJob.active && !mSuspended )
+    {
+      mSPI->lock();
+
+      if ( !( issueStatusRead() & Register::SR_RDY_BUSY ) )
+      {
+        mPendingOp = Operation::NONE;
+        advanceJob();
+      }
+      else if ( ( ( Chimera::micros() - mOpStartTime ) / 1000 ) > operation_timeout( timingOf( mPendingOp ) ) )
+      {
+        completeJob( Aurora::Memory::Status::ERR_TIMEOUT );
+      }
+
+      mSPI->unlock();
+    }
+
+    /*-------------------------------------------------
+    Flushing would have to wait on the background job,
+    so leave aged data for a later pass. A failure is
+    held for the next flush() rather than retried here.
+    -------------------------------------------------*/
+    if ( !mJob.active && mWB.dirty && mWB.timeout && ( mWB.error == Aurora::Memory::Status::ERR_OK )
+         && ( ( Chimera::millis() - mWB.dirtyTime ) >= mWB.timeout ) )
+    {
+      mSPI->lock();
+      mWB.error = flushWriteBack();
+      mSPI->unlock();
+    }
+
+    /*-------------------------------------------------
+    Collect finished work, then report it once the locks
+    are released so the callbacks may use the driver.
     -------------------------------------------------*/
+    const AsyncNotify writeDone = mWriteNotify;
+    const AsyncNotify eraseDone = mEraseNotify;
+
+    mWriteNotify.pending = 0;
+    mEraseNotify.pending = 0;
+
     this->unlock();
-    return result;
+
+    if ( writeDone.callback && writeDone.pending )
+    {
+      writeDone.callback( writeDone.pending );
+    }
+
+    if ( eraseDone.callback && eraseDone.pending )
+    {
+      eraseDone.callback( eraseDone.pending );
+    }
+  }
+
+
+  Batch Driver::beginBatch()
+  {
+    return Batch( *this );
   }
 
 
   /*-------------------------------------------------------------------------------
   Driver: Private Interface
   -------------------------------------------------------------------------------*/
-  void Driver::issueWriteEnable()
+  Aurora::Memory::Status Driver::performRead( const size_t address, void *const data, const size_t length )
   {
-    mSPI->lock();
-    mSPI->setChipSelect( Chimera::GPIO::State::LOW );
-    mSPI->writeBytes( &Command::WRITE_ENABLE, Command::WRITE_ENABLE_OPS_LEN );
-    mSPI->await( Chimera::Event::TRIGGER_TRANSFER_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK );
-    mSPI->setChipSelect( Chimera::GPIO::State::HIGH );
-    mSPI->unlock();
+    /*-------------------------------------------------
+    Input Protection
+    -------------------------------------------------*/
+    if ( !data || !length )
+    {
+      return Aurora::Memory::Status::ERR_BAD_ARG;
+    }
+
+    /*-------------------------------------------------
+    The device ignores reads while it is busy. A background
+    erase can be suspended for the read, so long as the
+    read stays out of everything the job has yet to erase,
+    not just the block in flight. Anything else has to
+    finish first.
+    -------------------------------------------------*/
+    const size_t jobEnd     = mJob.address + mJob.remaining;
+    const bool wasSuspended = mSuspended;
+    const bool suspendable  = ( mJob.event == Aurora::Memory::Event::MEM_ERASE_COMPLETE )
+                             && ( ( address >= jobEnd ) || ( ( address + length ) <= mJob.stepAddress ) );
+
+    if ( mJob.active && ( !suspendable || ( issueSuspend() != Aurora::Memory::Status::ERR_OK ) ) )
+    {
+      if ( auto jobResult = awaitJob( Chimera::Threading::TIMEOUT_BLOCK ); jobResult != Aurora::Memory::Status::ERR_OK )
+      {
+        return jobResult;
+      }
+    }
+
+    const bool resumeAfter = mSuspended && !wasSuspended;
+
+    /*-------------------------------------------------
+    Initialize the command sequence. The high speed
+    command works for all frequency ranges.
+    -------------------------------------------------*/
+    cmdBuffer[ 0 ] = Command::READ_ARRAY_HS;
+    cmdBuffer[ 1 ] = ( address & ADDRESS_BYTE_3_MSK ) >> ADDRESS_BYTE_3_POS;
+    cmdBuffer[ 2 ] = ( address & ADDRESS_BYTE_2_MSK ) >> ADDRESS_BYTE_2_POS;
+    cmdBuffer[ 3 ] = ( address & ADDRESS_BYTE_1_MSK ) >> ADDRESS_BYTE_1_POS;
+    cmdBuffer[ 4 ] = 0;  // Dummy byte
+
+    /*-------------------------------------------------
+    Perform the SPI transaction. The command and the data
+    are clocked as one chip select cycle.
+    -------------------------------------------------*/
+    const std::array<Segment, 2> segments = { {
+      { cmdBuffer.data(), nullptr, Command::READ_ARRAY_HS_OPS_LEN },  // Tell the hardware which address to read from
+      { nullptr, data, length },                                      // Pull out all the data
+    } };
+
+    const auto spiResult = transfer( segments.data(), segments.size() );
+
+    if ( resumeAfter )
+    {
+      issueResume();
+    }
+
+    if ( spiResult != Chimera::Status::OK )
+    {
+      return Aurora::Memory::Status::ERR_DRIVER_ERR;
+    }
+
+    /*-------------------------------------------------
+    Buffered writes haven't reached the chip yet. Apply
+    them the same way the program operation will, which
+    can only ever clear bits.
+    -------------------------------------------------*/
+    if ( mWB.dirty )
+    {
+      const size_t wbStart = ( mWB.page * PAGE_SIZE ) + mWB.low;
+      const size_t wbEnd   = ( mWB.page * PAGE_SIZE ) + mWB.high;
+      const size_t start   = std::max( address, wbStart );
+      const size_t end     = std::min( address + length, wbEnd );
+      auto dst             = reinterpret_cast<uint8_t *>( data );
+
+      for ( size_t addr = start; addr < end; addr++ )
+      {
+        dst[ addr - address ] &= mWBBuffer[ addr % PAGE_SIZE ];
+      }
+    }
+
+    return Aurora::Memory::Status::ERR_OK;
+  }
+
+
+  Aurora::Memory::Status Driver::performWrite( const size_t address, const void *const data, const size_t length )
+  {
+    /*-------------------------------------------------
+    Input Protection
+    -------------------------------------------------*/
+    if ( !data || !length )
+    {
+      return Aurora::Memory::Status::ERR_BAD_ARG;
+    }
+
+    if ( auto jobResult = awaitJob( Chimera::Threading::TIMEOUT_BLOCK ); jobResult != Aurora::Memory::Status::ERR_OK )
+    {
+      return jobResult;
+    }
+
+    if ( mWB.enabled )
+    {
+      return bufferWrite( address, data, length );
+    }
+    else if ( mAsync )
+    {
+      return startJob( Aurora::Memory::Event::MEM_WRITE_COMPLETE, address, reinterpret_cast<const uint8_t *>( data ), length );
+    }
+    else
+    {
+      return programPages( address, data, length );
+    }
+  }
+
+
+  Aurora::Memory::Status Driver::programPages( const size_t address, const void *const data, const size_t length )
+  {
+    /*-------------------------------------------------
+    Stage the command for the first page. Writes are not
+    allowed to cross a page boundary, otherwise the chip
+    wraps around to the start of the same page.
+    -------------------------------------------------*/
+    auto result       = Aurora::Memory::Status::ERR_OK;
+    auto dataPtr      = reinterpret_cast<const uint8_t *>( data );
+    size_t bytesDone  = 0;
+    size_t chunkBytes = stagePageProgram( address, length );
+
+    while ( bytesDone < length )
+    {
+      /*-------------------------------------------------
+      Per datasheet specs, the write enable command must
+      be sent before issuing the actual data.
+      -------------------------------------------------*/
+      issueWriteEnable();
+
+      if ( issuePageProgram( dataPtr + bytesDone, chunkBytes ) != Chimera::Status::OK )
+      {
+        result = Aurora::Memory::Status::ERR_DRIVER_ERR;
+        break;
+      }
+
+      startOperation( Operation::PAGE_PROGRAM );
+      bytesDone += chunkBytes;
+
+      /*-------------------------------------------------
+      The chip is now busy programming the page. Use that
+      time to build the command for the next page, then
+      wait for the program cycle to finish.
+      -------------------------------------------------*/
+      if ( bytesDone < length )
+      {
+        chunkBytes = stagePageProgram( address + bytesDone, length - bytesDone );
+      }
+
+      result = awaitIdle( operation_timeout( timingOf( Operation::PAGE_PROGRAM ) ) );
+      if ( result != Aurora::Memory::Status::ERR_OK )
+      {
+        break;
+      }
+    }
+
+    return result;
+  }
+
+
+  Aurora::Memory::Status Driver::bufferWrite( const size_t address, const void *const data, const size_t length )
+  {
+    auto result      = Aurora::Memory::Status::ERR_OK;
+    auto src         = reinterpret_cast<const uint8_t *>( data );
+    size_t bytesDone = 0;
+
+    while ( ( bytesDone < length ) && ( result == Aurora::Memory::Status::ERR_OK ) )
+    {
+      const size_t addr   = address + bytesDone;
+      const size_t page   = addr / PAGE_SIZE;
+      const size_t offset = addr % PAGE_SIZE;
+      const size_t chunk  = std::min( PAGE_SIZE - offset, length - bytesDone );
+
+      /*-------------------------------------------------
+      Moving to a new page? Commit the old one first.
+      -------------------------------------------------*/
+      if ( mWB.dirty && ( mWB.page != page ) )
+      {
+        result = flushWriteBack();
+        if ( result != Aurora::Memory::Status::ERR_OK )
+        {
+          break;
+        }
+      }
+
+      /*-------------------------------------------------
+      Whole pages gain nothing from being buffered
+      -------------------------------------------------*/
+      if ( !mWB.dirty && ( chunk == PAGE_SIZE ) )
+      {
+        result = programPages( addr, src + bytesDone, chunk );
+        bytesDone += chunk;
+        continue;
+      }
+
+      /*-------------------------------------------------
+      Merge the data into the buffer. Programming can only
+      clear bits, so AND the data in to end up with exactly
+      what the chip would hold after separate programs.
+      -------------------------------------------------*/
+      if ( !mWB.dirty )
+      {
+        mWBBuffer.fill( 0xFF );
+        mWB.dirty     = true;
+        mWB.page      = page;
+        mWB.low       = offset;
+        mWB.high      = offset + chunk;
+        mWB.pending   = 0;
+        mWB.dirtyTime = Chimera::millis();
+      }
+
+      for ( size_t idx = 0; idx < chunk; idx++ )
+      {
+        mWBBuffer[ offset + idx ] &= src[ bytesDone + idx ];
+      }
+
+      mWB.low  = std::min( mWB.low, offset );
+      mWB.high = std::max( mWB.high, offset + chunk );
+      mWB.pending += chunk;
+      bytesDone += chunk;
+
+      if ( mWB.pending >= mWB.threshold )
+      {
+        result = flushWriteBack();
+      }
+    }
+
+    return result;
+  }
+
+
+  Aurora::Memory::Status Driver::flushWriteBack()
+  {
+    if ( !mWB.dirty )
+    {
+      return Aurora::Memory::Status::ERR_OK;
+    }
+
+    if ( auto jobResult = awaitJob( Chimera::Threading::TIMEOUT_BLOCK ); jobResult != Aurora::Memory::Status::ERR_OK )
+    {
+      return jobResult;
+    }
+
+    /*-------------------------------------------------
+    Only the span that was touched needs to go out. The
+    bytes in between that were never written are still
+    0xFF, which leaves the chip contents untouched. On
+    failure the data stays buffered for another try.
+    -------------------------------------------------*/
+    auto result = programPages( ( mWB.page * PAGE_SIZE ) + mWB.low, mWBBuffer.data() + mWB.low, mWB.high - mWB.low );
+    if ( result == Aurora::Memory::Status::ERR_OK )
+    {
+      mWB.dirty = false;
+    }
+
+    return result;
+  }
+
+
+  Aurora::Memory::Status Driver::performErase( const size_t address, const size_t length )
+  {
+    /*-------------------------------------------------
+    Input Protection: The range must be aligned to the
+    smallest erase granularity and fit on the device.
+    -------------------------------------------------*/
+    const size_t minChunk   = mDevice ? mDevice->eraseTypes[ 0 ].size : CHUNK_SIZE_4K;
+    const size_t deviceSize = mDevice ? mDevice->size : 0;
+
+    if ( !length || ( ( address % minChunk ) != 0 ) || ( ( length % minChunk ) != 0 ) )
+    {
+      return Aurora::Memory::Status::ERR_BAD_ARG;
+    }
+
+    if ( ( address + length ) > deviceSize )
+    {
+      return Aurora::Memory::Status::ERR_BAD_ARG;
+    }
+
+    if ( auto jobResult = awaitJob( Chimera::Threading::TIMEOUT_BLOCK ); jobResult != Aurora::Memory::Status::ERR_OK )
+    {
+      return jobResult;
+    }
+
+    /*-------------------------------------------------
+    Buffered writes to a page about to be erased would be
+    wiped out anyways, so drop them rather than waste a
+    program cycle.
+    -------------------------------------------------*/
+    if ( mWB.dirty && ( ( mWB.page * PAGE_SIZE ) >= address ) && ( ( mWB.page * PAGE_SIZE ) < ( address + length ) ) )
+    {
+      mWB.dirty = false;
+    }
+
+    if ( mAsync )
+    {
+      return startJob( Aurora::Memory::Event::MEM_ERASE_COMPLETE, address, nullptr, length );
+    }
+
+    /*-------------------------------------------------
+    Break the range into as few erase commands as possible,
+    waiting for each one to complete before the next.
+    -------------------------------------------------*/
+    auto result        = Aurora::Memory::Status::ERR_OK;
+    size_t bytesErased = 0;
+
+    while ( bytesErased < length )
+    {
+      Operation eraseOp       = Operation::NONE;
+      const size_t chunkBytes = stageErase( address + bytesErased, length - bytesErased, eraseOp );
+
+      /*-------------------------------------------------
+      Per datasheet specs, the write enable command must
+      be sent before issuing the actual data.
+      -------------------------------------------------*/
+      issueWriteEnable();
+
+      if ( issueErase( eraseOp ) != Chimera::Status::OK )
+      {
+        result = Aurora::Memory::Status::ERR_DRIVER_ERR;
+        break;
+      }
+
+      startOperation( eraseOp );
+      bytesErased += chunkBytes;
+
+      result = awaitIdle( operation_timeout( timingOf( eraseOp ) ) );
+      if ( result != Aurora::Memory::Status::ERR_OK )
+      {
+        break;
+      }
+    }
+
+    return result;
+  }
+
+
+  Chimera::Status_t Driver::transfer( const Segment *const segments, const size_t count )
+  {
+    /*-------------------------------------------------
+    Figure out how large the whole transaction is
+    -------------------------------------------------*/
+    size_t totalBytes = 0;
+    for ( size_t idx = 0; idx < count; idx++ )
+    {
+      totalBytes += segments[ idx ].length;
+    }
+
+    auto spiResult = Chimera::Status::OK;
+    spiResult |= mSPI->setChipSelect( Chimera::GPIO::State::LOW );
+
+    if ( totalBytes <= mXferBuffer.size() )
+    {
+      /*-------------------------------------------------
+      Gather every segment into the staging buffer so the
+      bus only has to be set up and waited on once.
+      -------------------------------------------------*/
+      size_t offset = 0;
+      for ( size_t idx = 0; idx < count; idx++ )
+      {
+        if ( segments[ idx ].tx )
+        {
+          memcpy( mXferBuffer.data() + offset, segments[ idx ].tx, segments[ idx ].length );
+        }
+        else
+        {
+          memset( mXferBuffer.data() + offset, 0, segments[ idx ].length );
+        }
+
+        offset += segments[ idx ].length;
+      }
+
+      spiResult |= mSPI->readWriteBytes( mXferBuffer.data(), mXferBuffer.data(), totalBytes );
+      spiResult |= mSPI->await( Chimera::Event::Trigger::TRIGGER_TRANSFER_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK );
+
+      /*-------------------------------------------------
+      Scatter the received data back out
+      -------------------------------------------------*/
+      offset = 0;
+      for ( size_t idx = 0; idx < count; idx++ )
+      {
+        if ( segments[ idx ].rx )
+        {
+          memcpy( segments[ idx ].rx, mXferBuffer.data() + offset, segments[ idx ].length );
+        }
+
+        offset += segments[ idx ].length;
+      }
+    }
+    else
+    {
+      /*-------------------------------------------------
+      Too large to stage. The payload dominates the bus time
+      here, so clock each segment directly from user memory.
+      -------------------------------------------------*/
+      for ( size_t idx = 0; idx < count; idx++ )
+      {
+        const Segment &seg = segments[ idx ];
+
+        if ( seg.tx && seg.rx )
+        {
+          spiResult |= mSPI->readWriteBytes( seg.tx, seg.rx, seg.length );
+        }
+        else if ( seg.tx )
+        {
+          spiResult |= mSPI->writeBytes( seg.tx, seg.length );
+        }
+        else
+        {
+          spiResult |= mSPI->readBytes( seg.rx, seg.length );
+        }
+
+        spiResult |= mSPI->await( Chimera::Event::Trigger::TRIGGER_TRANSFER_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK );
+      }
+    }
+
+    spiResult |= mSPI->setChipSelect( Chimera::GPIO::State::HIGH );
+    return spiResult;
+  }
+
+
+  void Driver::issueWriteEnable()
+  {
+    const Segment segment = { &Command::WRITE_ENABLE, nullptr, Command::WRITE_ENABLE_OPS_LEN };
+    transfer( &segment, 1 );
+  }
+
+
+  uint16_t Driver::issueStatusRead()
+  {
+    /*-------------------------------------------------
+    Use a local buffer so that polling the status never
+    clobbers a command staged in the class cmdBuffer.
+    -------------------------------------------------*/
+    std::array<uint8_t, Command::READ_SR_BYTE1_OPS_LEN> srBuffer;
+    const Segment segment = { srBuffer.data(), srBuffer.data(), srBuffer.size() };
+    uint16_t result       = 0;
+
+    // Read out byte 1
+    srBuffer.fill( 0 );
+    srBuffer[ 0 ] = Command::READ_SR_BYTE1;
+    transfer( &segment, 1 );
+
+    result |= srBuffer[ 1 ];
+
+    // Read out byte 2
+    srBuffer.fill( 0 );
+    srBuffer[ 0 ] = Command::READ_SR_BYTE2;
+    transfer( &segment, 1 );
+
+    result |= ( srBuffer[ 1 ] << 8 );
+    return result;
+  }
+
+
+  size_t Driver::stagePageProgram( const size_t address, const size_t length )
+  {
+    /*-------------------------------------------------
+    Clip the length at the next page boundary
+    -------------------------------------------------*/
+    const size_t pageSize      = mDevice ? mDevice->pageSize : PAGE_SIZE;
+    const size_t pageRemaining = pageSize - ( address % pageSize );
+
+    /*-------------------------------------------------
+    Initialize the command sequence
+    -------------------------------------------------*/
+    cmdBuffer[ 0 ] = Command::PAGE_PROGRAM;
+    cmdBuffer[ 1 ] = ( address & ADDRESS_BYTE_3_MSK ) >> ADDRESS_BYTE_3_POS;
+    cmdBuffer[ 2 ] = ( address & ADDRESS_BYTE_2_MSK ) >> ADDRESS_BYTE_2_POS;
+    cmdBuffer[ 3 ] = ( address & ADDRESS_BYTE_1_MSK ) >> ADDRESS_BYTE_1_POS;
+
+    return ( length < pageRemaining ) ? length : pageRemaining;
+  }
+
+
+  Chimera::Status_t Driver::issuePageProgram( const void *const data, const size_t length )
+  {
+    const std::array<Segment, 2> segments = { {
+      { cmdBuffer.data(), nullptr, Command::PAGE_PROGRAM_OPS_LEN },  // Tell the hardware which address to write into
+      { data, nullptr, length },                                     // Dump the data
+    } };
+
+    return transfer( segments.data(), segments.size() );
+  }
+
+
+  size_t Driver::stageErase( const size_t address, const size_t length, Operation &op )
+  {
+    /*-------------------------------------------------
+    Whole chip erase? This is significantly faster than
+    erasing each block individually.
+    -------------------------------------------------*/
+    if ( mDevice && ( address == 0 ) && ( length == mDevice->size ) )
+    {
+      cmdBuffer[ 0 ] = Command::CHIP_ERASE;
+      op             = Operation::ERASE_CHIP;
+      return length;
+    }
+
+    /*-------------------------------------------------
+    Otherwise pick the largest erase type the part offers
+    that is aligned with the address and doesn't overshoot
+    the range. Callers have already checked the range, so
+    a device is known at this point.
+    -------------------------------------------------*/
+    const EraseType *eraseType = &mDevice->eraseTypes[ 0 ];
+    for ( auto idx = mDevice->numEraseTypes; idx > 0; idx-- )
+    {
+      const EraseType *candidate = &mDevice->eraseTypes[ idx - 1 ];
+      if ( ( ( address % candidate->size ) == 0 ) && ( length >= candidate->size ) )
+      {
+        eraseType = candidate;
+        break;
+      }
+    }
+
+    const size_t chunkSize = eraseType->size;
+    cmdBuffer[ 0 ]         = eraseType->opcode;
+    op                     = eraseType->op;
+
+    cmdBuffer[ 1 ] = ( address & ADDRESS_BYTE_3_MSK ) >> ADDRESS_BYTE_3_POS;
+    cmdBuffer[ 2 ] = ( address & ADDRESS_BYTE_2_MSK ) >> ADDRESS_BYTE_2_POS;
+    cmdBuffer[ 3 ] = ( address & ADDRESS_BYTE_1_MSK ) >> ADDRESS_BYTE_1_POS;
+
+    return chunkSize;
+  }
+
+
+  Chimera::Status_t Driver::issueErase( const Operation op )
+  {
+    const size_t len      = ( op == Operation::ERASE_CHIP ) ? Command::CHIP_ERASE_OPS_LEN : Command::BLOCK_ERASE_OPS_LEN;
+    const Segment segment = { cmdBuffer.data(), nullptr, len };
+
+    return transfer( &segment, 1 );
+  }
+
+
+  Aurora::Memory::Status Driver::issueSuspend()
+  {
+    if ( mSuspended || ( mPendingOp == Operation::NONE ) )
+    {
+      return Aurora::Memory::Status::ERR_OK;
+    }
+
+    const Segment segment = { &Command::PROGRAM_ERASE_SUSPEND, nullptr, Command::PROGRAM_ERASE_SUSPEND_OPS_LEN };
+    if ( transfer( &segment, 1 ) != Chimera::Status::OK )
+    {
+      return Aurora::Memory::Status::ERR_DRIVER_ERR;
+    }
+
+    /*-------------------------------------------------
+    The device stays busy for a short time after the
+    command while it parks the operation.
+    -------------------------------------------------*/
+    const size_t startTime = Chimera::micros();
+    uint16_t status        = 0;
+
+    do
+    {
+      Chimera::delayMicroseconds( SUSPEND_LATENCY );
+      status = issueStatusRead();
+    } while ( ( status & Register::SR_RDY_BUSY ) && ( ( Chimera::micros() - startTime ) < SUSPEND_TIMEOUT ) );
+
+    if ( status & Register::SR_RDY_BUSY )
+    {
+      return Aurora::Memory::Status::ERR_TIMEOUT;
+    }
+
+    /*-------------------------------------------------
+    Ready without the SUS flag means the operation beat
+    the suspend command and is already done.
+    -------------------------------------------------*/
+    if ( status & Register::SR_SUS )
+    {
+      mSuspended   = true;
+      mSuspendTime = Chimera::micros();
+    }
+
+    return Aurora::Memory::Status::ERR_OK;
+  }
+
+
+  Chimera::Status_t Driver::issueResume()
+  {
+    if ( !mSuspended )
+    {
+      return Chimera::Status::OK;
+    }
+
+    const Segment segment = { &Command::PROGRAM_ERASE_RESUME, nullptr, Command::PROGRAM_ERASE_RESUME_OPS_LEN };
+    auto result           = transfer( &segment, 1 );
+
+    mOpStartTime += Chimera::micros() - mSuspendTime;
+    mSuspended = false;
+    return result;
+  }
+
+
+  Chimera::Status_t Driver::issueReadSFDP( const size_t address, void *const data, const size_t length )
+  {
+    cmdBuffer[ 0 ] = Command::READ_SFDP;
+    cmdBuffer[ 1 ] = ( address & ADDRESS_BYTE_3_MSK ) >> ADDRESS_BYTE_3_POS;
+    cmdBuffer[ 2 ] = ( address & ADDRESS_BYTE_2_MSK ) >> ADDRESS_BYTE_2_POS;
+    cmdBuffer[ 3 ] = ( address & ADDRESS_BYTE_1_MSK ) >> ADDRESS_BYTE_1_POS;
+    cmdBuffer[ 4 ] = 0;
+
+    const std::array<Segment, 2> segments = { {
+      { cmdBuffer.data(), nullptr, Command::READ_SFDP_OPS_LEN },
+      { nullptr, data, length },
+    } };
+
+    return transfer( segments.data(), segments.size() );
+  }
+
+
+  bool Driver::discover()
+  {
+    std::array<uint8_t, SFDP::HEADER_LEN + SFDP::PARAM_HEADER_LEN> header;
+    std::array<uint8_t, SFDP::BASIC_TABLE_MAX_DW * sizeof( uint32_t )> table;
+
+    mSFDP = {};
+    header.fill( 0 );
+    table.fill( 0 );
+
+    /*-------------------------------------------------
+    Find the basic table, then read as much of it as the
+    decoder understands. Newer revisions append DWORDs
+    that are safe to ignore.
+    -------------------------------------------------*/
+    size_t tableAddress = 0;
+    size_t tableDwords  = 0;
+
+    if ( ( issueReadSFDP( 0, header.data(), header.size() ) != Chimera::Status::OK ) ||
+         !SFDP::parseHeader( header.data(), tableAddress, tableDwords ) )
+    {
+      return false;
+    }
+
+    tableDwords = std::min( tableDwords, SFDP::BASIC_TABLE_MAX_DW );
+    if ( issueReadSFDP( tableAddress, table.data(), tableDwords * sizeof( uint32_t ) ) != Chimera::Status::OK )
+    {
+      return false;
+    }
+
+    return SFDP::parseBasicTable( table.data(), tableDwords, mSFDP );
+  }
+
+
+  const OperationTiming &Driver::timingOf( const Operation op ) const
+  {
+    /*-------------------------------------------------
+    Until the part is known, assume the AT25SF081 the
+    driver was originally written for.
+    -------------------------------------------------*/
+    const size_t idx = static_cast<size_t>( op );
+    return mDevice ? mDevice->timing[ idx ] : OperationTimes[ idx ];
+  }
+
+
+  size_t Driver::chunkSizeOf( const Aurora::Memory::Chunk chunk ) const
+  {
+    if ( !mDevice )
+    {
+      return 0;
+    }
+
+    /*-------------------------------------------------
+    Blocks are the smallest erase the part offers and
+    sectors the next size up, which for the AT25SF family
+    are the 4kB and 32kB erases.
+    -------------------------------------------------*/
+    switch ( chunk )
+    {
+      case Aurora::Memory::Chunk::PAGE:
+        return mDevice->pageSize;
+
+      case Aurora::Memory::Chunk::BLOCK:
+        return mDevice->eraseTypes[ 0 ].size;
+
+      case Aurora::Memory::Chunk::SECTOR:
+        return mDevice->eraseTypes[ ( mDevice->numEraseTypes > 1 ) ? 1 : 0 ].size;
+
+      default:
+        return 0;
+    }
+  }
+
+
+  void Driver::startOperation( const Operation op )
+  {
+    mPendingOp   = op;
+    mOpStartTime = Chimera::micros();
+  }
+
+
+  Aurora::Memory::Status Driver::awaitIdle( const size_t timeout )
+  {
+    /*-------------------------------------------------
+    A suspended operation would never finish
+    -------------------------------------------------*/
+    if ( mSuspended )
+    {
+      issueResume();
+    }
+
+    const size_t opIdx        = static_cast<size_t>( mPendingOp );
+    const OperationTiming &dt = timingOf( mPendingOp );
+    OperationStats &stats     = mOpStats[ opIdx ];
+
+    /*-------------------------------------------------
+    Decide when the operation should be done. Prefer what
+    has been observed on this particular chip, backed off
+    slightly as observations can only overestimate the
+    true completion time.
+    -------------------------------------------------*/
+    const size_t expected = stats.samples ? ( stats.learned - ( stats.learned / 8 ) ) : dt.typical;
+    const size_t elapsed  = Chimera::micros() - mOpStartTime;
+    const size_t maxPoll  = std::max( dt.maximum / MAX_POLL_DIVISOR, MIN_POLL_INTERVAL );
+
+    size_t pollDelay = ( expected > elapsed ) ? ( expected - elapsed ) : 0;
+    size_t backoff   = std::max( expected / MAX_POLL_DIVISOR, MIN_POLL_INTERVAL );
+
+    /*-------------------------------------------------
+    Only trust the completion time if the device was seen
+    busy, or it was checked right at the expected time.
+    Otherwise the caller simply showed up late.
+    -------------------------------------------------*/
+    bool observed          = ( pollDelay != 0 );
+    const size_t startTime = Chimera::millis();
+
+    while ( true )
+    {
+      if ( pollDelay )
+      {
+        sleepFor( pollDelay );
+      }
+
+      if ( !( issueStatusRead() & Register::SR_RDY_BUSY ) )
+      {
+        break;
+      }
+
+      /*-------------------------------------------------
+      Still busy. Check for timeout, then back off the poll
+      rate exponentially up to the limit for this operation.
+      -------------------------------------------------*/
+      if ( ( Chimera::millis() - startTime ) > timeout )
+      {
+        return Aurora::Memory::Status::ERR_TIMEOUT;
+      }
+
+      observed  = true;
+      pollDelay = backoff;
+      backoff   = std::min( backoff * 2, maxPoll );
+    }
+
+    /*-------------------------------------------------
+    Fold the completion time into the running estimate
+    -------------------------------------------------*/
+    if ( observed && ( mPendingOp != Operation::NONE ) )
+    {
+      const size_t actual = Chimera::micros() - mOpStartTime;
+
+      if ( !stats.samples )
+      {
+        stats.learned = actual;
+        stats.minimum = actual;
+        stats.maximum = actual;
+      }
+      else
+      {
+        stats.learned = stats.learned - ( stats.learned / 4 ) + ( actual / 4 );
+        stats.minimum = std::min( stats.minimum, actual );
+        stats.maximum = std::max( stats.maximum, actual );
+      }
+
+      stats.samples++;
+    }
+
+    mPendingOp = Operation::NONE;
+    return Aurora::Memory::Status::ERR_OK;
+  }
+
+
+  Aurora::Memory::Status Driver::startJob( const Aurora::Memory::Event event, const size_t address,
+                                           const uint8_t *const data, const size_t length )
+  {
+    mJob = { true, event, data, address, address, 0, length, length, Aurora::Memory::Status::ERR_OK };
+    return advanceJob();
+  }
+
+
+  Aurora::Memory::Status Driver::advanceJob()
+  {
+    if ( !mJob.remaining )
+    {
+      completeJob( Aurora::Memory::Status::ERR_OK );
+      return Aurora::Memory::Status::ERR_OK;
+    }
+
+    /*-------------------------------------------------
+    Build the next command with the same planners the
+    blocking paths use, so each step is identical to
+    one iteration of programPages() or performErase().
+    -------------------------------------------------*/
+    Operation op      = Operation::PAGE_PROGRAM;
+    size_t chunkBytes = 0;
+    auto spiResult    = Chimera::Status::OK;
+
+    if ( mJob.data )
+    {
+      chunkBytes = stagePageProgram( mJob.address, mJob.remaining );
+    }
+    else
+    {
+      chunkBytes = stageErase( mJob.address, mJob.remaining, op );
+    }
+
+    /*-------------------------------------------------
+    Per datasheet specs, the write enable command must
+    be sent before issuing the actual data.
+    -------------------------------------------------*/
+    issueWriteEnable();
+
+    if ( mJob.data )
+    {
+      spiResult = issuePageProgram( mJob.data, chunkBytes );
+    }
+    else
+    {
+      spiResult = issueErase( op );
+    }
+
+    if ( spiResult != Chimera::Status::OK )
+    {
+      completeJob( Aurora::Memory::Status::ERR_DRIVER_ERR );
+      return Aurora::Memory::Status::ERR_DRIVER_ERR;
+    }
+
+    startOperation( op );
+    mJob.stepAddress = mJob.address;
+    mJob.stepLength  = chunkBytes;
+    mJob.address += chunkBytes;
+    mJob.remaining -= chunkBytes;
+
+    if ( mJob.data )
+    {
+      mJob.data += chunkBytes;
+    }
+
+    return Aurora::Memory::Status::ERR_OK;
+  }
+
+
+  void Driver::completeJob( const Aurora::Memory::Status result )
+  {
+    const size_t bytesDone = mJob.length - mJob.remaining;
+
+    mJob.active = false;
+    mJob.result = result;
+
+    if ( mJob.event == Aurora::Memory::Event::MEM_WRITE_COMPLETE )
+    {
+      mWriteNotify.pending += bytesDone;
+    }
+    else
+    {
+      mEraseNotify.pending += bytesDone;
+    }
+  }
+
+
+  Aurora::Memory::Status Driver::awaitJob( const size_t timeout )
+  {
+    /*-------------------------------------------------
+    An operation suspended by the user has no job to
+    continue, but still has to finish before the device
+    will take new work.
+    -------------------------------------------------*/
+    if ( !mJob.active && mSuspended )
+    {
+      issueResume();
+      return awaitIdle( std::min( timeout, operation_timeout( timingOf( mPendingOp ) ) ) );
+    }
+    else if ( !mJob.active )
+    {
+      return Aurora::Memory::Status::ERR_OK;
+    }
+
+    const size_t startTime = Chimera::millis();
+
+    while ( mJob.active )
+    {
+      /*-------------------------------------------------
+      Wait on the step in progress, but no longer than the
+      caller allows or the device could possibly need.
+      -------------------------------------------------*/
+      const size_t elapsed = Chimera::millis() - startTime;
+      if ( elapsed > timeout )
+      {
+        return Aurora::Memory::Status::ERR_TIMEOUT;
+      }
+
+      const size_t userLimit = timeout - elapsed;
+      const size_t opLimit   = operation_timeout( timingOf( mPendingOp ) );
+
+      if ( awaitIdle( std::min( userLimit, opLimit ) ) == Aurora::Memory::Status::ERR_OK )
+      {
+        advanceJob();
+      }
+      else if ( opLimit <= userLimit )
+      {
+        completeJob( Aurora::Memory::Status::ERR_TIMEOUT );
+      }
+      else
+      {
+        return Aurora::Memory::Status::ERR_TIMEOUT;
+      }
+    }
+
+    return mJob.result;
+  }
+
+
+  void Driver::sleepFor( const size_t duration )
+  {
+    if ( duration < BUS_RELEASE_THRESHOLD )
+    {
+      Chimera::delayMicroseconds( duration );
+    }
+    else if ( mHoldBus )
+    {
+      Chimera::delayMilliseconds( duration / 1000 );
+    }
+    else
+    {
+      mSPI->unlock();
+      Chimera::delayMilliseconds( duration / 1000 );
+      mSPI->lock();
+    }
   }
 }  // namespace Adesto::AT25
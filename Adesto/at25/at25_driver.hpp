@@ -21,15 +21,30 @@
 #include <Chimera/thread>
 
 /* Adesto Includes */
+#include <Adesto/at25/at25_batch.hpp>
 #include <Adesto/at25/at25_types.hpp>
 #include <Adesto/at25/at25_commands.hpp>
+#include <Adesto/at25/at25_constants.hpp>
+#include <Adesto/at25/at25_traits.hpp>
 
 namespace Adesto::AT25
 {
   class Driver : public virtual Aurora::Memory::IGenericDevice, public Chimera::Threading::Lockable
   {
   public:
+    /**
+     *  Creates a driver that identifies the part in configure()
+     */
     Driver();
+
+    /**
+     *  Creates a driver for a specific part. configure() then only
+     *  verifies the part is the expected one.
+     *
+     *  @param[in]  device      Which part is attached
+     */
+    explicit Driver( const Device device );
+
     ~Driver();
 
     /*-------------------------------------------------
@@ -54,7 +69,9 @@ namespace Adesto::AT25
     -------------------------------------------------*/
     /**
      *  Configures the driver to use the correct settings. Note that
-     *  the SPI instance must be pre-initialized.
+     *  the SPI instance must be pre-initialized. The SFDP tables are
+     *  read here once and cached. Parts missing from the Descriptors
+     *  table are still accepted if their SFDP tables describe them.
      *
      *  @param[in]  channel     Which SPI channel to use.
      *  @return bool
@@ -76,15 +93,479 @@ namespace Adesto::AT25
      */
     uint16_t readStatusRegister();
 
+    /**
+     *  Gets the geometry and timing of the attached part
+     *
+     *  @return const Descriptor *    The descriptor, or nullptr if the part is not known yet
+     */
+    const Descriptor *getDescriptor() const;
+
+    /**
+     *  Gets the properties decoded from the device's SFDP tables
+     *  when the driver was configured
+     *
+     *  @return SFDPInfo        Check the valid flag before use
+     */
+    SFDPInfo getSFDP();
+
+    /**
+     *  Gets the completion times the driver has observed for an
+     *  operation. These are used to tune how long the driver waits
+     *  before polling the device for completion.
+     *
+     *  @param[in]  op          Which operation to look up
+     *  @return OperationStats
+     */
+    OperationStats getOperationStats( const Operation op );
+
+    /**
+     *  Discards all observed completion times, reverting the
+     *  polling behavior back to the datasheet timing.
+     *
+     *  @return void
+     */
+    void resetOperationStats();
+
+    /**
+     *  Configures buffering of small writes. When enabled, writes that land
+     *  in the same page are collected in RAM and programmed as one operation.
+     *  Buffered data is programmed on flush(), when a write targets another
+     *  page, when the pending byte count reaches the threshold, or when
+     *  process() sees it has been pending longer than the timeout.
+     *
+     *  Disabling write-back programs any buffered data first. Data that fails
+     *  to program stays buffered. A timed flush from process() that fails is
+     *  not retried there, and is reported by the next flush().
+     *
+     *  @param[in]  enable      Whether or not to buffer writes
+     *  @param[in]  threshold   Pending bytes that force a flush
+     *  @param[in]  timeout     Milliseconds data may stay pending, or zero for no limit
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status setWriteBack( const bool enable, const size_t threshold = PAGE_SIZE, const size_t timeout = 0 );
+
+    /**
+     *  Configures non-blocking program and erase. When enabled, write(),
+     *  erase() and eraseChip() issue the first command to the device and
+     *  return right away. process() keeps the operation moving one page or
+     *  erase block at a time and reports completion through the callbacks
+     *  registered with onEvent(). pendEvent() may still be used to block
+     *  until the operation is done.
+     *
+     *  The data passed to write() is not copied, so it must stay valid until
+     *  MEM_WRITE_COMPLETE is reported. Writes absorbed by the write-back
+     *  buffer are not affected. Any other call that needs the device waits
+     *  for the operation in progress to finish first.
+     *
+     *  Disabling asynchronous mode waits for the operation in progress.
+     *
+     *  @param[in]  enable      Whether or not to return before operations finish
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status setAsync( const bool enable );
+
+    /**
+     *  Suspends the program or erase in progress so the device will accept
+     *  reads. Reads of the range being modified return undefined data until
+     *  the operation is resumed. Any program, erase or wait on the device
+     *  resumes the operation first.
+     *
+     *  When asynchronous mode is enabled, read() does this on its own for
+     *  reads that don't overlap any part of the erase still to be done.
+     *
+     *  @return Aurora::Memory::Status  ERR_OK if suspended or nothing was in progress
+     */
+    Aurora::Memory::Status suspend();
+
+    /**
+     *  Resumes an operation paused with suspend()
+     *
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status resume();
+
+    /**
+     *  Checks whether an operation is currently suspended
+     *
+     *  @return bool
+     */
+    bool isSuspended();
+
+    /**
+     *  Performs periodic housekeeping, such as flushing buffered writes that
+     *  have aged past their timeout. Intended to be called from a periodic
+     *  thread or timer.
+     *
+     *  In asynchronous mode this also issues the next step of a running
+     *  program or erase once the device is idle, then invokes the onEvent()
+     *  callbacks for anything that finished. Callbacks run without any driver
+     *  locks held and receive the number of bytes completed since their last
+     *  invocation. Because each call advances an operation by at most one
+     *  step, the call rate bounds the asynchronous throughput.
+     *
+     *  @return void
+     */
+    void process();
+
+    /**
+     *  Starts a batch of operations. The driver and SPI locks are acquired
+     *  when the batch is committed and held until its last operation is
+     *  done, so other users of the driver or the SPI bus cannot interleave
+     *  with it.
+     *
+     *  @return Batch
+     */
+    Batch beginBatch();
+
   private:
+    friend class Batch;
+
+    const Descriptor *mDevice;                           /**< Geometry and timing of the attached part */
+    bool mPinned;                                        /**< Whether the part was fixed at construction */
     DeviceInfo mInfo;                                    /**< Device specific details */
     Chimera::SPI::Driver_sPtr mSPI;                      /**< SPI driver instance */
     std::array<uint8_t, Command::MAX_CMD_LEN> cmdBuffer; /**< Buffer for holding a command sequence */
+    std::array<uint8_t, TRANSFER_BUFFER_SIZE> mXferBuffer; /**< Staging buffer for gathered transfers */
+
+    Operation mPendingOp; /**< Last long running operation issued to the device */
+    size_t mOpStartTime;  /**< Time in microseconds the pending operation was issued */
+    std::array<OperationStats, static_cast<size_t>( Operation::NUM_OPTIONS )> mOpStats; /**< Observed timing */
+
+    WriteBack mWB;                            /**< Write-back buffer state */
+    std::array<uint8_t, PAGE_SIZE> mWBBuffer; /**< Write-back buffer page data */
+
+    bool mAsync;              /**< Whether program and erase return before finishing */
+    AsyncJob mJob;            /**< Program or erase running in the background */
+    AsyncNotify mWriteNotify; /**< MEM_WRITE_COMPLETE callback state */
+    AsyncNotify mEraseNotify; /**< MEM_ERASE_COMPLETE callback state */
+
+    bool mHoldBus;       /**< Whether long sleeps keep the SPI bus, as during a batch */
+    bool mSuspended;     /**< Whether the pending operation is suspended */
+    size_t mSuspendTime; /**< Time in microseconds the pending operation was suspended */
+
+    SFDPInfo mSFDP;         /**< Properties read from the SFDP tables */
+    Descriptor mDiscovered; /**< Descriptor built from mSFDP for parts missing from the table */
 
     /*-------------------------------------------------------------------------------
     Private Functions
     -------------------------------------------------------------------------------*/
+    Driver( const Descriptor *const device );
+
+    /**
+     *  Gets the completion times for an operation on the attached part
+     *
+     *  @param[in]  op          Which operation to look up
+     *  @return const OperationTiming &
+     */
+    const OperationTiming &timingOf( const Operation op ) const;
+
+    /**
+     *  Gets the size of an erase chunk on the attached part
+     *
+     *  @param[in]  chunk       Which chunk type to look up
+     *  @return size_t          Size in bytes, or zero if unknown
+     */
+    size_t chunkSizeOf( const Aurora::Memory::Chunk chunk ) const;
+
+    /*-------------------------------------------------
+    Note: The perform*(), issue*() and await*() functions
+    assume the caller already owns both the driver and SPI
+    locks.
+    -------------------------------------------------*/
+
+    /**
+     *  Reads data of any length from the device
+     *
+     *  @param[in]  address     Address to start reading from
+     *  @param[out] data        Where to place the data
+     *  @param[in]  length      Number of bytes to read
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status performRead( const size_t address, void *const data, const size_t length );
+
+    /**
+     *  Programs data of any length and alignment, splitting it at page
+     *  boundaries. Returns once the last page has been programmed, unless
+     *  write-back is enabled and the data was only buffered.
+     *
+     *  @param[in]  address     Address to start writing at
+     *  @param[in]  data        Data to be written
+     *  @param[in]  length      Number of bytes to write
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status performWrite( const size_t address, const void *const data, const size_t length );
+
+    /**
+     *  Programs data of any length and alignment directly to the device,
+     *  bypassing the write-back buffer.
+     *
+     *  @param[in]  address     Address to start writing at
+     *  @param[in]  data        Data to be written
+     *  @param[in]  length      Number of bytes to write
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status programPages( const size_t address, const void *const data, const size_t length );
+
+    /**
+     *  Merges data into the write-back buffer, flushing the buffer whenever
+     *  the data moves to a new page or the pending threshold is reached.
+     *
+     *  @param[in]  address     Address to start writing at
+     *  @param[in]  data        Data to be written
+     *  @param[in]  length      Number of bytes to write
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status bufferWrite( const size_t address, const void *const data, const size_t length );
+
+    /**
+     *  Programs the dirty region of the write-back buffer, if any
+     *
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status flushWriteBack();
+
+    /**
+     *  Erases a range using as few erase commands as possible. Returns
+     *  once the whole range has been erased.
+     *
+     *  @param[in]  address     Address to start erasing at
+     *  @param[in]  length      Number of bytes to erase
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status performErase( const size_t address, const size_t length );
+
+    /**
+     *  Performs a SPI transaction made up of several segments under a
+     *  single chip select assertion. If the whole transaction fits in the
+     *  staging buffer, the segments are gathered into one transfer so that
+     *  only a single completion wait is needed.
+     *
+     *  @param[in]  segments    List of segments to transfer, in order
+     *  @param[in]  count       Number of segments in the list
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t transfer( const Segment *const segments, const size_t count );
+
+    /**
+     *  Sends the write enable command to the device
+     *
+     *  @return void
+     */
     void issueWriteEnable();
+
+    /**
+     *  Reads the status register bytes without acquiring any locks
+     *
+     *  @return uint16_t
+     */
+    uint16_t issueStatusRead();
+
+    /**
+     *  Builds the page program command sequence in the command buffer
+     *  for the given address. The returned length is clipped so that
+     *  the program operation never crosses a page boundary.
+     *
+     *  @param[in]  address     Address to start programming at
+     *  @param[in]  length      Number of bytes remaining to be written
+     *  @return size_t          Number of bytes the staged command may program
+     */
+    size_t stagePageProgram( const size_t address, const size_t length );
+
+    /**
+     *  Transmits the page program command previously built with
+     *  stagePageProgram(), followed by the data payload.
+     *
+     *  @param[in]  data        Data to be programmed
+     *  @param[in]  length      Number of bytes to program
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t issuePageProgram( const void *const data, const size_t length );
+
+    /**
+     *  Builds the erase command sequence in the command buffer, choosing
+     *  the largest erase granularity that is aligned with the address and
+     *  fits inside the remaining range. Falls back to a chip erase when
+     *  the range spans the whole device.
+     *
+     *  @param[in]  address     Address to start erasing at
+     *  @param[in]  length      Number of bytes remaining to be erased
+     *  @param[out] op          Which erase operation was staged
+     *  @return size_t          Number of bytes the staged command erases
+     */
+    size_t stageErase( const size_t address, const size_t length, Operation &op );
+
+    /**
+     *  Transmits the erase command previously built with stageErase()
+     *
+     *  @param[in]  op          Which erase operation was staged
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t issueErase( const Operation op );
+
+    /**
+     *  Suspends the pending operation and waits until the device accepts
+     *  reads. If the operation finished in the meantime, nothing is suspended.
+     *
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status issueSuspend();
+
+    /**
+     *  Resumes the pending operation if it is suspended. Time spent suspended
+     *  is excluded from the operation's completion time.
+     *
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t issueResume();
+
+    /**
+     *  Reads from the SFDP address space
+     *
+     *  @param[in]  address     SFDP address to start reading from
+     *  @param[out] data        Where to place the data
+     *  @param[in]  length      Number of bytes to read
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t issueReadSFDP( const size_t address, void *const data, const size_t length );
+
+    /**
+     *  Reads and decodes the SFDP tables into mSFDP
+     *
+     *  @return bool            Whether a usable table was found
+     */
+    bool discover();
+
+    /**
+     *  Records that a long running operation was just issued to
+     *  the device so that awaitIdle() knows what it is waiting on.
+     *
+     *  @param[in]  op          The operation that was started
+     *  @return void
+     */
+    void startOperation( const Operation op );
+
+    /**
+     *  Waits for the device to finish the pending operation. The
+     *  first check is delayed until the operation is expected to
+     *  be done, after which the poll interval backs off exponentially
+     *  towards the worst case completion time.
+     *
+     *  @param[in]  timeout     How long to wait in milliseconds
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status awaitIdle( const size_t timeout );
+
+    /**
+     *  Starts a background program or erase and issues its first command
+     *
+     *  @param[in]  event       MEM_WRITE_COMPLETE or MEM_ERASE_COMPLETE
+     *  @param[in]  address     Address to start at
+     *  @param[in]  data        Data to program, or nullptr to erase
+     *  @param[in]  length      Number of bytes to program or erase
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status startJob( const Aurora::Memory::Event event, const size_t address, const uint8_t *const data,
+                                     const size_t length );
+
+    /**
+     *  Issues the next command of the background job, or marks the job
+     *  complete if nothing is left. The device must be idle.
+     *
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status advanceJob();
+
+    /**
+     *  Ends the background job and queues its completion notification
+     *
+     *  @param[in]  result      Outcome of the job
+     *  @return void
+     */
+    void completeJob( const Aurora::Memory::Status result );
+
+    /**
+     *  Blocks until the background job, if any, has finished. If the timeout
+     *  expires first the job is left running. If the device takes longer than
+     *  its worst case time for a step, the job is abandoned.
+     *
+     *  @param[in]  timeout     How long to wait in milliseconds
+     *  @return Aurora::Memory::Status
+     */
+    Aurora::Memory::Status awaitJob( const size_t timeout );
+
+    /**
+     *  Puts the calling thread to sleep for the given duration. Long
+     *  sleeps temporarily hand the SPI bus back to other users, unless
+     *  a batch is running.
+     *
+     *  @param[in]  duration    Time to sleep in microseconds
+     *  @return void
+     */
+    void sleepFor( const size_t duration );
+  };
+
+
+  /**
+   *  Driver for a part known at compile time. The checked operations below
+   *  validate their arguments against the part's DeviceTraits with
+   *  static_assert, then hand off to the runtime driver.
+   *
+   *  @tparam D           Which part is attached
+   */
+  template<Device D>
+  class DeviceDriver : public Driver
+  {
+  public:
+    using Traits = DeviceTraits<D>;
+    using Layout = Geometry<D>;
+
+    static_assert( Traits::PAGE_SIZE == PAGE_SIZE, "Driver buffers are sized for the family page size" );
+
+    DeviceDriver() : Driver( D )
+    {
+    }
+
+    /**
+     *  Erases a fixed range, rejecting misaligned or out of range
+     *  arguments at compile time.
+     *
+     *  @tparam Address     Address to start erasing at
+     *  @tparam Length      Number of bytes to erase
+     *  @return Aurora::Memory::Status
+     */
+    template<size_t Address, size_t Length>
+    Aurora::Memory::Status erase()
+    {
+      static_assert( Layout::isEraseAligned( Address, Length ), "Erase range must be aligned to the smallest erase chunk" );
+      static_assert( Layout::inRange( Address, Length ), "Erase range exceeds the device" );
+
+      return Driver::erase( Address, Length );
+    }
+
+    /**
+     *  Erases one page, block or sector by index, rejecting indices
+     *  past the end of the device at compile time.
+     *
+     *  @tparam C           Chunk type
+     *  @tparam Id          Index of the chunk
+     *  @return Aurora::Memory::Status
+     */
+    template<Aurora::Memory::Chunk C, size_t Id>
+    Aurora::Memory::Status erase()
+    {
+      constexpr size_t chunkSize = ( C == Aurora::Memory::Chunk::PAGE )    ? PAGE_SIZE
+                                   : ( C == Aurora::Memory::Chunk::BLOCK ) ? BLOCK_SIZE
+                                   : ( C == Aurora::Memory::Chunk::SECTOR ) ? SECTOR_SIZE
+                                                                            : 0;
+
+      static_assert( chunkSize, "Unsupported erase chunk" );
+      static_assert( ( chunkSize % Traits::ERASE_TYPES[ 0 ].size ) == 0, "Chunk is smaller than the smallest erase" );
+      static_assert( Id < ( Traits::SIZE / chunkSize ), "Chunk index exceeds the device" );
+
+      return Driver::erase( chunkSize * Id, chunkSize );
+    }
+
+    using Driver::erase;
   };
 }  // namespace Adesto::AT25
 
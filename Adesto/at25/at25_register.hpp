@@ -24,6 +24,19 @@ namespace Adesto::AT25::Register
   static constexpr size_t SR_RDY_BUSY_POS = 0;
   static constexpr size_t SR_RDY_BUSY_MSK = 0x01;
   static constexpr size_t SR_RDY_BUSY     = SR_RDY_BUSY_MSK << SR_RDY_BUSY_POS;
+
+  static constexpr size_t SR_WEL_POS = 1;
+  static constexpr size_t SR_WEL_MSK = 0x01;
+  static constexpr size_t SR_WEL     = SR_WEL_MSK << SR_WEL_POS;
+
+  /*-------------------------------------------------------------------------------
+  Status Register Byte 2
+    Positions are within the 16 bit value returned by the
+    driver, which places byte 2 in the upper half.
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t SR_SUS_POS = 15;
+  static constexpr size_t SR_SUS_MSK = 0x01;
+  static constexpr size_t SR_SUS     = SR_SUS_MSK << SR_SUS_POS;
 }  // namespace Adesto::AT25
 
 #endif  /* !ADESTO_AT25_REGISTER_HPP */
@@ -0,0 +1,261 @@
+/********************************************************************************
+ *  File Name:
+ *    at25_sfdp.cpp
+ *
+ *  Description:
+ *    Decoding of the JEDEC Serial Flash Discoverable Parameters (JESD216)
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <utility>
+
+/* Adesto Includes */
+#include <Adesto/at25/at25_commands.hpp>
+#include <Adesto/at25/at25_constants.hpp>
+#include <Adesto/at25/at25_sfdp.hpp>
+#include <Adesto/at25/at25_traits.hpp>
+
+namespace Adesto::AT25::SFDP
+{
+  /*-------------------------------------------------------------------------------
+  Private Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Reads one little endian DWORD from a parameter table
+   *
+   *  @param[in]  table       Start of the table
+   *  @param[in]  index       DWORD number, counting from 1 as the standard does
+   *  @return uint32_t
+   */
+  static uint32_t dword( const uint8_t *const table, const size_t index )
+  {
+    const uint8_t *const ptr = table + ( ( index - 1 ) * sizeof( uint32_t ) );
+    return static_cast<uint32_t>( ptr[ 0 ] ) | ( static_cast<uint32_t>( ptr[ 1 ] ) << 8 ) |
+           ( static_cast<uint32_t>( ptr[ 2 ] ) << 16 ) | ( static_cast<uint32_t>( ptr[ 3 ] ) << 24 );
+  }
+
+
+  static constexpr uint32_t field( const uint32_t value, const size_t pos, const size_t width )
+  {
+    return ( value >> pos ) & ( ( 1u << width ) - 1u );
+  }
+
+
+  /**
+   *  Decodes the 16 bit instruction description used by DWORDs 3 and 4
+   *
+   *  @param[in]  supported   Support flag from DWORD 1
+   *  @param[in]  params      Opcode [15:8], mode clocks [7:5] and dummy clocks [4:0]
+   *  @return ReadModeInfo
+   */
+  static ReadModeInfo decodeReadMode( const bool supported, const uint32_t params )
+  {
+    ReadModeInfo mode;
+    mode.opcode      = static_cast<uint8_t>( field( params, 8, 8 ) );
+    mode.modeClocks  = static_cast<uint8_t>( field( params, 5, 3 ) );
+    mode.dummyClocks = static_cast<uint8_t>( field( params, 0, 5 ) );
+    mode.supported   = supported && ( mode.opcode != 0 );
+
+    return mode;
+  }
+
+
+  /**
+   *  Maps an erase size onto the timing slot the driver tracks it in
+   *
+   *  @param[in]  size        Bytes erased by the instruction
+   *  @return Operation       NONE if the driver has no slot for the size
+   */
+  static Operation eraseSlot( const size_t size )
+  {
+    switch ( size )
+    {
+      case CHUNK_SIZE_4K:
+        return Operation::ERASE_4K;
+
+      case CHUNK_SIZE_32K:
+        return Operation::ERASE_32K;
+
+      case CHUNK_SIZE_64K:
+        return Operation::ERASE_64K;
+
+      default:
+        return Operation::NONE;
+    }
+  }
+
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  bool parseHeader( const uint8_t *const data, size_t &address, size_t &dwords )
+  {
+    if ( !data || ( dword( data, 1 ) != SIGNATURE ) )
+    {
+      return false;
+    }
+
+    /*-------------------------------------------------
+    The first parameter header always describes the
+    basic table: ID [0], revision [2:1], length [3] and
+    a 24 bit table pointer [6:4].
+    -------------------------------------------------*/
+    const uint8_t *const param = data + HEADER_LEN;
+    if ( param[ 0 ] != BASIC_TABLE_ID )
+    {
+      return false;
+    }
+
+    dwords  = param[ 3 ];
+    address = static_cast<size_t>( param[ 4 ] ) | ( static_cast<size_t>( param[ 5 ] ) << 8 ) |
+              ( static_cast<size_t>( param[ 6 ] ) << 16 );
+
+    return dwords >= BASIC_TABLE_MIN_DW;
+  }
+
+
+  bool parseBasicTable( const uint8_t *const table, const size_t dwords, SFDPInfo &info )
+  {
+    info = {};
+    if ( !table || ( dwords < BASIC_TABLE_MIN_DW ) )
+    {
+      return false;
+    }
+
+    const uint32_t dw1 = dword( table, 1 );
+    const uint32_t dw2 = dword( table, 2 );
+    const uint32_t dw3 = dword( table, 3 );
+    const uint32_t dw4 = dword( table, 4 );
+
+    /*-------------------------------------------------
+    Density: either N+1 bits, or 2^N bits when the MSB
+    is set.
+    -------------------------------------------------*/
+    if ( dw2 & 0x80000000u )
+    {
+      const uint32_t exponent = dw2 & 0x7FFFFFFFu;
+      if ( ( exponent < 3 ) || ( exponent >= ( 8 * sizeof( size_t ) + 3 ) ) )
+      {
+        return false;
+      }
+
+      info.size = static_cast<size_t>( 1 ) << ( exponent - 3 );
+    }
+    else
+    {
+      info.size = ( static_cast<size_t>( dw2 ) + 1 ) / 8;
+    }
+
+    /*-------------------------------------------------
+    Address width. Parts that offer both 3 and 4 byte
+    modes power up using 3 bytes.
+    -------------------------------------------------*/
+    info.addressBytes = ( field( dw1, 17, 2 ) == 2 ) ? 4 : 3;
+
+    /*-------------------------------------------------
+    Read instructions. The single line fast read is
+    assumed by the standard and isn't described. The
+    multi-I/O parameters are kept for reference, the
+    read path doesn't use them.
+    -------------------------------------------------*/
+    auto &modes = info.readModes;
+
+    modes[ static_cast<size_t>( ReadMode::SINGLE_1_1_1 ) ] = { true, Command::READ_ARRAY_HS, 0, 8 };
+    modes[ static_cast<size_t>( ReadMode::DUAL_1_1_2 ) ]   = decodeReadMode( field( dw1, 16, 1 ), field( dw4, 0, 16 ) );
+    modes[ static_cast<size_t>( ReadMode::DUAL_1_2_2 ) ]   = decodeReadMode( field( dw1, 20, 1 ), field( dw4, 16, 16 ) );
+    modes[ static_cast<size_t>( ReadMode::QUAD_1_1_4 ) ]   = decodeReadMode( field( dw1, 22, 1 ), field( dw3, 16, 16 ) );
+    modes[ static_cast<size_t>( ReadMode::QUAD_1_4_4 ) ]   = decodeReadMode( field( dw1, 21, 1 ), field( dw3, 0, 16 ) );
+
+    /*-------------------------------------------------
+    Timing. Start from the family values scaled to this
+    capacity, then take whatever the table provides.
+    -------------------------------------------------*/
+    const bool hasTiming = ( dwords >= 11 );
+    const uint32_t dw10  = hasTiming ? dword( table, 10 ) : 0;
+    const uint32_t dw11  = hasTiming ? dword( table, 11 ) : 0;
+
+    info.timing   = familyTiming( info.size );
+    info.pageSize = PAGE_SIZE;
+
+    if ( hasTiming )
+    {
+      /*-------------------------------------------------
+      DWORD 11: the max time for program and chip erase is
+      2 * (N + 1) times the typical value. Page program is
+      counted in 8us or 64us units, chip erase in 16ms,
+      256ms, 4s or 64s units.
+      -------------------------------------------------*/
+      static constexpr std::array<size_t, 4> chipUnits = { 16000, 256000, 4000000, 64000000 };
+
+      const size_t multiplier = 2 * ( field( dw11, 0, 4 ) + 1 );
+      const size_t program    = ( field( dw11, 8, 5 ) + 1 ) * ( field( dw11, 13, 1 ) ? 64 : 8 );
+      const size_t chip       = ( field( dw11, 24, 5 ) + 1 ) * chipUnits[ field( dw11, 29, 2 ) ];
+
+      info.pageSize = static_cast<size_t>( 1 ) << field( dw11, 4, 4 );
+      info.timing[ static_cast<size_t>( Operation::PAGE_PROGRAM ) ] = { program, program * multiplier };
+      info.timing[ static_cast<size_t>( Operation::ERASE_CHIP ) ]   = { chip, chip * multiplier };
+    }
+
+    /*-------------------------------------------------
+    Erase types: four (size exponent, opcode) pairs in
+    DWORDs 8 and 9. DWORD 10 holds a shared max time
+    multiplier [3:0] and a 7 bit typical time for each
+    type, counted in 1ms, 16ms, 128ms or 1s units.
+    -------------------------------------------------*/
+    static constexpr std::array<size_t, 4> eraseUnits = { 1000, 16000, 128000, 1000000 };
+
+    const size_t eraseMultiplier = 2 * ( field( dw10, 0, 4 ) + 1 );
+
+    for ( size_t idx = 0; idx < info.eraseTypes.size(); idx++ )
+    {
+      const uint32_t pair     = field( dword( table, 8 + ( idx / 2 ) ), 16 * ( idx % 2 ), 16 );
+      const uint32_t exponent = field( pair, 0, 8 );
+      const uint8_t opcode    = static_cast<uint8_t>( field( pair, 8, 8 ) );
+
+      if ( ( exponent == 0 ) || ( exponent >= ( 8 * sizeof( size_t ) ) ) )
+      {
+        continue;
+      }
+
+      const size_t size  = static_cast<size_t>( 1 ) << exponent;
+      const Operation op = eraseSlot( size );
+      if ( op == Operation::NONE )
+      {
+        continue;
+      }
+
+      if ( hasTiming )
+      {
+        const uint32_t time  = field( dw10, 4 + ( 7 * idx ), 7 );
+        const size_t typical = ( field( time, 0, 5 ) + 1 ) * eraseUnits[ field( time, 5, 2 ) ];
+
+        info.timing[ static_cast<size_t>( op ) ] = { typical, typical * eraseMultiplier };
+      }
+
+      info.eraseTypes[ info.numEraseTypes++ ] = { size, opcode, op };
+    }
+
+    /*-------------------------------------------------
+    The erase planner expects the smallest type first
+    -------------------------------------------------*/
+    for ( size_t x = 1; x < info.numEraseTypes; x++ )
+    {
+      for ( size_t y = x; ( y > 0 ) && ( info.eraseTypes[ y - 1 ].size > info.eraseTypes[ y ].size ); y-- )
+      {
+        std::swap( info.eraseTypes[ y - 1 ], info.eraseTypes[ y ] );
+      }
+    }
+
+    /*-------------------------------------------------
+    Commands are built with 3 address bytes, so anything
+    needing more than that can't be driven.
+    -------------------------------------------------*/
+    info.valid = ( info.addressBytes == 3 ) && info.size && ( info.size <= ( static_cast<size_t>( 1 ) << 24 ) ) &&
+                 info.numEraseTypes && info.pageSize;
+    return info.valid;
+  }
+
+}  // namespace Adesto::AT25::SFDP
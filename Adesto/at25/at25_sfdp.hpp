@@ -0,0 +1,61 @@
+/********************************************************************************
+ *  File Name:
+ *    at25_sfdp.hpp
+ *
+ *  Description:
+ *    Decoding of the JEDEC Serial Flash Discoverable Parameters (JESD216)
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+#pragma once
+#ifndef ADESTO_AT25_SFDP_HPP
+#define ADESTO_AT25_SFDP_HPP
+
+/* STL Includes */
+#include <cstddef>
+#include <cstdint>
+
+/* Adesto Includes */
+#include <Adesto/at25/at25_types.hpp>
+
+namespace Adesto::AT25::SFDP
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint32_t SIGNATURE        = 0x50444653; /**< "SFDP", read as a little endian word */
+  static constexpr size_t HEADER_LEN         = 8;          /**< SFDP header length in bytes */
+  static constexpr size_t PARAM_HEADER_LEN   = 8;          /**< Parameter header length in bytes */
+  static constexpr uint8_t BASIC_TABLE_ID    = 0x00;       /**< Parameter ID LSB of the Basic Flash Parameter Table */
+  static constexpr size_t BASIC_TABLE_MIN_DW = 9;          /**< DWORDs defined by the original JESD216 */
+  static constexpr size_t BASIC_TABLE_MAX_DW = 16;         /**< DWORDs decoded by the driver (JESD216A/B) */
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Checks the SFDP header and the first parameter header, which the
+   *  standard requires to be the Basic Flash Parameter Table.
+   *
+   *  @param[in]  data        HEADER_LEN + PARAM_HEADER_LEN bytes read from SFDP address 0
+   *  @param[out] address     SFDP address of the basic table
+   *  @param[out] dwords      Length of the basic table in DWORDs
+   *  @return bool
+   */
+  bool parseHeader( const uint8_t *const data, size_t &address, size_t &dwords );
+
+  /**
+   *  Decodes the Basic Flash Parameter Table. Timing fields only exist in
+   *  JESD216A and later, so older tables fall back on the AT25SF081 values.
+   *
+   *  @param[in]  table       Table contents as read from the device
+   *  @param[in]  dwords      Number of DWORDs available in table
+   *  @param[out] info        Decoded properties
+   *  @return bool            Whether the table describes a part the driver can operate
+   */
+  bool parseBasicTable( const uint8_t *const table, const size_t dwords, SFDPInfo &info );
+
+}  // namespace Adesto::AT25::SFDP
+
+#endif /* !ADESTO_AT25_SFDP_HPP */
@@ -0,0 +1,192 @@
+/********************************************************************************
+ *  File Name:
+ *    at25_traits.hpp
+ *
+ *  Description:
+ *    Compile time descriptions of the supported AT25 devices
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+#pragma once
+#ifndef ADESTO_AT25_TRAITS_HPP
+#define ADESTO_AT25_TRAITS_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Adesto Includes */
+#include <Adesto/common.hpp>
+#include <Adesto/at25/at25_commands.hpp>
+#include <Adesto/at25/at25_constants.hpp>
+#include <Adesto/at25/at25_types.hpp>
+
+namespace Adesto::AT25
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t MBIT = ( 1024 * 1024 ) / 8; /**< Bytes in one megabit */
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Builds the timing table for a member of the family. Page program and
+   *  block erase follow the AT25SF081 datasheet values in OperationTimes,
+   *  while chip erase is scaled by capacity relative to the 8Mbit part.
+   *
+   *  @param[in]  size        Capacity of the part in bytes
+   *  @return std::array<OperationTiming, static_cast<size_t>( Operation::NUM_OPTIONS )>
+   */
+  constexpr std::array<OperationTiming, static_cast<size_t>( Operation::NUM_OPTIONS )> familyTiming( const size_t size )
+  {
+    auto timing = OperationTimes;
+    auto &chip  = timing[ static_cast<size_t>( Operation::ERASE_CHIP ) ];
+
+    chip.typical = ( chip.typical / 2 ) * ( size / ( 4 * MBIT ) );
+    chip.maximum = ( chip.maximum / 2 ) * ( size / ( 4 * MBIT ) );
+    return timing;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Device Traits
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Properties shared by every member of the AT25SF family
+   */
+  struct AT25SFTraits
+  {
+    static constexpr size_t PAGE_SIZE     = CHUNK_SIZE_256;
+    static constexpr size_t ADDRESS_BYTES = 3;
+
+    static constexpr std::array<EraseType, 3> ERASE_TYPES = { {
+      { CHUNK_SIZE_4K, Command::BLOCK_ERASE_4K, Operation::ERASE_4K },
+      { CHUNK_SIZE_32K, Command::BLOCK_ERASE_32K, Operation::ERASE_32K },
+      { CHUNK_SIZE_64K, Command::BLOCK_ERASE_64K, Operation::ERASE_64K },
+    } };
+
+    static constexpr std::array<ReadModeInfo, static_cast<size_t>( ReadMode::NUM_OPTIONS )> READ_MODES = { {
+      { true, Command::READ_ARRAY_HS, 0, 8 }, /* SINGLE_1_1_1 */
+      { false, 0, 0, 0 },                     /* DUAL_1_1_2 */
+      { false, 0, 0, 0 },                     /* DUAL_1_2_2 */
+      { false, 0, 0, 0 },                     /* QUAD_1_1_4 */
+      { false, 0, 0, 0 },                     /* QUAD_1_4_4 */
+    } };
+  };
+
+  /**
+   *  Per part geometry and timing. Each specialization provides the JEDEC
+   *  identifier, the capacity and the operation timing on top of the family
+   *  properties.
+   *
+   *  @tparam D           Which part to describe
+   */
+  template<Device D>
+  struct DeviceTraits;
+
+  template<>
+  struct DeviceTraits<Device::AT25SF041> : public AT25SFTraits
+  {
+    static constexpr uint32_t JEDEC_ID = 0x001F8401;
+    static constexpr size_t SIZE       = 4 * MBIT;
+    static constexpr auto TIMING       = familyTiming( SIZE );
+  };
+
+  template<>
+  struct DeviceTraits<Device::AT25SF081> : public AT25SFTraits
+  {
+    static constexpr uint32_t JEDEC_ID = 0x001F8501;
+    static constexpr size_t SIZE       = 8 * MBIT;
+    static constexpr auto TIMING       = familyTiming( SIZE );
+  };
+
+  template<>
+  struct DeviceTraits<Device::AT25SF161> : public AT25SFTraits
+  {
+    static constexpr uint32_t JEDEC_ID = 0x001F8601;
+    static constexpr size_t SIZE       = 16 * MBIT;
+    static constexpr auto TIMING       = familyTiming( SIZE );
+  };
+
+  template<>
+  struct DeviceTraits<Device::AT25SF321> : public AT25SFTraits
+  {
+    static constexpr uint32_t JEDEC_ID = 0x001F8701;
+    static constexpr size_t SIZE       = 32 * MBIT;
+    static constexpr auto TIMING       = familyTiming( SIZE );
+  };
+
+  template<>
+  struct DeviceTraits<Device::AT25SF641> : public AT25SFTraits
+  {
+    static constexpr uint32_t JEDEC_ID = 0x001F3217;
+    static constexpr size_t SIZE       = 64 * MBIT;
+    static constexpr auto TIMING       = familyTiming( SIZE );
+  };
+
+  /**
+   *  Compile time argument checks for a part. These only back the checked
+   *  API in DeviceDriver; the driver core does its page and erase math at
+   *  runtime from the Descriptor, so that SFDP discovered parts share it.
+   *
+   *  @tparam D           Which part to describe
+   */
+  template<Device D>
+  struct Geometry
+  {
+    using Traits = DeviceTraits<D>;
+
+    static_assert( ( Traits::PAGE_SIZE & ( Traits::PAGE_SIZE - 1 ) ) == 0, "Page size must be a power of two" );
+    static_assert( ( Traits::SIZE % Traits::PAGE_SIZE ) == 0, "Capacity must be a whole number of pages" );
+    static_assert( ( Traits::SIZE - 1 ) < ( size_t( 1 ) << ( 8 * Traits::ADDRESS_BYTES ) ), "Capacity exceeds address width" );
+
+    static constexpr bool inRange( const size_t address, const size_t length )
+    {
+      return ( address < Traits::SIZE ) && ( length <= ( Traits::SIZE - address ) );
+    }
+
+    static constexpr bool isEraseAligned( const size_t address, const size_t length )
+    {
+      return length && ( ( address & ( Traits::ERASE_TYPES[ 0 ].size - 1 ) ) == 0 )
+             && ( ( length & ( Traits::ERASE_TYPES[ 0 ].size - 1 ) ) == 0 );
+    }
+  };
+
+  /**
+   *  Builds the runtime descriptor for a part from its traits
+   *
+   *  @tparam D           Which part to describe
+   *  @return Descriptor
+   */
+  template<Device D>
+  constexpr Descriptor describe()
+  {
+    using Traits = DeviceTraits<D>;
+    return { D,
+             Traits::JEDEC_ID,
+             Traits::SIZE,
+             Traits::PAGE_SIZE,
+             Traits::ADDRESS_BYTES,
+             Traits::ERASE_TYPES.data(),
+             Traits::ERASE_TYPES.size(),
+             Traits::READ_MODES.data(),
+             Traits::TIMING.data() };
+  }
+
+  /*-------------------------------------------------
+  Descriptors for every supported part, indexed by the
+  Device enum. This MUST be kept in the same order.
+  -------------------------------------------------*/
+  static constexpr std::array<Descriptor, static_cast<size_t>( Device::NUM_OPTIONS )> Descriptors = { {
+    describe<Device::AT25SF041>(),
+    describe<Device::AT25SF081>(),
+    describe<Device::AT25SF161>(),
+    describe<Device::AT25SF321>(),
+    describe<Device::AT25SF641>(),
+  } };
+}  // namespace Adesto::AT25
+
+#endif /* !ADESTO_AT25_TRAITS_HPP */
@@ -13,9 +13,13 @@
 #define ADESTO_AT25_TYPES_HPP
 
 /* STL Includes */
+#include <array>
 #include <cstddef>
 #include <memory>
 
+/* Aurora Includes */
+#include <Aurora/memory>
+
 /* Adesto Includes */
 #include <Adesto/common.hpp>
 
@@ -24,6 +28,7 @@ namespace Adesto::AT25
   /*-------------------------------------------------------------------------------
   Forward Declarations
   -------------------------------------------------------------------------------*/
+  class Batch;
   class Driver;
 
   /*-------------------------------------------------------------------------------
@@ -31,10 +36,59 @@ namespace Adesto::AT25
   -------------------------------------------------------------------------------*/
   using Driver_sPtr = std::shared_ptr<Driver>;
 
+  using EventCallback = void ( * )( const size_t ); /**< Completion callback registered with onEvent() */
+
 
   /*-------------------------------------------------------------------------------
   Enumerations
   -------------------------------------------------------------------------------*/
+  /**
+   *  Long running operations the device may be busy with. Used to
+   *  decide how the driver waits for the RDY/BSY flag to clear.
+   */
+  enum class Operation : uint8_t
+  {
+    NONE,
+    PAGE_PROGRAM,
+    ERASE_4K,
+    ERASE_32K,
+    ERASE_64K,
+    ERASE_CHIP,
+
+    NUM_OPTIONS
+  };
+
+  /**
+   *  Parts in the AT25SF family the driver knows the geometry and timing of
+   */
+  enum class Device : uint8_t
+  {
+    AT25SF041,
+    AT25SF081,
+    AT25SF161,
+    AT25SF321,
+    AT25SF641,
+
+    NUM_OPTIONS,
+    UNKNOWN /**< Part described only by its SFDP tables */
+  };
+
+  /**
+   *  Array read instructions, named by the number of I/O lines used
+   *  for the command, address and data phases respectively. The driver
+   *  only issues SINGLE_1_1_1 since its SPI transport drives one data
+   *  line; the others are recorded from the traits or SFDP table only.
+   */
+  enum class ReadMode : uint8_t
+  {
+    SINGLE_1_1_1,
+    DUAL_1_1_2,
+    DUAL_1_2_2,
+    QUAD_1_1_4,
+    QUAD_1_4_4,
+
+    NUM_OPTIONS
+  };
 
 
   /*-------------------------------------------------------------------------------
@@ -42,12 +96,146 @@ namespace Adesto::AT25
   -------------------------------------------------------------------------------*/
   struct DeviceInfo
   {
+    uint32_t jedecID; /**< Full identifier as it would appear shifted out in MSB mode */
     Jedec_t mfgID;
     FamilyCode family;
     DensityCode density;
     SubCode sub;
     ProductVariant variant;
   };
+
+  /**
+   *  Describes one piece of a SPI transaction. A list of segments is
+   *  clocked out back to back under a single chip select assertion.
+   */
+  struct Segment
+  {
+    const void *tx; /**< Data to transmit, or nullptr to clock out dummy bytes */
+    void *rx;       /**< Where to store received data, or nullptr to discard it */
+    size_t length;  /**< Number of bytes in this segment */
+  };
+
+  /**
+   *  State of the RAM buffer used to coalesce small writes into a
+   *  single page program.
+   */
+  struct WriteBack
+  {
+    bool enabled;     /**< Whether writes are buffered at all */
+    bool dirty;       /**< Whether the buffer holds data not yet programmed */
+    size_t page;      /**< Page index the buffer maps to */
+    size_t low;       /**< First dirty byte offset within the page */
+    size_t high;      /**< One past the last dirty byte offset within the page */
+    size_t pending;   /**< Bytes written into the buffer since the last flush */
+    size_t threshold; /**< Flush once this many bytes are pending */
+    size_t timeout;   /**< Flush once data has been pending this many milliseconds. Zero disables. */
+    size_t dirtyTime; /**< Time in milliseconds the buffer first became dirty */
+
+    Aurora::Memory::Status error; /**< Failure of a timed flush from process(), reported by the next flush() */
+  };
+
+  /**
+   *  Completion time limits for an operation, in microseconds
+   */
+  struct OperationTiming
+  {
+    size_t typical; /**< Typical time to complete */
+    size_t maximum; /**< Worst case time to complete */
+  };
+
+  /**
+   *  Completion times observed by the driver for an operation,
+   *  in microseconds.
+   */
+  struct OperationStats
+  {
+    size_t samples; /**< Number of completions observed */
+    size_t learned; /**< Running estimate of the completion time */
+    size_t minimum; /**< Fastest completion seen */
+    size_t maximum; /**< Slowest completion seen */
+  };
+
+  /**
+   *  One of the erase instructions a part supports
+   */
+  struct EraseType
+  {
+    size_t size;    /**< Bytes erased by the instruction */
+    uint8_t opcode; /**< Instruction opcode */
+    Operation op;   /**< Which timing and statistics slot the erase uses */
+  };
+
+  /**
+   *  How to issue one of the array read instructions
+   */
+  struct ReadModeInfo
+  {
+    bool supported;      /**< Whether the part implements this mode */
+    uint8_t opcode;      /**< Instruction opcode */
+    uint8_t modeClocks;  /**< Mode bit clocks following the address */
+    uint8_t dummyClocks; /**< Wait state clocks before data is returned */
+  };
+
+  /**
+   *  Runtime copy of a part's DeviceTraits, selected once when the
+   *  device is identified so that no operation has to look it up again.
+   */
+  struct Descriptor
+  {
+    Device device;                 /**< Which part this describes */
+    uint32_t jedecID;              /**< Identifier as it would appear shifted out in MSB mode */
+    size_t size;                   /**< Capacity in bytes */
+    size_t pageSize;               /**< Largest single program operation */
+    size_t addressBytes;           /**< Address bytes sent with each command */
+    const EraseType *eraseTypes;   /**< Erase instructions, smallest first */
+    size_t numEraseTypes;          /**< Number of entries in eraseTypes */
+    const ReadModeInfo *readModes; /**< Read instructions, indexed by ReadMode */
+    const OperationTiming *timing; /**< Completion times, indexed by Operation */
+  };
+
+  /**
+   *  Device properties read from the JEDEC Basic Flash Parameter Table.
+   *  Only erase types the driver can plan with are kept.
+   */
+  struct SFDPInfo
+  {
+    bool valid;                                                                        /**< Whether a usable table was found */
+    size_t size;                                                                       /**< Capacity in bytes */
+    size_t pageSize;                                                                   /**< Program page size in bytes */
+    size_t addressBytes;                                                               /**< Address bytes sent with each command */
+    std::array<EraseType, 4> eraseTypes;                                               /**< Erase instructions, smallest first */
+    size_t numEraseTypes;                                                              /**< Number of valid entries in eraseTypes */
+    std::array<ReadModeInfo, static_cast<size_t>( ReadMode::NUM_OPTIONS )> readModes;  /**< Read instructions, indexed by ReadMode */
+    std::array<OperationTiming, static_cast<size_t>( Operation::NUM_OPTIONS )> timing; /**< Completion times, indexed by Operation */
+  };
+
+  /**
+   *  Progress of a program or erase that was started without waiting
+   *  for it to finish. The driver issues one page program or erase
+   *  command at a time, continuing with the next once the device
+   *  reports the previous one done.
+   */
+  struct AsyncJob
+  {
+    bool active;                   /**< Whether the job still has commands in flight or left to issue */
+    Aurora::Memory::Event event;   /**< Event reported when the job finishes */
+    const uint8_t *data;           /**< Next byte to program, or nullptr for an erase */
+    size_t address;                /**< Address the next command starts at */
+    size_t stepAddress;            /**< Address the command in flight started at */
+    size_t stepLength;             /**< Bytes covered by the command in flight */
+    size_t remaining;              /**< Bytes not yet handed to the device */
+    size_t length;                 /**< Total bytes in the job */
+    Aurora::Memory::Status result; /**< Outcome of the job once it is no longer active */
+  };
+
+  /**
+   *  Completion notifications waiting to be delivered by process()
+   */
+  struct AsyncNotify
+  {
+    EventCallback callback; /**< User function to invoke, or nullptr */
+    size_t pending;         /**< Bytes completed since the callback last ran */
+  };
 }  // namespace Adesto::AT25
 
 #endif /* !ADESTO_AT25_TYPES_HPP */
@@ -0,0 +1,492 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_at25.cpp
+ *
+ *  Description:
+ *    Behavioral simulation of an AT25SF081 for running the driver off target
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <cstring>
+
+/* Adesto Includes */
+#include <Adesto/at25/at25_commands.hpp>
+#include <Adesto/at25/at25_register.hpp>
+
+/* Test Includes */
+#include "sim_at25.hpp"
+
+namespace Adesto::AT25
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t SIM_DEVICE_SIZE = 1024 * 1024; /**< AT25SF081, 8Mbit */
+
+  /*-------------------------------------------------
+  JEDEC ID bytes in the order they are shifted out
+  -------------------------------------------------*/
+  static constexpr std::array<uint8_t, Command::READ_DEV_INFO_RSP_LEN> SIM_JEDEC_ID = { 0x1F, 0x85, 0x01 };
+
+  static constexpr uint8_t SIM_DUMMY_BYTE = 0xFF;
+
+  /*-------------------------------------------------
+  SFDP space: the header and a single parameter header
+  at address 0 pointing at the basic table. Values are
+  taken from the AT25SF081 datasheet, rounded to what
+  the JESD216B encodings can express. The multi-I/O
+  reads are advertised because the part has them, but
+  the driver never issues them: its SPI transport only
+  clocks a single data line.
+  -------------------------------------------------*/
+  static constexpr size_t SIM_SFDP_TABLE = 0x30;
+
+  static constexpr std::array<uint8_t, 16> SIM_SFDP_HEADER = {
+    'S', 'F', 'D', 'P', 0x06, 0x01, 0x00, 0xFF,               /* Revision 1.6, one parameter header */
+    0x00, 0x06, 0x01, 0x10, SIM_SFDP_TABLE, 0x00, 0x00, 0xFF, /* Basic table, revision 1.6, 16 DWORDs */
+  };
+
+  static constexpr std::array<uint32_t, 16> SIM_SFDP_BASIC = { {
+    0xFFF12005, /* 4kB erase 0x20, multi-I/O reads advertised (unused), 3 byte addresses */
+    0x007FFFFF, /* 8Mbit */
+    0x6B08EB44, /* Quad read parameters, decoded but not issued */
+    0xBB803B08, /* Dual read parameters, decoded but not issued */
+    0xFFFFFFEE, /* No 2-2-2 or 4-4-4 */
+    0x0000FFFF,
+    0x0000FFFF,
+    0x520F200C, /* 4kB 0x20, 32kB 0x52 */
+    0x0000D810, /* 64kB 0xD8 */
+    0x0111AA32, /* Erase typical 64ms, 352ms, 640ms, max 6x */
+    0xC2002685, /* 256 byte pages, program 448us, chip erase 12s, max 12x */
+    0xFFFFFFFF,
+    0xFFFFFFFF,
+    0xFFFFFFFF,
+    0xFFFFFFFF,
+    0xFFFFFFFF,
+  } };
+
+  /*-------------------------------------------------------------------------------
+  Private Functions
+  -------------------------------------------------------------------------------*/
+  static uint8_t sfdp_byte( const size_t address )
+  {
+    if ( address < SIM_SFDP_HEADER.size() )
+    {
+      return SIM_SFDP_HEADER[ address ];
+    }
+
+    const size_t offset = address - SIM_SFDP_TABLE;
+    if ( ( address >= SIM_SFDP_TABLE ) && ( offset < ( SIM_SFDP_BASIC.size() * sizeof( uint32_t ) ) ) )
+    {
+      return static_cast<uint8_t>( SIM_SFDP_BASIC[ offset / sizeof( uint32_t ) ] >> ( 8 * ( offset % sizeof( uint32_t ) ) ) );
+    }
+
+    return SIM_DUMMY_BYTE;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Simulator Implementation
+  -------------------------------------------------------------------------------*/
+  Simulator::Simulator() : mMemory( SIM_DEVICE_SIZE ), mTime( Chimera::micros ), mStats( {} ), mJedecID( SIM_JEDEC_ID )
+  {
+    for ( size_t x = 0; x < mOpTime.size(); x++ )
+    {
+      mOpTime[ x ] = OperationTimes[ x ].typical;
+    }
+
+    reset();
+  }
+
+
+  Simulator::~Simulator()
+  {
+  }
+
+
+  Chimera::Status_t Simulator::setChipSelect( const Chimera::GPIO::State value )
+  {
+    if ( value == Chimera::GPIO::State::LOW )
+    {
+      if ( !mSelected )
+      {
+        mSelected     = true;
+        mOpcode       = 0;
+        mByteIdx      = 0;
+        mAddress      = 0;
+        mProgramCount = 0;
+        mIgnore       = false;
+        mStats.transactions++;
+      }
+    }
+    else if ( mSelected )
+    {
+      mSelected = false;
+      execute();
+    }
+
+    return Chimera::Status::OK;
+  }
+
+
+  Chimera::Status_t Simulator::writeBytes( const void *const txBuffer, const size_t length )
+  {
+    return readWriteBytes( txBuffer, nullptr, length );
+  }
+
+
+  Chimera::Status_t Simulator::readBytes( void *const rxBuffer, const size_t length )
+  {
+    return readWriteBytes( nullptr, rxBuffer, length );
+  }
+
+
+  Chimera::Status_t Simulator::readWriteBytes( const void *const txBuffer, void *const rxBuffer, const size_t length )
+  {
+    auto tx = reinterpret_cast<const uint8_t *>( txBuffer );
+    auto rx = reinterpret_cast<uint8_t *>( rxBuffer );
+
+    for ( size_t idx = 0; idx < length; idx++ )
+    {
+      const uint8_t out = exchange( tx ? tx[ idx ] : SIM_DUMMY_BYTE );
+
+      if ( rx )
+      {
+        rx[ idx ] = out;
+      }
+    }
+
+    return Chimera::Status::OK;
+  }
+
+
+  void Simulator::setOperationTime( const Operation op, const size_t duration )
+  {
+    if ( op < Operation::NUM_OPTIONS )
+    {
+      mOpTime[ static_cast<size_t>( op ) ] = duration;
+    }
+  }
+
+
+  void Simulator::setTimeSource( SimTimeSource source )
+  {
+    mTime = source ? source : Chimera::micros;
+  }
+
+
+  void Simulator::setJedecID( const uint32_t jedecID )
+  {
+    mJedecID[ 0 ] = static_cast<uint8_t>( jedecID >> 16 );
+    mJedecID[ 1 ] = static_cast<uint8_t>( jedecID >> 8 );
+    mJedecID[ 2 ] = static_cast<uint8_t>( jedecID );
+  }
+
+
+  void Simulator::reset()
+  {
+    std::fill( mMemory.begin(), mMemory.end(), 0xFF );
+
+    mSelected     = false;
+    mWriteEnabled = false;
+    mBusyStart    = 0;
+    mBusyDuration = 0;
+    mSuspended    = false;
+    mSuspendLeft  = 0;
+    mOpcode       = 0;
+    mByteIdx      = 0;
+    mAddress      = 0;
+    mIgnore       = false;
+    mProgramCount = 0;
+  }
+
+
+  bool Simulator::busy()
+  {
+    if ( mBusyDuration && ( ( mTime() - mBusyStart ) >= mBusyDuration ) )
+    {
+      /*-------------------------------------------------
+      The WEL bit is cleared once the operation completes
+      -------------------------------------------------*/
+      mBusyDuration = 0;
+      mWriteEnabled = false;
+    }
+
+    return mBusyDuration != 0;
+  }
+
+
+  uint8_t *Simulator::memory()
+  {
+    return mMemory.data();
+  }
+
+
+  size_t Simulator::size() const
+  {
+    return mMemory.size();
+  }
+
+
+  SimStats Simulator::getStats() const
+  {
+    return mStats;
+  }
+
+
+  void Simulator::resetStats()
+  {
+    mStats = {};
+  }
+
+
+  uint8_t Simulator::exchange( const uint8_t tx )
+  {
+    if ( !mSelected )
+    {
+      return SIM_DUMMY_BYTE;
+    }
+
+    mStats.bytesClocked++;
+    const size_t idx = mByteIdx++;
+
+    /*-------------------------------------------------
+    First byte is always the opcode. While busy, the
+    device only responds to status register reads.
+    -------------------------------------------------*/
+    if ( idx == 0 )
+    {
+      mOpcode = tx;
+      mIgnore = busy() && ( tx != Command::READ_SR_BYTE1 ) && ( tx != Command::READ_SR_BYTE2 )
+                && ( tx != Command::PROGRAM_ERASE_SUSPEND );
+
+      if ( ( tx == Command::READ_SR_BYTE1 ) || ( tx == Command::READ_SR_BYTE2 ) )
+      {
+        mStats.statusReads++;
+      }
+
+      return SIM_DUMMY_BYTE;
+    }
+
+    if ( mIgnore )
+    {
+      return SIM_DUMMY_BYTE;
+    }
+
+    /*-------------------------------------------------
+    Commands that carry an address latch it MSB first
+    in the three bytes following the opcode.
+    -------------------------------------------------*/
+    const bool hasAddress = ( mOpcode == Command::READ_ARRAY_HS ) || ( mOpcode == Command::READ_ARRAY_LS )
+                            || ( mOpcode == Command::PAGE_PROGRAM ) || ( mOpcode == Command::BLOCK_ERASE_4K )
+                            || ( mOpcode == Command::BLOCK_ERASE_32K ) || ( mOpcode == Command::BLOCK_ERASE_64K )
+                            || ( mOpcode == Command::READ_SFDP );
+
+    if ( hasAddress && ( idx <= 3 ) )
+    {
+      mAddress = ( ( mAddress << 8 ) | tx ) & 0x00FFFFFF;
+      return SIM_DUMMY_BYTE;
+    }
+
+    switch ( mOpcode )
+    {
+      case Command::READ_ARRAY_HS:
+        /*-------------------------------------------------
+        One dummy byte follows the address
+        -------------------------------------------------*/
+        if ( idx < Command::READ_ARRAY_HS_OPS_LEN )
+        {
+          return SIM_DUMMY_BYTE;
+        }
+        return mMemory[ ( mAddress + ( idx - Command::READ_ARRAY_HS_OPS_LEN ) ) % mMemory.size() ];
+
+      case Command::READ_SFDP:
+        if ( idx < Command::READ_SFDP_OPS_LEN )
+        {
+          return SIM_DUMMY_BYTE;
+        }
+        return sfdp_byte( mAddress + ( idx - Command::READ_SFDP_OPS_LEN ) );
+
+      case Command::READ_ARRAY_LS:
+        return mMemory[ ( mAddress + ( idx - Command::READ_ARRAY_LS_OPS_LEN ) ) % mMemory.size() ];
+
+      case Command::PAGE_PROGRAM:
+        /*-------------------------------------------------
+        Only the last page worth of data sent is kept
+        -------------------------------------------------*/
+        mProgramBuffer[ mProgramCount % PAGE_SIZE ] = tx;
+        mProgramCount++;
+        return SIM_DUMMY_BYTE;
+
+      case Command::READ_SR_BYTE1:
+        return statusByte1();
+
+      case Command::READ_SR_BYTE2:
+        return statusByte2();
+
+      case Command::READ_DEV_INFO:
+        return ( idx <= mJedecID.size() ) ? mJedecID[ idx - 1 ] : SIM_DUMMY_BYTE;
+
+      default:
+        return SIM_DUMMY_BYTE;
+    };
+  }
+
+
+  void Simulator::execute()
+  {
+    if ( mIgnore || !mByteIdx )
+    {
+      return;
+    }
+
+    /*-------------------------------------------------
+    Nothing may modify the array while an operation is
+    parked, otherwise resuming it would be ambiguous.
+    -------------------------------------------------*/
+    const bool modifies = ( mOpcode == Command::PAGE_PROGRAM ) || ( mOpcode == Command::BLOCK_ERASE_4K )
+                          || ( mOpcode == Command::BLOCK_ERASE_32K ) || ( mOpcode == Command::BLOCK_ERASE_64K )
+                          || ( mOpcode == Command::CHIP_ERASE );
+
+    if ( mSuspended && modifies )
+    {
+      return;
+    }
+
+    switch ( mOpcode )
+    {
+      case Command::WRITE_ENABLE:
+        mWriteEnabled = true;
+        break;
+
+      case Command::WRITE_DISABLE:
+        mWriteEnabled = false;
+        break;
+
+      case Command::PAGE_PROGRAM:
+        if ( mWriteEnabled && ( mByteIdx >= Command::PAGE_PROGRAM_OPS_LEN ) )
+        {
+          /*-------------------------------------------------
+          Data wraps around to the start of the page rather
+          than spilling into the next one. If more than a
+          page was sent, the most recent bytes win.
+          -------------------------------------------------*/
+          const size_t pageBase = ( mAddress % mMemory.size() ) & ~( PAGE_SIZE - 1 );
+          const size_t count    = std::min( mProgramCount, PAGE_SIZE );
+          const size_t first    = mProgramCount - count;
+
+          for ( size_t x = 0; x < count; x++ )
+          {
+            const size_t offset = ( mAddress + first + x ) % PAGE_SIZE;
+            mMemory[ pageBase + offset ] &= mProgramBuffer[ ( first + x ) % PAGE_SIZE ];
+          }
+
+          startOperation( Operation::PAGE_PROGRAM );
+        }
+        break;
+
+      case Command::BLOCK_ERASE_4K:
+      case Command::BLOCK_ERASE_32K:
+      case Command::BLOCK_ERASE_64K:
+        if ( mWriteEnabled && ( mByteIdx == Command::BLOCK_ERASE_OPS_LEN ) )
+        {
+          size_t chunk = CHUNK_SIZE_4K;
+          Operation op = Operation::ERASE_4K;
+
+          if ( mOpcode == Command::BLOCK_ERASE_32K )
+          {
+            chunk = CHUNK_SIZE_32K;
+            op    = Operation::ERASE_32K;
+          }
+          else if ( mOpcode == Command::BLOCK_ERASE_64K )
+          {
+            chunk = CHUNK_SIZE_64K;
+            op    = Operation::ERASE_64K;
+          }
+
+          const size_t base = ( mAddress % mMemory.size() ) & ~( chunk - 1 );
+          memset( mMemory.data() + base, 0xFF, chunk );
+          startOperation( op );
+        }
+        break;
+
+      case Command::CHIP_ERASE:
+        if ( mWriteEnabled && ( mByteIdx == Command::CHIP_ERASE_OPS_LEN ) )
+        {
+          std::fill( mMemory.begin(), mMemory.end(), 0xFF );
+          startOperation( Operation::ERASE_CHIP );
+        }
+        break;
+
+      case Command::PROGRAM_ERASE_SUSPEND:
+        /*-------------------------------------------------
+        Only an operation still in progress can be paused
+        -------------------------------------------------*/
+        if ( !mSuspended && busy() )
+        {
+          mSuspendLeft  = mBusyDuration - ( mTime() - mBusyStart );
+          mBusyDuration = 0;
+          mSuspended    = true;
+          mStats.suspends++;
+        }
+        break;
+
+      case Command::PROGRAM_ERASE_RESUME:
+        if ( mSuspended )
+        {
+          mBusyStart    = mTime();
+          mBusyDuration = std::max<size_t>( mSuspendLeft, 1 );
+          mSuspended    = false;
+        }
+        break;
+
+      default:
+        break;
+    };
+  }
+
+
+  void Simulator::startOperation( const Operation op )
+  {
+    mStats.programs += ( op == Operation::PAGE_PROGRAM ) ? 1 : 0;
+    mStats.erases += ( op != Operation::PAGE_PROGRAM ) ? 1 : 0;
+    mStats.operations[ static_cast<size_t>( op ) ]++;
+
+    mBusyStart    = mTime();
+    mBusyDuration = mOpTime[ static_cast<size_t>( op ) ];
+
+    /*-------------------------------------------------
+    Zero length operations finish instantly
+    -------------------------------------------------*/
+    if ( !mBusyDuration )
+    {
+      mWriteEnabled = false;
+    }
+  }
+
+
+  uint8_t Simulator::statusByte1()
+  {
+    uint8_t sr = 0;
+
+    if ( busy() )
+    {
+      sr |= Register::SR_RDY_BUSY;
+    }
+
+    if ( mWriteEnabled )
+    {
+      sr |= Register::SR_WEL;
+    }
+
+    return sr;
+  }
+
+
+  uint8_t Simulator::statusByte2()
+  {
+    return mSuspended ? static_cast<uint8_t>( Register::SR_SUS >> 8 ) : 0;
+  }
+}  // namespace Adesto::AT25
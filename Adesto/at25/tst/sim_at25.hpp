@@ -0,0 +1,219 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_at25.hpp
+ *
+ *  Description:
+ *    Behavioral simulation of an AT25SF081 for running the driver off target
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+#pragma once
+#ifndef ADESTO_AT25_SIM_HPP
+#define ADESTO_AT25_SIM_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Chimera Includes */
+#include <Chimera/common>
+
+/* Adesto Includes */
+#include <Adesto/at25/at25_constants.hpp>
+#include <Adesto/at25/at25_types.hpp>
+
+namespace Adesto::AT25
+{
+  /*-------------------------------------------------------------------------------
+  Aliases
+  -------------------------------------------------------------------------------*/
+  using SimTimeSource = size_t ( * )(); /**< Returns the current time in microseconds */
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Bus level counters kept by the simulator, useful for comparing
+   *  how much traffic different driver strategies generate.
+   */
+  struct SimStats
+  {
+    size_t transactions; /**< Number of chip select assertions */
+    size_t bytesClocked; /**< Total bytes exchanged on the bus */
+    size_t programs;     /**< Page program operations executed */
+    size_t erases;       /**< Erase operations executed, including chip erase */
+    size_t statusReads;  /**< Status register read commands */
+    size_t suspends;     /**< Program/erase suspend commands that paused an operation */
+
+    std::array<size_t, static_cast<size_t>( Operation::NUM_OPTIONS )> operations; /**< Program and erase operations executed, by type */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Models an AT25SF081 at the SPI byte level. The transfer functions mirror
+   *  those of Chimera::SPI::Driver so the simulator can sit behind the host side
+   *  SPI backend in tst/sim_at25_host.hpp and be driven by the unmodified driver.
+   *
+   *  The memory array follows NOR semantics: programming can only clear bits,
+   *  erasing sets bytes to 0xFF, and page programs wrap within the page. Program
+   *  and erase operations take effect immediately, but the device reports busy
+   *  for the configured operation time, during which all commands other than
+   *  status reads and suspend are ignored. A suspended operation stops the
+   *  clock on its remaining busy time until it is resumed. While suspended,
+   *  new program and erase commands are ignored. The SFDP space holds a
+   *  JESD216B basic parameter table matching the part.
+   */
+  class Simulator
+  {
+  public:
+    Simulator();
+    ~Simulator();
+
+    /*-------------------------------------------------
+    SPI Bus Interface
+    -------------------------------------------------*/
+    /**
+     *  Drives the chip select line. Commands are decoded as bytes arrive
+     *  and are executed when chip select is released.
+     *
+     *  @param[in]  value       New chip select state
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t setChipSelect( const Chimera::GPIO::State value );
+
+    /**
+     *  Clocks data into the device, discarding anything shifted out
+     *
+     *  @param[in]  txBuffer    Data to send
+     *  @param[in]  length      Number of bytes to send
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t writeBytes( const void *const txBuffer, const size_t length );
+
+    /**
+     *  Clocks data out of the device while sending dummy bytes
+     *
+     *  @param[out] rxBuffer    Where to place received data
+     *  @param[in]  length      Number of bytes to receive
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t readBytes( void *const rxBuffer, const size_t length );
+
+    /**
+     *  Full duplex exchange with the device
+     *
+     *  @param[in]  txBuffer    Data to send
+     *  @param[out] rxBuffer    Where to place received data
+     *  @param[in]  length      Number of bytes to exchange
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t readWriteBytes( const void *const txBuffer, void *const rxBuffer, const size_t length );
+
+    /*-------------------------------------------------
+    Simulation Interface
+    -------------------------------------------------*/
+    /**
+     *  Sets how long the device stays busy after starting an operation
+     *
+     *  @param[in]  op          Which operation to configure
+     *  @param[in]  duration    Busy time in microseconds
+     *  @return void
+     */
+    void setOperationTime( const Operation op, const size_t duration );
+
+    /**
+     *  Replaces the clock the busy timing is measured against. Handy for
+     *  stepping time manually in tests instead of really waiting.
+     *
+     *  @param[in]  source      Function returning the time in microseconds
+     *  @return void
+     */
+    void setTimeSource( SimTimeSource source );
+
+    /**
+     *  Changes the JEDEC ID the device reports, for example to pose as a
+     *  part the driver has no traits for and must discover through SFDP.
+     *
+     *  @param[in]  jedecID     Identifier as it would appear shifted out in MSB mode
+     *  @return void
+     */
+    void setJedecID( const uint32_t jedecID );
+
+    /**
+     *  Restores the memory array to the erased state and clears all
+     *  volatile device state.
+     *
+     *  @return void
+     */
+    void reset();
+
+    /**
+     *  Checks whether an operation is still in progress
+     *
+     *  @return bool
+     */
+    bool busy();
+
+    /**
+     *  Direct access to the memory array, bypassing the bus
+     *
+     *  @return uint8_t *
+     */
+    uint8_t *memory();
+
+    /**
+     *  Size of the memory array in bytes
+     *
+     *  @return size_t
+     */
+    size_t size() const;
+
+    /**
+     *  Gets the bus counters
+     *
+     *  @return SimStats
+     */
+    SimStats getStats() const;
+
+    /**
+     *  Zeros the bus counters
+     *
+     *  @return void
+     */
+    void resetStats();
+
+  private:
+    std::vector<uint8_t> mMemory;                                              /**< Simulated flash array */
+    std::array<size_t, static_cast<size_t>( Operation::NUM_OPTIONS )> mOpTime; /**< Busy time per operation */
+    SimTimeSource mTime;                                                       /**< Clock for busy timing */
+    SimStats mStats;                                                           /**< Bus counters */
+    std::array<uint8_t, Command::READ_DEV_INFO_RSP_LEN> mJedecID;              /**< Identifier bytes in the order shifted out */
+
+    bool mSelected;       /**< Whether chip select is asserted */
+    bool mWriteEnabled;   /**< WEL bit */
+    size_t mBusyStart;    /**< Time the current operation started */
+    size_t mBusyDuration; /**< How long the current operation lasts */
+    bool mSuspended;      /**< Whether the current operation is suspended */
+    size_t mSuspendLeft;  /**< Busy time remaining when the operation was suspended */
+
+    uint8_t mOpcode;                               /**< Command being decoded */
+    size_t mByteIdx;                               /**< Bytes received since chip select was asserted */
+    size_t mAddress;                               /**< Address decoded from the command */
+    bool mIgnore;                                  /**< Whether the device is too busy to accept this command */
+    std::array<uint8_t, PAGE_SIZE> mProgramBuffer; /**< Data latched during a page program */
+    size_t mProgramCount;                          /**< Bytes latched during a page program */
+
+    uint8_t exchange( const uint8_t tx );
+    void execute();
+    void startOperation( const Operation op );
+    uint8_t statusByte1();
+    uint8_t statusByte2();
+  };
+}  // namespace Adesto::AT25
+
+#endif /* !ADESTO_AT25_SIM_HPP */
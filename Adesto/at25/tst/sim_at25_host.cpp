@@ -0,0 +1,185 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_at25_host.cpp
+ *
+ *  Description:
+ *    Host side SPI and timing backend that routes the AT25 driver into the
+ *    behavioral simulator
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <memory>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/spi>
+
+/* Test Includes */
+#include "sim_at25_host.hpp"
+
+namespace Adesto::AT25::Host
+{
+  /*-------------------------------------------------------------------------------
+  Static Data
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t NUM_CHANNELS = static_cast<size_t>( Chimera::SPI::Channel::NUM_OPTIONS );
+
+  static std::array<Chimera::SPI::Driver_sPtr, NUM_CHANNELS> s_drivers; /**< Driver handed out per channel */
+  static std::array<Simulator *, NUM_CHANNELS> s_devices;               /**< Simulator attached per channel */
+  static size_t s_time;                                                 /**< Simulated clock in microseconds */
+  static size_t s_slept;                                                /**< Time spent in the delay functions */
+
+  /*-------------------------------------------------------------------------------
+  Private Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Finds the simulator behind a driver instance
+   *
+   *  @param[in]  driver      Driver making the bus access
+   *  @return Simulator *     nullptr if nothing is attached
+   */
+  static Simulator *deviceOf( const Chimera::SPI::Driver *const driver )
+  {
+    for ( size_t idx = 0; idx < NUM_CHANNELS; idx++ )
+    {
+      if ( s_drivers[ idx ].get() == driver )
+      {
+        return s_devices[ idx ];
+      }
+    }
+
+    return nullptr;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  void attach( const Chimera::SPI::Channel channel, Simulator *const sim )
+  {
+    if ( channel < Chimera::SPI::Channel::NUM_OPTIONS )
+    {
+      s_devices[ static_cast<size_t>( channel ) ] = sim;
+    }
+  }
+
+
+  void reset()
+  {
+    s_devices.fill( nullptr );
+    s_time  = 0;
+    s_slept = 0;
+  }
+
+
+  size_t now()
+  {
+    return s_time;
+  }
+
+
+  void advance( const size_t duration )
+  {
+    s_time += duration;
+  }
+
+
+  size_t slept()
+  {
+    return s_slept;
+  }
+}  // namespace Adesto::AT25::Host
+
+
+/*-------------------------------------------------------------------------------
+Chimera System Backend
+-------------------------------------------------------------------------------*/
+namespace Chimera
+{
+  size_t millis()
+  {
+    return Adesto::AT25::Host::s_time / 1000;
+  }
+
+
+  size_t micros()
+  {
+    return Adesto::AT25::Host::s_time;
+  }
+
+
+  void delayMilliseconds( const size_t val )
+  {
+    Adesto::AT25::Host::s_time += val * 1000;
+    Adesto::AT25::Host::s_slept += val * 1000;
+  }
+
+
+  void delayMicroseconds( const size_t val )
+  {
+    Adesto::AT25::Host::s_time += val;
+    Adesto::AT25::Host::s_slept += val;
+  }
+}  // namespace Chimera
+
+
+/*-------------------------------------------------------------------------------
+Chimera SPI Backend
+-------------------------------------------------------------------------------*/
+namespace Chimera::SPI
+{
+  Chimera::Status_t Driver::setChipSelect( const Chimera::GPIO::State value )
+  {
+    auto sim = Adesto::AT25::Host::deviceOf( this );
+    return sim ? sim->setChipSelect( value ) : Chimera::Status::FAIL;
+  }
+
+
+  Chimera::Status_t Driver::writeBytes( const void *const txBuffer, const size_t length )
+  {
+    auto sim = Adesto::AT25::Host::deviceOf( this );
+    return sim ? sim->writeBytes( txBuffer, length ) : Chimera::Status::FAIL;
+  }
+
+
+  Chimera::Status_t Driver::readBytes( void *const rxBuffer, const size_t length )
+  {
+    auto sim = Adesto::AT25::Host::deviceOf( this );
+    return sim ? sim->readBytes( rxBuffer, length ) : Chimera::Status::FAIL;
+  }
+
+
+  Chimera::Status_t Driver::readWriteBytes( const void *const txBuffer, void *const rxBuffer, const size_t length )
+  {
+    auto sim = Adesto::AT25::Host::deviceOf( this );
+    return sim ? sim->readWriteBytes( txBuffer, rxBuffer, length ) : Chimera::Status::FAIL;
+  }
+
+
+  Chimera::Status_t Driver::await( const Chimera::Event::Trigger event, const size_t timeout )
+  {
+    /*-------------------------------------------------
+    Simulated transfers finish before returning
+    -------------------------------------------------*/
+    return Chimera::Status::OK;
+  }
+
+
+  Driver_sPtr getDriver( const Channel channel )
+  {
+    if ( channel >= Channel::NUM_OPTIONS )
+    {
+      return nullptr;
+    }
+
+    auto &driver = Adesto::AT25::Host::s_drivers[ static_cast<size_t>( channel ) ];
+    if ( !driver )
+    {
+      driver = std::make_shared<Driver>();
+    }
+
+    return driver;
+  }
+}  // namespace Chimera::SPI
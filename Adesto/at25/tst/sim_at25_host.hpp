@@ -0,0 +1,75 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_at25_host.hpp
+ *
+ *  Description:
+ *    Host side SPI and timing backend that routes the AT25 driver into the
+ *    behavioral simulator
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+#pragma once
+#ifndef ADESTO_AT25_SIM_HOST_HPP
+#define ADESTO_AT25_SIM_HOST_HPP
+
+/* STL Includes */
+#include <cstddef>
+
+/* Chimera Includes */
+#include <Chimera/spi>
+
+/* Test Includes */
+#include "sim_at25.hpp"
+
+namespace Adesto::AT25::Host
+{
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Connects a simulated device to an SPI channel. Test builds link the host
+   *  backend in place of the Chimera SPI and system backends, so the driver
+   *  handed out by Chimera::SPI::getDriver() for this channel forwards all of
+   *  its bus traffic to the simulator.
+   *
+   *  @param[in]  channel     Channel the driver under test will be configured on
+   *  @param[in]  sim         Device to attach, or nullptr to leave the channel floating
+   *  @return void
+   */
+  void attach( const Chimera::SPI::Channel channel, Simulator *const sim );
+
+  /**
+   *  Disconnects every simulator and rewinds the clock to zero
+   *
+   *  @return void
+   */
+  void reset();
+
+  /**
+   *  Gets the simulated time. The Chimera delay functions advance this clock
+   *  instead of sleeping, so a 12 second chip erase completes instantly.
+   *
+   *  @return size_t          Time in microseconds
+   */
+  size_t now();
+
+  /**
+   *  Moves the simulated clock forward without going through the driver,
+   *  for example to let a background operation finish between process() calls.
+   *
+   *  @param[in]  duration    Time to advance in microseconds
+   *  @return void
+   */
+  void advance( const size_t duration );
+
+  /**
+   *  Gets how much simulated time was spent inside the Chimera delay functions
+   *  since the last reset(), which is time the driver spent waiting on the part.
+   *
+   *  @return size_t          Time in microseconds
+   */
+  size_t slept();
+}  // namespace Adesto::AT25::Host
+
+#endif /* !ADESTO_AT25_SIM_HOST_HPP */
@@ -0,0 +1,219 @@
+/********************************************************************************
+ *  File Name:
+ *    test_at25_async.cpp
+ *
+ *  Description:
+ *    Tests non-blocking program and erase jobs on the AT25 driver
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <cstring>
+
+/* Adesto Includes */
+#include <Adesto/at25/at25_driver.hpp>
+
+/* Test Includes */
+#include <gtest/gtest.h>
+#include "test_fixtures_at25.hpp"
+
+using namespace Adesto;
+using namespace Adesto::AT25;
+
+/*-------------------------------------------------
+Each erase step is made to take exactly this long so
+the tests can move time to any point in a job.
+-------------------------------------------------*/
+static constexpr size_t STEP_TIME = 1000;
+
+static size_t s_writeDone;
+static size_t s_eraseDone;
+
+static void onWriteDone( const size_t bytes )
+{
+  s_writeDone += bytes;
+}
+
+static void onEraseDone( const size_t bytes )
+{
+  s_eraseDone += bytes;
+}
+
+/**
+ *  Starts a background erase of the first three 4K sectors, which the
+ *  driver has to issue as three separate steps
+ */
+static void startThreeStepErase( Simulator &sim, Driver *const flash )
+{
+  sim.setOperationTime( Operation::ERASE_4K, STEP_TIME );
+  memset( sim.memory(), 0, 4 * CHUNK_SIZE_4K );
+
+  ASSERT_EQ( Status::ERR_OK, flash->setAsync( true ) );
+  ASSERT_EQ( Status::ERR_OK, flash->erase( 0, 3 * CHUNK_SIZE_4K ) );
+  ASSERT_EQ( 1u, sim.getStats().erases );
+}
+
+/*-------------------------------------------------
+Job Progression
+-------------------------------------------------*/
+TEST_F( SimulatedAT25, Async_EraseStepsThroughProcess )
+{
+  s_eraseDone = 0;
+  passInit();
+  ASSERT_EQ( Status::ERR_OK, flash->onEvent( Aurora::Memory::Event::MEM_ERASE_COMPLETE, onEraseDone ) );
+  startThreeStepErase( sim, flash );
+
+  /*-------------------------------------------------
+  Nothing moves while the step in flight is running
+  -------------------------------------------------*/
+  flash->process();
+  EXPECT_EQ( 1u, sim.getStats().erases );
+
+  for ( size_t step = 2; step <= 3; step++ )
+  {
+    Host::advance( STEP_TIME );
+    flash->process();
+    EXPECT_EQ( step, sim.getStats().erases );
+    EXPECT_EQ( 0u, s_eraseDone );
+  }
+
+  /*-------------------------------------------------
+  The callback reports the whole job once it's done
+  -------------------------------------------------*/
+  Host::advance( STEP_TIME );
+  flash->process();
+  EXPECT_EQ( 3 * CHUNK_SIZE_4K, s_eraseDone );
+  EXPECT_TRUE( filled( 0, 3 * CHUNK_SIZE_4K, 0xFF ) );
+  EXPECT_TRUE( filled( 3 * CHUNK_SIZE_4K, CHUNK_SIZE_4K, 0x00 ) );
+
+  flash->process();
+  EXPECT_EQ( 3 * CHUNK_SIZE_4K, s_eraseDone );
+}
+
+TEST_F( SimulatedAT25, Async_WriteStepsThroughProcess )
+{
+  std::array<uint8_t, 2 * PAGE_SIZE> data;
+  pattern( data, 3 );
+
+  s_writeDone = 0;
+  passInit();
+  ASSERT_EQ( Status::ERR_OK, flash->onEvent( Aurora::Memory::Event::MEM_WRITE_COMPLETE, onWriteDone ) );
+  ASSERT_EQ( Status::ERR_OK, flash->setAsync( true ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 0, data.data(), data.size() ) );
+  EXPECT_EQ( 1u, sim.getStats().programs );
+
+  while ( !s_writeDone )
+  {
+    Host::advance( 100 );
+    flash->process();
+  }
+
+  EXPECT_EQ( 2u, sim.getStats().programs );
+  EXPECT_EQ( data.size(), s_writeDone );
+  EXPECT_EQ( 0, memcmp( sim.memory(), data.data(), data.size() ) );
+}
+
+TEST_F( SimulatedAT25, Async_PendEventRunsWholeJob )
+{
+  passInit();
+  startThreeStepErase( sim, flash );
+
+  ASSERT_EQ( Status::ERR_OK, flash->pendEvent( Aurora::Memory::Event::MEM_ERASE_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK ) );
+  EXPECT_EQ( 3u, sim.getStats().erases );
+  EXPECT_FALSE( sim.busy() );
+  EXPECT_TRUE( filled( 0, 3 * CHUNK_SIZE_4K, 0xFF ) );
+}
+
+TEST_F( SimulatedAT25, Async_UnsupportedEvents )
+{
+  passInit();
+  EXPECT_EQ( Status::ERR_UNSUPPORTED, flash->onEvent( Aurora::Memory::Event::MEM_READ_COMPLETE, onWriteDone ) );
+}
+
+/*-------------------------------------------------
+Reads During A Job
+-------------------------------------------------*/
+TEST_F( SimulatedAT25, Async_ReadOutsideJobSuspendsErase )
+{
+  std::array<uint8_t, 32> data;
+  std::array<uint8_t, 32> readData;
+
+  pattern( data, 11 );
+  passInit();
+  startThreeStepErase( sim, flash );
+  memcpy( sim.memory() + CHUNK_SIZE_64K, data.data(), data.size() );
+
+  ASSERT_EQ( Status::ERR_OK, flash->read( CHUNK_SIZE_64K, readData.data(), readData.size() ) );
+
+  /*-------------------------------------------------
+  The erase was paused around the read and picked back
+  up, without the rest of the job being run.
+  -------------------------------------------------*/
+  EXPECT_EQ( 0, memcmp( readData.data(), data.data(), data.size() ) );
+  EXPECT_EQ( 1u, sim.getStats().suspends );
+  EXPECT_EQ( 1u, sim.getStats().erases );
+  EXPECT_FALSE( flash->isSuspended() );
+  EXPECT_TRUE( sim.busy() );
+}
+
+TEST_F( SimulatedAT25, Async_ReadOfStepInFlightWaits )
+{
+  uint8_t value = 0;
+
+  passInit();
+  startThreeStepErase( sim, flash );
+
+  ASSERT_EQ( Status::ERR_OK, flash->read( 100, &value, 1 ) );
+  EXPECT_EQ( 0xFF, value );
+  EXPECT_EQ( 0u, sim.getStats().suspends );
+  EXPECT_EQ( 3u, sim.getStats().erases );
+}
+
+TEST_F( SimulatedAT25, Async_ReadOfPendingJobRangeWaits )
+{
+  uint8_t value = 0;
+
+  passInit();
+  startThreeStepErase( sim, flash );
+
+  /*-------------------------------------------------
+  The last sector hasn't been erased yet, so suspending
+  the first one would return its old contents.
+  -------------------------------------------------*/
+  ASSERT_EQ( Status::ERR_OK, flash->read( ( 2 * CHUNK_SIZE_4K ) + 100, &value, 1 ) );
+  EXPECT_EQ( 0xFF, value );
+  EXPECT_EQ( 0u, sim.getStats().suspends );
+  EXPECT_EQ( 3u, sim.getStats().erases );
+}
+
+TEST_F( SimulatedAT25, Async_ReadStraddlingJobEndWaits )
+{
+  std::array<uint8_t, 8> readData;
+
+  passInit();
+  startThreeStepErase( sim, flash );
+
+  ASSERT_EQ( Status::ERR_OK, flash->read( ( 3 * CHUNK_SIZE_4K ) - 4, readData.data(), readData.size() ) );
+  EXPECT_EQ( 0u, sim.getStats().suspends );
+  EXPECT_EQ( 3u, sim.getStats().erases );
+  EXPECT_TRUE( std::all_of( readData.begin(), readData.begin() + 4, []( const uint8_t x ) { return x == 0xFF; } ) );
+  EXPECT_TRUE( std::all_of( readData.begin() + 4, readData.end(), []( const uint8_t x ) { return x == 0x00; } ) );
+}
+
+TEST_F( SimulatedAT25, Async_ReadDuringWriteWaits )
+{
+  std::array<uint8_t, 2 * PAGE_SIZE> data;
+  uint8_t value = 0;
+
+  pattern( data, 5 );
+  passInit();
+  ASSERT_EQ( Status::ERR_OK, flash->setAsync( true ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 0, data.data(), data.size() ) );
+
+  ASSERT_EQ( Status::ERR_OK, flash->read( CHUNK_SIZE_64K, &value, 1 ) );
+  EXPECT_EQ( 0u, sim.getStats().suspends );
+  EXPECT_EQ( 2u, sim.getStats().programs );
+  EXPECT_FALSE( sim.busy() );
+}
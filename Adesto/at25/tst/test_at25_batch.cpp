@@ -0,0 +1,125 @@
+/********************************************************************************
+ *  File Name:
+ *    test_at25_batch.cpp
+ *
+ *  Description:
+ *    Tests batched operation sessions on the AT25 driver
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <cstring>
+
+/* Adesto Includes */
+#include <Adesto/at25/at25_batch.hpp>
+#include <Adesto/at25/at25_driver.hpp>
+
+/* Test Includes */
+#include <gtest/gtest.h>
+#include "test_fixtures_at25.hpp"
+
+using namespace Adesto::AT25;
+
+TEST_F( SimulatedAT25, Batch_NothingRunsUntilCommit )
+{
+  std::array<uint8_t, 64> data;
+  pattern( data, 5 );
+  passInit();
+
+  const auto before = sim.getStats().transactions;
+  auto batch        = flash->beginBatch();
+
+  ASSERT_EQ( Status::ERR_OK, batch.erase( 0, BLOCK_SIZE ) );
+  ASSERT_EQ( Status::ERR_OK, batch.write( 10, data.data(), data.size() ) );
+  EXPECT_EQ( 2u, batch.size() );
+  EXPECT_EQ( before, sim.getStats().transactions );
+
+  /*-------------------------------------------------
+  The driver stays usable while the batch is queued
+  -------------------------------------------------*/
+  uint8_t value = 0;
+  EXPECT_EQ( Status::ERR_OK, flash->read( 0, &value, 1 ) );
+}
+
+TEST_F( SimulatedAT25, Batch_RunsInOrder )
+{
+  std::array<uint8_t, 2 * PAGE_SIZE> data;
+  std::array<uint8_t, 2 * PAGE_SIZE> readData;
+
+  pattern( data, 9 );
+  readData.fill( 0 );
+  passInit();
+  memset( sim.memory(), 0, BLOCK_SIZE );
+
+  auto batch = flash->beginBatch();
+  ASSERT_EQ( Status::ERR_OK, batch.erase( 0, BLOCK_SIZE ) );
+  ASSERT_EQ( Status::ERR_OK, batch.write( 100, data.data(), data.size() ) );
+  ASSERT_EQ( Status::ERR_OK, batch.wait( 100 ) );
+  ASSERT_EQ( Status::ERR_OK, batch.read( 100, readData.data(), readData.size() ) );
+  ASSERT_EQ( Status::ERR_OK, batch.commit() );
+
+  EXPECT_EQ( 0, memcmp( readData.data(), data.data(), data.size() ) );
+  EXPECT_TRUE( filled( 0, 100, 0xFF ) );
+  EXPECT_TRUE( filled( 100 + data.size(), BLOCK_SIZE - 100 - data.size(), 0xFF ) );
+  EXPECT_FALSE( sim.busy() );
+}
+
+TEST_F( SimulatedAT25, Batch_StopsAtFirstFailure )
+{
+  const uint8_t value = 0x00;
+  passInit();
+
+  auto batch = flash->beginBatch();
+  ASSERT_EQ( Status::ERR_OK, batch.write( 0, &value, 1 ) );
+  ASSERT_EQ( Status::ERR_OK, batch.erase( 1, BLOCK_SIZE ) );
+  ASSERT_EQ( Status::ERR_OK, batch.write( 1, &value, 1 ) );
+
+  EXPECT_EQ( Status::ERR_BAD_ARG, batch.commit() );
+  EXPECT_EQ( 0x00, sim.memory()[ 0 ] );
+  EXPECT_EQ( 0xFF, sim.memory()[ 1 ] );
+}
+
+TEST_F( SimulatedAT25, Batch_CommitsOnce )
+{
+  const uint8_t value = 0x00;
+  passInit();
+
+  auto batch = flash->beginBatch();
+  ASSERT_EQ( Status::ERR_OK, batch.write( 0, &value, 1 ) );
+  ASSERT_EQ( Status::ERR_OK, batch.commit() );
+
+  EXPECT_EQ( Status::ERR_UNSUPPORTED, batch.commit() );
+  EXPECT_EQ( Status::ERR_UNSUPPORTED, batch.write( 1, &value, 1 ) );
+  EXPECT_EQ( 0u, batch.size() );
+}
+
+TEST_F( SimulatedAT25, Batch_QueueLimit )
+{
+  uint8_t value = 0;
+  passInit();
+
+  auto batch = flash->beginBatch();
+  for ( size_t x = 0; x < BATCH_MAX_OPS; x++ )
+  {
+    ASSERT_EQ( Status::ERR_OK, batch.read( x, &value, 1 ) );
+  }
+
+  EXPECT_EQ( Status::ERR_UNSUPPORTED, batch.read( 0, &value, 1 ) );
+  EXPECT_EQ( BATCH_MAX_OPS, batch.size() );
+  EXPECT_EQ( Status::ERR_OK, batch.commit() );
+}
+
+TEST_F( SimulatedAT25, Batch_BadArguments )
+{
+  uint8_t value = 0;
+  passInit();
+
+  auto batch = flash->beginBatch();
+  EXPECT_EQ( Status::ERR_BAD_ARG, batch.read( 0, nullptr, 1 ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, batch.read( 0, &value, 0 ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, batch.write( 0, nullptr, 1 ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, batch.erase( 0, 0 ) );
+  EXPECT_EQ( 0u, batch.size() );
+}
@@ -0,0 +1,169 @@
+/********************************************************************************
+ *  File Name:
+ *    test_at25_erase.cpp
+ *
+ *  Description:
+ *    Tests planning of arbitrary erase ranges on the AT25 driver
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <cstring>
+
+/* Adesto Includes */
+#include <Adesto/at25/at25_driver.hpp>
+
+/* Test Includes */
+#include <gtest/gtest.h>
+#include "test_fixtures_at25.hpp"
+
+using namespace Adesto;
+using namespace Adesto::AT25;
+
+static size_t erasesOf( const SimStats &stats, const Operation op )
+{
+  return stats.operations[ static_cast<size_t>( op ) ];
+}
+
+/*-------------------------------------------------
+Input Protection
+-------------------------------------------------*/
+TEST_F( SimulatedAT25, Erase_Unaligned )
+{
+  passInit();
+  memset( sim.memory(), 0, 2 * CHUNK_SIZE_64K );
+
+  EXPECT_EQ( Status::ERR_BAD_ARG, flash->erase( 0, 0 ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, flash->erase( 1, CHUNK_SIZE_4K ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, flash->erase( CHUNK_SIZE_4K - PAGE_SIZE, CHUNK_SIZE_4K ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, flash->erase( 0, CHUNK_SIZE_4K + 1 ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, flash->erase( CHUNK_SIZE_4K, PAGE_SIZE ) );
+
+  EXPECT_EQ( 0u, sim.getStats().erases );
+  EXPECT_TRUE( filled( 0, 2 * CHUNK_SIZE_64K, 0x00 ) );
+}
+
+TEST_F( SimulatedAT25, Erase_OutOfRange )
+{
+  passInit();
+
+  EXPECT_EQ( Status::ERR_BAD_ARG, flash->erase( sim.size(), CHUNK_SIZE_4K ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, flash->erase( sim.size() - CHUNK_SIZE_4K, 2 * CHUNK_SIZE_4K ) );
+  EXPECT_EQ( Status::ERR_BAD_ARG, flash->erase( Aurora::Memory::Chunk::BLOCK, sim.size() / BLOCK_SIZE ) );
+  EXPECT_EQ( 0u, sim.getStats().erases );
+
+  EXPECT_EQ( Status::ERR_OK, flash->erase( sim.size() - CHUNK_SIZE_4K, CHUNK_SIZE_4K ) );
+  EXPECT_EQ( 1u, sim.getStats().erases );
+}
+
+/*-------------------------------------------------
+Planning
+-------------------------------------------------*/
+TEST_F( SimulatedAT25, Erase_AlignedRangeUsesLargestType )
+{
+  passInit();
+  memset( sim.memory(), 0, 3 * CHUNK_SIZE_64K );
+
+  ASSERT_EQ( Status::ERR_OK, flash->erase( CHUNK_SIZE_64K, CHUNK_SIZE_64K ) );
+
+  const auto stats = sim.getStats();
+  EXPECT_EQ( 1u, stats.erases );
+  EXPECT_EQ( 1u, erasesOf( stats, Operation::ERASE_64K ) );
+  EXPECT_TRUE( filled( 0, CHUNK_SIZE_64K, 0x00 ) );
+  EXPECT_TRUE( filled( CHUNK_SIZE_64K, CHUNK_SIZE_64K, 0xFF ) );
+  EXPECT_TRUE( filled( 2 * CHUNK_SIZE_64K, CHUNK_SIZE_64K, 0x00 ) );
+}
+
+TEST_F( SimulatedAT25, Erase_UnalignedStartStepsUpThroughSizes )
+{
+  /*-------------------------------------------------
+  4K..128K: seven 4K erases up to the 32K boundary, one
+  32K erase up to the 64K boundary, then a single 64K.
+  -------------------------------------------------*/
+  static constexpr size_t start = CHUNK_SIZE_4K;
+  static constexpr size_t end   = 2 * CHUNK_SIZE_64K;
+
+  passInit();
+  memset( sim.memory(), 0, end + CHUNK_SIZE_4K );
+
+  ASSERT_EQ( Status::ERR_OK, flash->erase( start, end - start ) );
+
+  const auto stats = sim.getStats();
+  EXPECT_EQ( 9u, stats.erases );
+  EXPECT_EQ( 7u, erasesOf( stats, Operation::ERASE_4K ) );
+  EXPECT_EQ( 1u, erasesOf( stats, Operation::ERASE_32K ) );
+  EXPECT_EQ( 1u, erasesOf( stats, Operation::ERASE_64K ) );
+
+  EXPECT_TRUE( filled( 0, start, 0x00 ) );
+  EXPECT_TRUE( filled( start, end - start, 0xFF ) );
+  EXPECT_TRUE( filled( end, CHUNK_SIZE_4K, 0x00 ) );
+}
+
+TEST_F( SimulatedAT25, Erase_ShortTailStepsDownThroughSizes )
+{
+  /*-------------------------------------------------
+  0..108K: one 64K, one 32K, then three 4K erases
+  since the last 12K can't use anything bigger.
+  -------------------------------------------------*/
+  static constexpr size_t length = CHUNK_SIZE_64K + CHUNK_SIZE_32K + 3 * CHUNK_SIZE_4K;
+
+  passInit();
+  memset( sim.memory(), 0, length + CHUNK_SIZE_4K );
+
+  ASSERT_EQ( Status::ERR_OK, flash->erase( 0, length ) );
+
+  const auto stats = sim.getStats();
+  EXPECT_EQ( 5u, stats.erases );
+  EXPECT_EQ( 3u, erasesOf( stats, Operation::ERASE_4K ) );
+  EXPECT_EQ( 1u, erasesOf( stats, Operation::ERASE_32K ) );
+  EXPECT_EQ( 1u, erasesOf( stats, Operation::ERASE_64K ) );
+
+  EXPECT_TRUE( filled( 0, length, 0xFF ) );
+  EXPECT_TRUE( filled( length, CHUNK_SIZE_4K, 0x00 ) );
+}
+
+TEST_F( SimulatedAT25, Erase_WholeDeviceUsesChipErase )
+{
+  passInit();
+  memset( sim.memory(), 0, sim.size() );
+
+  ASSERT_EQ( Status::ERR_OK, flash->erase( 0, sim.size() ) );
+
+  const auto stats = sim.getStats();
+  EXPECT_EQ( 1u, stats.erases );
+  EXPECT_EQ( 1u, erasesOf( stats, Operation::ERASE_CHIP ) );
+  EXPECT_TRUE( filled( 0, sim.size(), 0xFF ) );
+}
+
+TEST_F( SimulatedAT25, Erase_ByChunk )
+{
+  passInit();
+  memset( sim.memory(), 0, 2 * SECTOR_SIZE );
+
+  ASSERT_EQ( Status::ERR_OK, flash->erase( Aurora::Memory::Chunk::BLOCK, 3 ) );
+  ASSERT_EQ( Status::ERR_OK, flash->erase( Aurora::Memory::Chunk::SECTOR, 1 ) );
+
+  const auto stats = sim.getStats();
+  EXPECT_EQ( 1u, erasesOf( stats, Operation::ERASE_4K ) );
+  EXPECT_EQ( 1u, erasesOf( stats, Operation::ERASE_32K ) );
+
+  EXPECT_TRUE( filled( 0, 3 * BLOCK_SIZE, 0x00 ) );
+  EXPECT_TRUE( filled( 3 * BLOCK_SIZE, BLOCK_SIZE, 0xFF ) );
+  EXPECT_TRUE( filled( 4 * BLOCK_SIZE, SECTOR_SIZE - 4 * BLOCK_SIZE, 0x00 ) );
+  EXPECT_TRUE( filled( SECTOR_SIZE, SECTOR_SIZE, 0xFF ) );
+}
+
+TEST_F( SimulatedAT25, Erase_DropsBufferedWritesInRange )
+{
+  const uint8_t data = 0x00;
+
+  passInit();
+  ASSERT_EQ( Status::ERR_OK, flash->setWriteBack( true ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 100, &data, 1 ) );
+  ASSERT_EQ( Status::ERR_OK, flash->erase( 0, CHUNK_SIZE_4K ) );
+  ASSERT_EQ( Status::ERR_OK, flash->flush() );
+
+  EXPECT_EQ( 0u, sim.getStats().programs );
+  EXPECT_TRUE( filled( 0, CHUNK_SIZE_4K, 0xFF ) );
+}
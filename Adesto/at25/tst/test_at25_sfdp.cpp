@@ -0,0 +1,346 @@
+/********************************************************************************
+ *  File Name:
+ *    test_at25_sfdp.cpp
+ *
+ *  Description:
+ *    Tests decoding of the JEDEC SFDP tables and discovery of unknown parts
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <cstring>
+
+/* Adesto Includes */
+#include <Adesto/at25/at25_driver.hpp>
+#include <Adesto/at25/at25_sfdp.hpp>
+#include <Adesto/at25/at25_traits.hpp>
+
+/* Test Includes */
+#include <gtest/gtest.h>
+#include "test_fixtures_at25.hpp"
+
+using namespace Adesto;
+using namespace Adesto::AT25;
+
+/*-------------------------------------------------
+Tables as the simulator reports them for the
+AT25SF081, see sim_at25.cpp
+-------------------------------------------------*/
+static constexpr std::array<uint8_t, SFDP::HEADER_LEN + SFDP::PARAM_HEADER_LEN> HEADER = {
+  'S', 'F', 'D', 'P', 0x06, 0x01, 0x00, 0xFF, 0x00, 0x06, 0x01, 0x10, 0x30, 0x00, 0x00, 0xFF,
+};
+
+static constexpr std::array<uint32_t, SFDP::BASIC_TABLE_MAX_DW> BASIC = { {
+  0xFFF12005,
+  0x007FFFFF,
+  0x6B08EB44,
+  0xBB803B08,
+  0xFFFFFFEE,
+  0x0000FFFF,
+  0x0000FFFF,
+  0x520F200C,
+  0x0000D810,
+  0x0111AA32,
+  0xC2002685,
+  0xFFFFFFFF,
+  0xFFFFFFFF,
+  0xFFFFFFFF,
+  0xFFFFFFFF,
+  0xFFFFFFFF,
+} };
+
+/**
+ *  Lays out table DWORDs in little endian order, the way they are read
+ *  from the device
+ */
+static std::array<uint8_t, sizeof( BASIC )> toBytes( const std::array<uint32_t, SFDP::BASIC_TABLE_MAX_DW> &table )
+{
+  std::array<uint8_t, sizeof( BASIC )> bytes;
+  for ( size_t x = 0; x < bytes.size(); x++ )
+  {
+    bytes[ x ] = static_cast<uint8_t>( table[ x / 4 ] >> ( 8 * ( x % 4 ) ) );
+  }
+
+  return bytes;
+}
+
+static const OperationTiming &timingOf( const SFDPInfo &info, const Operation op )
+{
+  return info.timing[ static_cast<size_t>( op ) ];
+}
+
+/*-------------------------------------------------
+Header
+-------------------------------------------------*/
+TEST( SFDP, SFDP_HeaderPointsAtBasicTable )
+{
+  size_t address = 0;
+  size_t dwords  = 0;
+
+  ASSERT_TRUE( SFDP::parseHeader( HEADER.data(), address, dwords ) );
+  EXPECT_EQ( 0x30u, address );
+  EXPECT_EQ( 16u, dwords );
+}
+
+TEST( SFDP, SFDP_HeaderRejectsBadSignature )
+{
+  size_t address = 0;
+  size_t dwords  = 0;
+  auto header    = HEADER;
+
+  header[ 3 ] = 'X';
+  EXPECT_FALSE( SFDP::parseHeader( header.data(), address, dwords ) );
+
+  /*-------------------------------------------------
+  A floating bus reads back as all ones
+  -------------------------------------------------*/
+  header.fill( 0xFF );
+  EXPECT_FALSE( SFDP::parseHeader( header.data(), address, dwords ) );
+  EXPECT_FALSE( SFDP::parseHeader( nullptr, address, dwords ) );
+}
+
+TEST( SFDP, SFDP_HeaderRejectsOtherFirstTable )
+{
+  size_t address = 0;
+  size_t dwords  = 0;
+  auto header    = HEADER;
+
+  header[ SFDP::HEADER_LEN ] = 0x81;
+  EXPECT_FALSE( SFDP::parseHeader( header.data(), address, dwords ) );
+}
+
+TEST( SFDP, SFDP_HeaderRejectsShortTable )
+{
+  size_t address = 0;
+  size_t dwords  = 0;
+  auto header    = HEADER;
+
+  header[ SFDP::HEADER_LEN + 3 ] = SFDP::BASIC_TABLE_MIN_DW - 1;
+  EXPECT_FALSE( SFDP::parseHeader( header.data(), address, dwords ) );
+
+  header[ SFDP::HEADER_LEN + 3 ] = SFDP::BASIC_TABLE_MIN_DW;
+  EXPECT_TRUE( SFDP::parseHeader( header.data(), address, dwords ) );
+}
+
+/*-------------------------------------------------
+Basic Parameter Table
+-------------------------------------------------*/
+TEST( SFDP, SFDP_DecodesSimulatorTable )
+{
+  SFDPInfo info;
+  const auto bytes = toBytes( BASIC );
+
+  ASSERT_TRUE( SFDP::parseBasicTable( bytes.data(), BASIC.size(), info ) );
+  EXPECT_TRUE( info.valid );
+  EXPECT_EQ( 8 * MBIT, info.size );
+  EXPECT_EQ( PAGE_SIZE, info.pageSize );
+  EXPECT_EQ( 3u, info.addressBytes );
+
+  ASSERT_EQ( 3u, info.numEraseTypes );
+  EXPECT_EQ( CHUNK_SIZE_4K, info.eraseTypes[ 0 ].size );
+  EXPECT_EQ( 0x20, info.eraseTypes[ 0 ].opcode );
+  EXPECT_EQ( CHUNK_SIZE_32K, info.eraseTypes[ 1 ].size );
+  EXPECT_EQ( 0x52, info.eraseTypes[ 1 ].opcode );
+  EXPECT_EQ( CHUNK_SIZE_64K, info.eraseTypes[ 2 ].size );
+  EXPECT_EQ( 0xD8, info.eraseTypes[ 2 ].opcode );
+
+  /*-------------------------------------------------
+  Typical times with the max multipliers from DWORDs
+  10 and 11 applied
+  -------------------------------------------------*/
+  EXPECT_EQ( 448u, timingOf( info, Operation::PAGE_PROGRAM ).typical );
+  EXPECT_EQ( 448u * 12, timingOf( info, Operation::PAGE_PROGRAM ).maximum );
+  EXPECT_EQ( 64000u, timingOf( info, Operation::ERASE_4K ).typical );
+  EXPECT_EQ( 64000u * 6, timingOf( info, Operation::ERASE_4K ).maximum );
+  EXPECT_EQ( 352000u, timingOf( info, Operation::ERASE_32K ).typical );
+  EXPECT_EQ( 640000u, timingOf( info, Operation::ERASE_64K ).typical );
+  EXPECT_EQ( 12000000u, timingOf( info, Operation::ERASE_CHIP ).typical );
+}
+
+TEST( SFDP, SFDP_PowerOfTwoDensity )
+{
+  SFDPInfo info;
+  auto table = BASIC;
+
+  table[ 1 ] = 0x80000000u | 24;
+  auto bytes = toBytes( table );
+  ASSERT_TRUE( SFDP::parseBasicTable( bytes.data(), table.size(), info ) );
+  EXPECT_EQ( 16 * MBIT, info.size );
+
+  /*-------------------------------------------------
+  Less than a byte, or more than size_t can hold
+  -------------------------------------------------*/
+  table[ 1 ] = 0x80000000u | 2;
+  bytes      = toBytes( table );
+  EXPECT_FALSE( SFDP::parseBasicTable( bytes.data(), table.size(), info ) );
+
+  table[ 1 ] = 0x80000000u | ( ( 8 * sizeof( size_t ) ) + 3 );
+  bytes      = toBytes( table );
+  EXPECT_FALSE( SFDP::parseBasicTable( bytes.data(), table.size(), info ) );
+}
+
+TEST( SFDP, SFDP_RejectsPartsNeedingFourByteAddresses )
+{
+  SFDPInfo info;
+  auto table = BASIC;
+
+  /*-------------------------------------------------
+  4 byte addressing only
+  -------------------------------------------------*/
+  table[ 0 ] = ( table[ 0 ] & ~( 3u << 17 ) ) | ( 2u << 17 );
+  auto bytes = toBytes( table );
+  EXPECT_FALSE( SFDP::parseBasicTable( bytes.data(), table.size(), info ) );
+  EXPECT_EQ( 4u, info.addressBytes );
+
+  /*-------------------------------------------------
+  3 byte addressing, but too big to reach all of it
+  -------------------------------------------------*/
+  table      = BASIC;
+  table[ 1 ] = 0x80000000u | 28;
+  bytes      = toBytes( table );
+  EXPECT_FALSE( SFDP::parseBasicTable( bytes.data(), table.size(), info ) );
+}
+
+TEST( SFDP, SFDP_OriginalTableUsesFamilyTiming )
+{
+  SFDPInfo info;
+  const auto bytes = toBytes( BASIC );
+
+  /*-------------------------------------------------
+  JESD216 tables end before the timing DWORDs
+  -------------------------------------------------*/
+  ASSERT_TRUE( SFDP::parseBasicTable( bytes.data(), SFDP::BASIC_TABLE_MIN_DW, info ) );
+  EXPECT_EQ( PAGE_SIZE, info.pageSize );
+  EXPECT_EQ( 3u, info.numEraseTypes );
+
+  const auto family = familyTiming( info.size );
+  for ( size_t op = 0; op < family.size(); op++ )
+  {
+    EXPECT_EQ( family[ op ].typical, info.timing[ op ].typical );
+    EXPECT_EQ( family[ op ].maximum, info.timing[ op ].maximum );
+  }
+}
+
+TEST( SFDP, SFDP_EraseTypesSortedAndFiltered )
+{
+  SFDPInfo info;
+  auto table = BASIC;
+
+  /*-------------------------------------------------
+  64K first, a 256 byte type the planner can't use,
+  then 4K and an empty slot
+  -------------------------------------------------*/
+  table[ 7 ] = 0x8108D810;
+  table[ 8 ] = 0x0000200C;
+
+  const auto bytes = toBytes( table );
+  ASSERT_TRUE( SFDP::parseBasicTable( bytes.data(), table.size(), info ) );
+
+  ASSERT_EQ( 2u, info.numEraseTypes );
+  EXPECT_EQ( CHUNK_SIZE_4K, info.eraseTypes[ 0 ].size );
+  EXPECT_EQ( Operation::ERASE_4K, info.eraseTypes[ 0 ].op );
+  EXPECT_EQ( CHUNK_SIZE_64K, info.eraseTypes[ 1 ].size );
+  EXPECT_EQ( Operation::ERASE_64K, info.eraseTypes[ 1 ].op );
+}
+
+TEST( SFDP, SFDP_RecordsFastReadParameters )
+{
+  SFDPInfo info;
+  auto table = BASIC;
+
+  const auto modeOf = [ &info ]( const ReadMode mode ) { return info.readModes[ static_cast<size_t>( mode ) ]; };
+
+  auto bytes = toBytes( table );
+  ASSERT_TRUE( SFDP::parseBasicTable( bytes.data(), table.size(), info ) );
+
+  EXPECT_TRUE( modeOf( ReadMode::SINGLE_1_1_1 ).supported );
+  EXPECT_EQ( Command::READ_ARRAY_HS, modeOf( ReadMode::SINGLE_1_1_1 ).opcode );
+
+  EXPECT_TRUE( modeOf( ReadMode::DUAL_1_1_2 ).supported );
+  EXPECT_EQ( 0x3B, modeOf( ReadMode::DUAL_1_1_2 ).opcode );
+  EXPECT_EQ( 0u, modeOf( ReadMode::DUAL_1_1_2 ).modeClocks );
+  EXPECT_EQ( 8u, modeOf( ReadMode::DUAL_1_1_2 ).dummyClocks );
+
+  EXPECT_TRUE( modeOf( ReadMode::DUAL_1_2_2 ).supported );
+  EXPECT_EQ( 0xBB, modeOf( ReadMode::DUAL_1_2_2 ).opcode );
+  EXPECT_EQ( 4u, modeOf( ReadMode::DUAL_1_2_2 ).modeClocks );
+  EXPECT_EQ( 0u, modeOf( ReadMode::DUAL_1_2_2 ).dummyClocks );
+
+  EXPECT_TRUE( modeOf( ReadMode::QUAD_1_1_4 ).supported );
+  EXPECT_EQ( 0x6B, modeOf( ReadMode::QUAD_1_1_4 ).opcode );
+  EXPECT_EQ( 0u, modeOf( ReadMode::QUAD_1_1_4 ).modeClocks );
+  EXPECT_EQ( 8u, modeOf( ReadMode::QUAD_1_1_4 ).dummyClocks );
+
+  EXPECT_TRUE( modeOf( ReadMode::QUAD_1_4_4 ).supported );
+  EXPECT_EQ( 0xEB, modeOf( ReadMode::QUAD_1_4_4 ).opcode );
+  EXPECT_EQ( 2u, modeOf( ReadMode::QUAD_1_4_4 ).modeClocks );
+  EXPECT_EQ( 4u, modeOf( ReadMode::QUAD_1_4_4 ).dummyClocks );
+
+  /*-------------------------------------------------
+  A mode the part doesn't claim stays unsupported,
+  whatever its parameter slot holds
+  -------------------------------------------------*/
+  table[ 0 ] &= ~( 1u << 22 );
+  bytes = toBytes( table );
+  ASSERT_TRUE( SFDP::parseBasicTable( bytes.data(), table.size(), info ) );
+  EXPECT_FALSE( modeOf( ReadMode::QUAD_1_1_4 ).supported );
+  EXPECT_TRUE( modeOf( ReadMode::QUAD_1_4_4 ).supported );
+}
+
+TEST( SFDP, SFDP_RejectsUnusableTables )
+{
+  SFDPInfo info;
+  auto table = BASIC;
+  auto bytes = toBytes( table );
+
+  EXPECT_FALSE( SFDP::parseBasicTable( nullptr, table.size(), info ) );
+  EXPECT_FALSE( SFDP::parseBasicTable( bytes.data(), SFDP::BASIC_TABLE_MIN_DW - 1, info ) );
+  EXPECT_FALSE( info.valid );
+
+  /*-------------------------------------------------
+  Nothing to erase with
+  -------------------------------------------------*/
+  table[ 7 ] = 0;
+  table[ 8 ] = 0;
+  bytes      = toBytes( table );
+  EXPECT_FALSE( SFDP::parseBasicTable( bytes.data(), table.size(), info ) );
+  EXPECT_EQ( 0u, info.numEraseTypes );
+}
+
+/*-------------------------------------------------
+Discovery
+-------------------------------------------------*/
+TEST_F( SimulatedAT25, SFDP_UnknownPartRunsFromTables )
+{
+  std::array<uint8_t, 64> data;
+  std::array<uint8_t, 64> readData;
+
+  pattern( data, 21 );
+  sim.setJedecID( 0x1F8901 );
+
+  /*-------------------------------------------------
+  No traits exist for this ID, so everything has to
+  come from what the part reports about itself.
+  -------------------------------------------------*/
+  passInit();
+
+  const auto desc = flash->getDescriptor();
+  EXPECT_EQ( Device::UNKNOWN, desc->device );
+  EXPECT_EQ( 0x1F8901u, desc->jedecID );
+  EXPECT_EQ( 8 * MBIT, desc->size );
+  EXPECT_EQ( 3u, desc->numEraseTypes );
+  EXPECT_EQ( 640000u, desc->timing[ static_cast<size_t>( Operation::ERASE_64K ) ].typical );
+
+  ASSERT_EQ( Status::ERR_OK, flash->erase( CHUNK_SIZE_4K, CHUNK_SIZE_4K ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( CHUNK_SIZE_4K, data.data(), data.size() ) );
+  ASSERT_EQ( Status::ERR_OK, flash->read( CHUNK_SIZE_4K, readData.data(), readData.size() ) );
+  EXPECT_EQ( 0, memcmp( readData.data(), data.data(), data.size() ) );
+}
+
+TEST_F( SimulatedAT25, SFDP_FloatingBusNotDiscovered )
+{
+  sim.setJedecID( 0xFFFFFF );
+  EXPECT_FALSE( flash->configure( CHANNEL ) );
+}
@@ -0,0 +1,177 @@
+/********************************************************************************
+ *  File Name:
+ *    test_at25_simulator.cpp
+ *
+ *  Description:
+ *    Runs the AT25 driver against the behavioral device simulator
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <cstring>
+
+/* Adesto Includes */
+#include <Adesto/at25/at25_commands.hpp>
+#include <Adesto/at25/at25_driver.hpp>
+
+/* Test Includes */
+#include <gtest/gtest.h>
+#include "test_fixtures_at25.hpp"
+
+using namespace Adesto::AT25;
+
+/*-------------------------------------------------
+Bus Routing
+-------------------------------------------------*/
+TEST_F( SimulatedAT25, Simulator_ConfigureIdentifiesPart )
+{
+  passInit();
+
+  DeviceInfo info;
+  ASSERT_TRUE( flash->readDeviceInfo( info ) );
+  EXPECT_EQ( 0x001F8501u, info.jedecID );
+  EXPECT_EQ( Device::AT25SF081, flash->getDescriptor()->device );
+  EXPECT_GT( sim.getStats().transactions, 0u );
+}
+
+TEST_F( SimulatedAT25, Simulator_FloatingBusFailsConfigure )
+{
+  Host::attach( CHANNEL, nullptr );
+  EXPECT_FALSE( flash->configure( CHANNEL ) );
+}
+
+TEST_F( SimulatedAT25, Simulator_OtherChannelIsolated )
+{
+  Simulator other;
+  Host::attach( Chimera::SPI::Channel::SPI2, &other );
+  passInit();
+
+  std::array<uint8_t, 16> data;
+  pattern( data, 3 );
+
+  ASSERT_EQ( Status::ERR_OK, flash->write( 0, data.data(), data.size() ) );
+  EXPECT_EQ( 0, memcmp( sim.memory(), data.data(), data.size() ) );
+  EXPECT_EQ( 0u, other.getStats().transactions );
+}
+
+/*-------------------------------------------------
+Functional Behavior
+-------------------------------------------------*/
+TEST_F( SimulatedAT25, Simulator_WriteReadBack )
+{
+  static constexpr size_t address = 300;
+  static constexpr size_t len     = 1000;
+
+  std::array<uint8_t, len> writeData;
+  std::array<uint8_t, len> readData;
+
+  pattern( writeData, 7 );
+  readData.fill( 0 );
+  passInit();
+
+  ASSERT_EQ( Status::ERR_OK, flash->write( address, writeData.data(), len ) );
+  ASSERT_EQ( Status::ERR_OK, flash->read( address, readData.data(), len ) );
+
+  EXPECT_EQ( 0, memcmp( readData.data(), writeData.data(), len ) );
+  EXPECT_EQ( 0, memcmp( sim.memory() + address, writeData.data(), len ) );
+  EXPECT_TRUE( filled( 0, address, 0xFF ) );
+  EXPECT_TRUE( filled( address + len, PAGE_SIZE, 0xFF ) );
+}
+
+TEST_F( SimulatedAT25, Simulator_ProgramOnlyClearsBits )
+{
+  const uint8_t hi = 0xF0;
+  const uint8_t lo = 0x0F;
+  uint8_t result   = 0xFF;
+
+  passInit();
+
+  ASSERT_EQ( Status::ERR_OK, flash->write( 17, &hi, 1 ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 17, &lo, 1 ) );
+  ASSERT_EQ( Status::ERR_OK, flash->read( 17, &result, 1 ) );
+
+  EXPECT_EQ( 0x00, result );
+  EXPECT_EQ( 0xFF, sim.memory()[ 16 ] );
+  EXPECT_EQ( 0xFF, sim.memory()[ 18 ] );
+}
+
+TEST_F( SimulatedAT25, Simulator_EraseRestoresOnes )
+{
+  passInit();
+  memset( sim.memory(), 0, 3 * BLOCK_SIZE );
+
+  ASSERT_EQ( Status::ERR_OK, flash->erase( BLOCK_SIZE, BLOCK_SIZE ) );
+
+  EXPECT_TRUE( filled( 0, BLOCK_SIZE, 0x00 ) );
+  EXPECT_TRUE( filled( BLOCK_SIZE, BLOCK_SIZE, 0xFF ) );
+  EXPECT_TRUE( filled( 2 * BLOCK_SIZE, BLOCK_SIZE, 0x00 ) );
+  EXPECT_EQ( 1u, sim.getStats().erases );
+}
+
+TEST_F( SimulatedAT25, Simulator_ChipEraseRunsInSimulatedTime )
+{
+  passInit();
+  memset( sim.memory(), 0, sim.size() );
+
+  ASSERT_EQ( Status::ERR_OK, flash->eraseChip() );
+  ASSERT_EQ( Status::ERR_OK, flash->pendEvent( Aurora::Memory::Event::MEM_ERASE_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK ) );
+
+  EXPECT_FALSE( sim.busy() );
+  EXPECT_TRUE( filled( 0, sim.size(), 0xFF ) );
+  EXPECT_GE( Host::now(), OperationTimes[ static_cast<size_t>( Operation::ERASE_CHIP ) ].typical );
+}
+
+/*-------------------------------------------------
+Timing
+-------------------------------------------------*/
+TEST_F( SimulatedAT25, Simulator_BusyFollowsOperationTime )
+{
+  static constexpr size_t programTime = 2000;
+
+  std::array<uint8_t, PAGE_SIZE> data;
+  pattern( data, 1 );
+
+  sim.setOperationTime( Operation::PAGE_PROGRAM, programTime );
+  passInit();
+
+  ASSERT_EQ( Status::ERR_OK, flash->setAsync( true ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 0, data.data(), data.size() ) );
+  EXPECT_TRUE( sim.busy() );
+
+  Host::advance( programTime - 1 );
+  EXPECT_TRUE( sim.busy() );
+
+  Host::advance( 1 );
+  EXPECT_FALSE( sim.busy() );
+}
+
+TEST_F( SimulatedAT25, Simulator_IgnoresCommandsWhileBusy )
+{
+  std::array<uint8_t, 4> first  = { 0xF0, 0xF0, 0xF0, 0xF0 };
+  std::array<uint8_t, 4> second = { 0x0F, 0x0F, 0x0F, 0x0F };
+
+  passInit();
+  ASSERT_EQ( Status::ERR_OK, flash->setAsync( true ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 0, first.data(), first.size() ) );
+  ASSERT_TRUE( sim.busy() );
+
+  /*-------------------------------------------------
+  Go around the driver, which would wait for idle
+  -------------------------------------------------*/
+  const uint8_t wren                                            = Command::WRITE_ENABLE;
+  const std::array<uint8_t, Command::PAGE_PROGRAM_OPS_LEN> prog = { Command::PAGE_PROGRAM, 0, 0, 0 };
+
+  sim.setChipSelect( Chimera::GPIO::State::LOW );
+  sim.writeBytes( &wren, 1 );
+  sim.setChipSelect( Chimera::GPIO::State::HIGH );
+
+  sim.setChipSelect( Chimera::GPIO::State::LOW );
+  sim.writeBytes( prog.data(), prog.size() );
+  sim.writeBytes( second.data(), second.size() );
+  sim.setChipSelect( Chimera::GPIO::State::HIGH );
+
+  EXPECT_EQ( 0, memcmp( sim.memory(), first.data(), first.size() ) );
+  EXPECT_EQ( 1u, sim.getStats().programs );
+}
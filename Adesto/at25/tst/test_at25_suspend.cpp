@@ -0,0 +1,218 @@
+/********************************************************************************
+ *  File Name:
+ *    test_at25_suspend.cpp
+ *
+ *  Description:
+ *    Tests program/erase suspend and resume on the AT25 driver
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <cstring>
+
+/* Adesto Includes */
+#include <Adesto/at25/at25_driver.hpp>
+
+/* Test Includes */
+#include <gtest/gtest.h>
+#include "test_fixtures_at25.hpp"
+
+using namespace Adesto;
+using namespace Adesto::AT25;
+
+/*-------------------------------------------------
+Long enough that nothing in these tests finishes it
+by accident, short enough to keep the sim clock sane.
+-------------------------------------------------*/
+static constexpr size_t ERASE_TIME = 600000;
+
+/**
+ *  Starts a background erase of the first 64K block, which is a single
+ *  step that stays busy for ERASE_TIME
+ */
+static void startBlockErase( Simulator &sim, Driver *const flash )
+{
+  sim.setOperationTime( Operation::ERASE_64K, ERASE_TIME );
+  memset( sim.memory(), 0, 2 * CHUNK_SIZE_64K );
+
+  ASSERT_EQ( Status::ERR_OK, flash->setAsync( true ) );
+  ASSERT_EQ( Status::ERR_OK, flash->erase( 0, CHUNK_SIZE_64K ) );
+  ASSERT_TRUE( sim.busy() );
+}
+
+/*-------------------------------------------------
+Suspend and Resume
+-------------------------------------------------*/
+TEST_F( SimulatedAT25, Suspend_NothingInProgress )
+{
+  passInit();
+
+  EXPECT_EQ( Status::ERR_OK, flash->suspend() );
+  EXPECT_FALSE( flash->isSuspended() );
+  EXPECT_EQ( 0u, sim.getStats().suspends );
+
+  EXPECT_EQ( Status::ERR_OK, flash->resume() );
+  EXPECT_FALSE( flash->isSuspended() );
+}
+
+TEST_F( SimulatedAT25, Suspend_PausesBackgroundErase )
+{
+  passInit();
+  startBlockErase( sim, flash );
+
+  ASSERT_EQ( Status::ERR_OK, flash->suspend() );
+  EXPECT_TRUE( flash->isSuspended() );
+  EXPECT_EQ( 1u, sim.getStats().suspends );
+
+  /*-------------------------------------------------
+  The job sits still while suspended, however long it
+  is left there.
+  -------------------------------------------------*/
+  Host::advance( 2 * ERASE_TIME );
+  flash->process();
+  EXPECT_TRUE( flash->isSuspended() );
+
+  ASSERT_EQ( Status::ERR_OK, flash->resume() );
+  EXPECT_FALSE( flash->isSuspended() );
+  EXPECT_TRUE( sim.busy() );
+
+  ASSERT_EQ( Status::ERR_OK, flash->pendEvent( Aurora::Memory::Event::MEM_ERASE_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK ) );
+  EXPECT_FALSE( sim.busy() );
+  EXPECT_TRUE( filled( 0, CHUNK_SIZE_64K, 0xFF ) );
+}
+
+TEST_F( SimulatedAT25, Suspend_TooLateIsNotAnError )
+{
+  passInit();
+  startBlockErase( sim, flash );
+
+  /*-------------------------------------------------
+  The erase finished before the command arrived
+  -------------------------------------------------*/
+  Host::advance( ERASE_TIME );
+  EXPECT_EQ( Status::ERR_OK, flash->suspend() );
+  EXPECT_FALSE( flash->isSuspended() );
+  EXPECT_EQ( 0u, sim.getStats().suspends );
+}
+
+/*-------------------------------------------------
+Reads While Suspended
+-------------------------------------------------*/
+TEST_F( SimulatedAT25, Suspend_ReadsLeaveUserSuspendInPlace )
+{
+  std::array<uint8_t, 16> readData;
+
+  passInit();
+  startBlockErase( sim, flash );
+  memset( sim.memory() + CHUNK_SIZE_64K, 0x5A, readData.size() );
+
+  ASSERT_EQ( Status::ERR_OK, flash->suspend() );
+
+  for ( size_t pass = 0; pass < 2; pass++ )
+  {
+    readData.fill( 0 );
+    ASSERT_EQ( Status::ERR_OK, flash->read( CHUNK_SIZE_64K, readData.data(), readData.size() ) );
+    EXPECT_TRUE( std::all_of( readData.begin(), readData.end(), []( const uint8_t x ) { return x == 0x5A; } ) );
+  }
+
+  EXPECT_TRUE( flash->isSuspended() );
+  EXPECT_EQ( 1u, sim.getStats().suspends );
+}
+
+TEST_F( SimulatedAT25, Suspend_ReadLatencyDuringErase )
+{
+  std::array<uint8_t, PAGE_SIZE> readData;
+
+  passInit();
+  startBlockErase( sim, flash );
+
+  /*-------------------------------------------------
+  A read outside the erase only waits out the suspend
+  latency, rather than the rest of the erase. Simulated
+  time doesn't include clocking the bytes, so this is
+  the cost on top of the transfer itself.
+  -------------------------------------------------*/
+  const size_t start = Host::now();
+  ASSERT_EQ( Status::ERR_OK, flash->read( CHUNK_SIZE_64K, readData.data(), readData.size() ) );
+  const size_t latency = Host::now() - start;
+
+  EXPECT_LE( latency, SUSPEND_LATENCY );
+  EXPECT_EQ( 1u, sim.getStats().suspends );
+  EXPECT_FALSE( flash->isSuspended() );
+  EXPECT_TRUE( sim.busy() );
+
+  /*-------------------------------------------------
+  The same read inside the erase has to wait it out
+  -------------------------------------------------*/
+  startBlockErase( sim, flash );
+
+  const size_t blockedStart = Host::now();
+  ASSERT_EQ( Status::ERR_OK, flash->read( 0, readData.data(), readData.size() ) );
+  EXPECT_GE( Host::now() - blockedStart, ERASE_TIME - latency );
+}
+
+/*-------------------------------------------------
+Automatic Resume
+-------------------------------------------------*/
+TEST_F( SimulatedAT25, Suspend_WriteResumesFirst )
+{
+  std::array<uint8_t, 32> data;
+  pattern( data, 9 );
+
+  passInit();
+  startBlockErase( sim, flash );
+  ASSERT_EQ( Status::ERR_OK, flash->suspend() );
+
+  /*-------------------------------------------------
+  The device ignores programs while an erase is parked,
+  so the erase has to be resumed and finished first.
+  -------------------------------------------------*/
+  ASSERT_EQ( Status::ERR_OK, flash->write( 2 * CHUNK_SIZE_64K, data.data(), data.size() ) );
+  ASSERT_EQ( Status::ERR_OK, flash->pendEvent( Aurora::Memory::Event::MEM_WRITE_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK ) );
+
+  EXPECT_FALSE( flash->isSuspended() );
+  EXPECT_TRUE( filled( 0, CHUNK_SIZE_64K, 0xFF ) );
+  EXPECT_EQ( 1u, sim.getStats().programs );
+  EXPECT_EQ( 0, memcmp( sim.memory() + ( 2 * CHUNK_SIZE_64K ), data.data(), data.size() ) );
+}
+
+TEST_F( SimulatedAT25, Suspend_EraseResumesFirst )
+{
+  passInit();
+  startBlockErase( sim, flash );
+  ASSERT_EQ( Status::ERR_OK, flash->suspend() );
+
+  ASSERT_EQ( Status::ERR_OK, flash->erase( CHUNK_SIZE_64K, CHUNK_SIZE_4K ) );
+  ASSERT_EQ( Status::ERR_OK, flash->pendEvent( Aurora::Memory::Event::MEM_ERASE_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK ) );
+
+  EXPECT_FALSE( flash->isSuspended() );
+  EXPECT_EQ( 2u, sim.getStats().erases );
+  EXPECT_TRUE( filled( 0, CHUNK_SIZE_64K + CHUNK_SIZE_4K, 0xFF ) );
+  EXPECT_TRUE( filled( CHUNK_SIZE_64K + CHUNK_SIZE_4K, CHUNK_SIZE_4K, 0x00 ) );
+}
+
+TEST_F( SimulatedAT25, Suspend_ChipEraseResumedByWait )
+{
+  uint8_t value = 0;
+
+  passInit();
+  sim.setOperationTime( Operation::ERASE_CHIP, ERASE_TIME );
+  memset( sim.memory(), 0, CHUNK_SIZE_64K );
+
+  /*-------------------------------------------------
+  A chip erase leaves no job behind, so the suspend is
+  only undone by waiting on the erase.
+  -------------------------------------------------*/
+  ASSERT_EQ( Status::ERR_OK, flash->eraseChip() );
+  ASSERT_EQ( Status::ERR_OK, flash->suspend() );
+  EXPECT_TRUE( flash->isSuspended() );
+
+  ASSERT_EQ( Status::ERR_OK, flash->pendEvent( Aurora::Memory::Event::MEM_ERASE_COMPLETE, Chimera::Threading::TIMEOUT_BLOCK ) );
+  EXPECT_FALSE( flash->isSuspended() );
+  EXPECT_FALSE( sim.busy() );
+
+  ASSERT_EQ( Status::ERR_OK, flash->read( 0, &value, 1 ) );
+  EXPECT_EQ( 0xFF, value );
+}
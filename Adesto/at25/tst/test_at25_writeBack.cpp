@@ -0,0 +1,245 @@
+/********************************************************************************
+ *  File Name:
+ *    test_at25_writeBack.cpp
+ *
+ *  Description:
+ *    Tests write-back buffering of small writes on the AT25 driver
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <cstring>
+
+/* Adesto Includes */
+#include <Adesto/at25/at25_driver.hpp>
+
+/* Test Includes */
+#include <gtest/gtest.h>
+#include "test_fixtures_at25.hpp"
+
+using namespace Adesto::AT25;
+
+/*-------------------------------------------------
+Merging
+-------------------------------------------------*/
+TEST_F( SimulatedAT25, WriteBack_SmallWritesCoalesce )
+{
+  std::array<uint8_t, 40> data;
+  pattern( data, 2 );
+
+  passInit();
+  ASSERT_EQ( Status::ERR_OK, flash->setWriteBack( true ) );
+
+  for ( size_t x = 0; x < data.size(); x += 10 )
+  {
+    ASSERT_EQ( Status::ERR_OK, flash->write( 20 + x, data.data() + x, 10 ) );
+  }
+
+  EXPECT_EQ( 0u, sim.getStats().programs );
+  EXPECT_TRUE( filled( 0, PAGE_SIZE, 0xFF ) );
+
+  ASSERT_EQ( Status::ERR_OK, flash->flush() );
+  EXPECT_EQ( 1u, sim.getStats().programs );
+  EXPECT_EQ( 0, memcmp( sim.memory() + 20, data.data(), data.size() ) );
+  EXPECT_TRUE( filled( 0, 20, 0xFF ) );
+  EXPECT_TRUE( filled( 20 + data.size(), PAGE_SIZE - 20 - data.size(), 0xFF ) );
+}
+
+TEST_F( SimulatedAT25, WriteBack_OverlappingWritesOnlyClearBits )
+{
+  const uint8_t hi = 0xF0;
+  const uint8_t lo = 0x3F;
+
+  passInit();
+  ASSERT_EQ( Status::ERR_OK, flash->setWriteBack( true ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 5, &hi, 1 ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 5, &lo, 1 ) );
+  ASSERT_EQ( Status::ERR_OK, flash->flush() );
+
+  EXPECT_EQ( 1u, sim.getStats().programs );
+  EXPECT_EQ( 0x30, sim.memory()[ 5 ] );
+}
+
+TEST_F( SimulatedAT25, WriteBack_ReadOverlaysPendingData )
+{
+  std::array<uint8_t, 16> data;
+  std::array<uint8_t, 48> readData;
+
+  pattern( data, 4 );
+  passInit();
+
+  sim.memory()[ 40 ] = 0x0F;
+  ASSERT_EQ( Status::ERR_OK, flash->setWriteBack( true ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 32, data.data(), data.size() ) );
+  ASSERT_EQ( Status::ERR_OK, flash->read( 16, readData.data(), readData.size() ) );
+
+  EXPECT_EQ( 0u, sim.getStats().programs );
+  EXPECT_TRUE( std::all_of( readData.begin(), readData.begin() + 16, []( const uint8_t x ) { return x == 0xFF; } ) );
+  EXPECT_EQ( 0, memcmp( readData.data() + 16, data.data(), 8 ) );
+  EXPECT_EQ( data[ 8 ] & 0x0F, readData[ 24 ] );
+  EXPECT_EQ( 0, memcmp( readData.data() + 25, data.data() + 9, 7 ) );
+}
+
+/*-------------------------------------------------
+Page Boundaries
+-------------------------------------------------*/
+TEST_F( SimulatedAT25, WriteBack_PageCrossingCommitsFirstPage )
+{
+  std::array<uint8_t, 100> data;
+  pattern( data, 6 );
+
+  passInit();
+  ASSERT_EQ( Status::ERR_OK, flash->setWriteBack( true ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( PAGE_SIZE - 56, data.data(), data.size() ) );
+
+  /*-------------------------------------------------
+  The head is programmed on moving to the next page,
+  while the tail waits in the buffer.
+  -------------------------------------------------*/
+  EXPECT_EQ( 1u, sim.getStats().programs );
+  EXPECT_EQ( 0, memcmp( sim.memory() + PAGE_SIZE - 56, data.data(), 56 ) );
+  EXPECT_TRUE( filled( PAGE_SIZE, PAGE_SIZE, 0xFF ) );
+
+  ASSERT_EQ( Status::ERR_OK, flash->flush() );
+  EXPECT_EQ( 2u, sim.getStats().programs );
+  EXPECT_EQ( 0, memcmp( sim.memory() + PAGE_SIZE - 56, data.data(), data.size() ) );
+}
+
+TEST_F( SimulatedAT25, WriteBack_WholePagesBypassBuffer )
+{
+  std::array<uint8_t, 600> data;
+  pattern( data, 8 );
+
+  passInit();
+  ASSERT_EQ( Status::ERR_OK, flash->setWriteBack( true ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 100, data.data(), data.size() ) );
+
+  /*-------------------------------------------------
+  156 bytes buffered in page 0 and programmed when the
+  write moves on, page 1 goes straight out, and the
+  last 188 bytes wait in the buffer.
+  -------------------------------------------------*/
+  EXPECT_EQ( 2u, sim.getStats().programs );
+  EXPECT_EQ( 0, memcmp( sim.memory() + 100, data.data(), data.size() - 188 ) );
+  EXPECT_TRUE( filled( 2 * PAGE_SIZE, 188, 0xFF ) );
+
+  ASSERT_EQ( Status::ERR_OK, flash->flush() );
+  EXPECT_EQ( 3u, sim.getStats().programs );
+  EXPECT_EQ( 0, memcmp( sim.memory() + 100, data.data(), data.size() ) );
+}
+
+/*-------------------------------------------------
+Flush Triggers
+-------------------------------------------------*/
+TEST_F( SimulatedAT25, WriteBack_ThresholdFlushes )
+{
+  std::array<uint8_t, 16> data;
+  pattern( data, 1 );
+
+  passInit();
+  ASSERT_EQ( Status::ERR_OK, flash->setWriteBack( true, 32 ) );
+
+  ASSERT_EQ( Status::ERR_OK, flash->write( 0, data.data(), data.size() ) );
+  EXPECT_EQ( 0u, sim.getStats().programs );
+
+  ASSERT_EQ( Status::ERR_OK, flash->write( 64, data.data(), data.size() - 1 ) );
+  EXPECT_EQ( 0u, sim.getStats().programs );
+
+  ASSERT_EQ( Status::ERR_OK, flash->write( 128, data.data(), 1 ) );
+  EXPECT_EQ( 1u, sim.getStats().programs );
+  EXPECT_EQ( data[ 0 ], sim.memory()[ 128 ] );
+}
+
+TEST_F( SimulatedAT25, WriteBack_TimeoutFlushesFromProcess )
+{
+  static constexpr size_t timeout = 10;
+
+  const uint8_t value = 0x55;
+
+  passInit();
+  ASSERT_EQ( Status::ERR_OK, flash->setWriteBack( true, PAGE_SIZE, timeout ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 3, &value, 1 ) );
+
+  flash->process();
+  EXPECT_EQ( 0u, sim.getStats().programs );
+
+  Host::advance( ( timeout - 1 ) * 1000 );
+  flash->process();
+  EXPECT_EQ( 0u, sim.getStats().programs );
+
+  Host::advance( 1000 );
+  flash->process();
+  EXPECT_EQ( 1u, sim.getStats().programs );
+  EXPECT_EQ( value, sim.memory()[ 3 ] );
+}
+
+TEST_F( SimulatedAT25, WriteBack_FailedFlushKeepsData )
+{
+  static constexpr size_t timeout = 10;
+  static constexpr size_t stuck   = 10000000;
+
+  const uint8_t value = 0x55;
+
+  passInit();
+  ASSERT_EQ( Status::ERR_OK, flash->setWriteBack( true, PAGE_SIZE, timeout ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 3, &value, 1 ) );
+
+  /*-------------------------------------------------
+  The timed flush never sees the program finish
+  -------------------------------------------------*/
+  sim.setOperationTime( Operation::PAGE_PROGRAM, stuck );
+  Host::advance( timeout * 1000 );
+  flash->process();
+  EXPECT_EQ( 1u, sim.getStats().programs );
+
+  /*-------------------------------------------------
+  Nothing was lost or retried in the background, and
+  the next flush programs the page again and reports
+  the earlier failure.
+  -------------------------------------------------*/
+  Host::advance( stuck );
+  flash->process();
+  EXPECT_EQ( 1u, sim.getStats().programs );
+
+  sim.setOperationTime( Operation::PAGE_PROGRAM, 100 );
+  EXPECT_EQ( Status::ERR_TIMEOUT, flash->flush() );
+  EXPECT_EQ( 2u, sim.getStats().programs );
+  EXPECT_EQ( value, sim.memory()[ 3 ] );
+
+  EXPECT_EQ( Status::ERR_OK, flash->flush() );
+  EXPECT_EQ( 2u, sim.getStats().programs );
+}
+
+TEST_F( SimulatedAT25, WriteBack_NoTimeoutWaitsForFlush )
+{
+  const uint8_t value = 0x55;
+
+  passInit();
+  ASSERT_EQ( Status::ERR_OK, flash->setWriteBack( true ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 3, &value, 1 ) );
+
+  Host::advance( 1000000 );
+  flash->process();
+  EXPECT_EQ( 0u, sim.getStats().programs );
+}
+
+TEST_F( SimulatedAT25, WriteBack_DisableAndCloseFlush )
+{
+  const uint8_t value = 0x00;
+
+  passInit();
+  ASSERT_EQ( Status::ERR_OK, flash->setWriteBack( true ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 1, &value, 1 ) );
+  ASSERT_EQ( Status::ERR_OK, flash->setWriteBack( false ) );
+  EXPECT_EQ( 1u, sim.getStats().programs );
+
+  ASSERT_EQ( Status::ERR_OK, flash->setWriteBack( true ) );
+  ASSERT_EQ( Status::ERR_OK, flash->write( 2, &value, 1 ) );
+  ASSERT_EQ( Status::ERR_OK, flash->close() );
+  EXPECT_EQ( 2u, sim.getStats().programs );
+
+  EXPECT_EQ( 0x00, sim.memory()[ 1 ] );
+  EXPECT_EQ( 0x00, sim.memory()[ 2 ] );
+}
@@ -0,0 +1,32 @@
+/********************************************************************************
+ *  File Name:
+ *    test_fixtures_at25.cpp
+ *
+ *  Description:
+ *    Provides the test fixtures used in testing the AT25 driver
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* Test Includes */
+#include "test_fixtures_at25.hpp"
+
+void SimulatedAT25::SetUp()
+{
+  Adesto::AT25::Host::reset();
+  Adesto::AT25::Host::attach( CHANNEL, &sim );
+
+  flash = new Adesto::AT25::Driver();
+}
+
+void SimulatedAT25::TearDown()
+{
+  delete flash;
+  Adesto::AT25::Host::reset();
+}
+
+void SimulatedAT25::passInit()
+{
+  ASSERT_TRUE( flash->configure( CHANNEL ) );
+  ASSERT_NE( nullptr, flash->getDescriptor() );
+}
@@ -0,0 +1,78 @@
+/********************************************************************************
+ *  File Name:
+ *    test_fixtures_at25.hpp
+ *
+ *  Description:
+ *    Provides the test fixtures used in testing the AT25 driver
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+#pragma once
+#ifndef ADESTO_AT25_TEST_FIXTURES_HPP
+#define ADESTO_AT25_TEST_FIXTURES_HPP
+
+/* STL Includes */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+
+/* Adesto Includes */
+#include <Adesto/at25/at25_driver.hpp>
+
+/* Test Includes */
+#include <gtest/gtest.h>
+#include "sim_at25.hpp"
+#include "sim_at25_host.hpp"
+
+using Status = Aurora::Memory::Status;
+
+/**
+ *  Runs the unmodified driver against the behavioral simulator. The host
+ *  backend routes the SPI channel the driver is configured on into the
+ *  simulator, and time only moves when the driver sleeps or a test calls
+ *  Host::advance(), so datasheet timing doesn't slow the tests down.
+ */
+class SimulatedAT25 : public ::testing::Test
+{
+protected:
+  static constexpr Chimera::SPI::Channel CHANNEL = Chimera::SPI::Channel::SPI1;
+
+  Adesto::AT25::Simulator sim;
+  Adesto::AT25::Driver *flash;
+
+  SimulatedAT25()          = default;
+  virtual ~SimulatedAT25() = default;
+
+  virtual void SetUp();
+
+  virtual void TearDown();
+
+  void passInit();
+
+  /**
+   *  Fills a buffer with a pattern that differs between seeds and never
+   *  repeats within a page, so misplaced bytes can't go unnoticed.
+   */
+  template<size_t L>
+  void pattern( std::array<uint8_t, L> &data, const uint8_t seed )
+  {
+    for ( size_t x = 0; x < L; x++ )
+    {
+      data[ x ] = static_cast<uint8_t>( ( x * 7 ) + ( x >> 8 ) + seed );
+    }
+  }
+
+  /**
+   *  Checks a range of the simulated array holds a single value
+   */
+  bool filled( const size_t address, const size_t length, const uint8_t value )
+  {
+    const uint8_t *mem = sim.memory() + address;
+    return std::all_of( mem, mem + length, [ value ]( const uint8_t x ) { return x == value; } );
+  }
+};
+
+#endif /* !ADESTO_AT25_TEST_FIXTURES_HPP */
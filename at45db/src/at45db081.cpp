@@ -9,6 +9,7 @@
  ********************************************************************************/
 
 /* C/C++ Includes */
+#include <algorithm>
 #include <memory>
 
 /* Driver Includes */
@@ -50,6 +51,7 @@ struct FlashDelay
   uint8_t blockErase;
   uint16_t sectorErase;
   uint16_t chipErase;
+  uint16_t bufferTransfer;
 };
 
 struct FlashSizes
@@ -90,10 +92,93 @@ namespace Adesto
           12,    // Page erase
           30,    // Block erase
           700,   // Sector erase
-          10000  // Chip erase
+          10000, // Chip erase
+          200    // Page to buffer transfer or compare, in microseconds
       },
     };
 
+    /*------------------------------------------------
+    Status polling rate once the expected completion time has passed. The
+    interval is a fraction of the typical operation time, but never so short
+    that the bus is flooded with status reads.
+    ------------------------------------------------*/
+    static constexpr uint32_t POLL_DIVISOR         = 32;
+    static constexpr uint32_t MIN_POLL_INTERVAL_US = 50;
+
+    /*------------------------------------------------
+    How many times longer than expected an operation may run before the chip
+    is considered stuck. The expectation is the slower of the datasheet value
+    and the slowest completion seen so far.
+    ------------------------------------------------*/
+    static constexpr uint32_t TIMEOUT_MULTIPLIER = 4;
+
+    /**
+     *  Looks up the datasheet completion time of an operation
+     *
+     *  @param[in]  chip        Which chip is being used
+     *  @param[in]  op          The operation to look up
+     *  @return uint32_t        Typical completion time in microseconds
+     */
+    static uint32_t typicalDelay( const FlashChip chip, const FlashOperation op )
+    {
+      const FlashDelay &delay = chipDelay[ static_cast<uint8_t>( chip ) ];
+      uint32_t ms             = 0;
+
+      switch ( op )
+      {
+        case FlashOperation::PAGE_ERASE_PROGRAM:
+          ms = delay.pageEraseAndProgramming;
+          break;
+
+        case FlashOperation::PAGE_PROGRAM:
+          ms = delay.pageProgramming;
+          break;
+
+        case FlashOperation::PAGE_ERASE:
+          ms = delay.pageErase;
+          break;
+
+        case FlashOperation::BLOCK_ERASE:
+          ms = delay.blockErase;
+          break;
+
+        case FlashOperation::SECTOR_ERASE:
+          ms = delay.sectorErase;
+          break;
+
+        case FlashOperation::CHIP_ERASE:
+          ms = delay.chipErase;
+          break;
+
+        case FlashOperation::BUFFER_TRANSFER:
+          return delay.bufferTransfer;
+
+        default:
+          break;
+      }
+
+      return ms * 1000u;
+    }
+
+    /**
+     *  Sleeps for a number of microseconds, handing longer waits to the
+     *  millisecond delay so an RTOS backend can schedule other work.
+     *
+     *  @param[in]  duration    How long to sleep in microseconds
+     *  @return void
+     */
+    static void sleepFor( const uint32_t duration )
+    {
+      if ( duration >= 1000u )
+      {
+        Chimera::delayMilliseconds( duration / 1000u );
+      }
+      else if ( duration )
+      {
+        Chimera::delayMicroseconds( duration );
+      }
+    }
+
     Chimera::Status_t AT45::init( const FlashChip chip, const uint32_t clockFreq )
     {
       Chimera::Status_t initResult = Chimera::CommonStatusCodes::FAIL;
@@ -189,6 +274,11 @@ namespace Adesto
         SPI_write( cmdBuffer.data(), BUFFER_LOAD_CMD_LEN, false );
         SPI_write( dataIn, len, true );
 
+        /*------------------------------------------------
+        There's no telling which page the new contents are meant for
+        ------------------------------------------------*/
+        sramState[ static_cast<uint8_t>( bufferNumber ) ] = {};
+
         if ( onComplete )
         {
           onComplete( 0 );
@@ -277,6 +367,88 @@ namespace Adesto
         buildReadWriteCommand( pageNumber, 0x0000 );
         SPI_write( cmdBuffer.data(), SRAM_COMMIT_CMD_LEN, true );
 
+        /*------------------------------------------------
+        Without the erase, the page ends up as the AND of its old
+        contents and the buffer, which matches neither.
+        ------------------------------------------------*/
+        if ( erase )
+        {
+          trackBuffer( bufferNumber, pageNumber );
+        }
+        else
+        {
+          invalidateBuffers( pageNumber, 1 );
+          sramState[ static_cast<uint8_t>( bufferNumber ) ] = {};
+        }
+
+        if ( onComplete )
+        {
+          onComplete( 0 );
+        }
+
+        error = Chimera::CommonStatusCodes::OK;
+      }
+
+      return error;
+    }
+
+    Chimera::Status_t AT45::sramTransfer( const SRAMBuffer bufferNumber, const uint16_t pageNumber,
+                                          Chimera::void_func_uint32_t onComplete )
+    {
+      Chimera::Status_t error = Chimera::CommonStatusCodes::FAIL;
+
+      if ( !chipInitialized )
+      {
+        error = Chimera::CommonStatusCodes::NOT_INITIALIZED;
+      }
+      else
+      {
+        static constexpr uint8_t PAGE_TRANSFER_CMD_LEN = 4; /**< CMD(1) + Address(3) */
+
+        /*------------------------------------------------
+        Only the page number is valid and the offset is ignored.
+        See: (11.1) 'Main Memory Page to Buffer Transfer'
+        ------------------------------------------------*/
+        cmdBuffer[ 0 ] = ( bufferNumber == SRAMBuffer::BUFFER1 ) ? MAIN_MEM_PAGE_TO_BUFFER1_TRANSFER
+                                                                 : MAIN_MEM_PAGE_TO_BUFFER2_TRANSFER;
+        buildReadWriteCommand( pageNumber, 0x0000 );
+        SPI_write( cmdBuffer.data(), PAGE_TRANSFER_CMD_LEN, true );
+
+        trackBuffer( bufferNumber, pageNumber );
+
+        if ( onComplete )
+        {
+          onComplete( 0 );
+        }
+
+        error = Chimera::CommonStatusCodes::OK;
+      }
+
+      return error;
+    }
+
+    Chimera::Status_t AT45::sramCompare( const SRAMBuffer bufferNumber, const uint16_t pageNumber,
+                                         Chimera::void_func_uint32_t onComplete )
+    {
+      Chimera::Status_t error = Chimera::CommonStatusCodes::FAIL;
+
+      if ( !chipInitialized )
+      {
+        error = Chimera::CommonStatusCodes::NOT_INITIALIZED;
+      }
+      else
+      {
+        static constexpr uint8_t PAGE_COMPARE_CMD_LEN = 4; /**< CMD(1) + Address(3) */
+
+        /*------------------------------------------------
+        Only the page number is valid and the offset is ignored.
+        See: (11.2) 'Main Memory Page to Buffer Compare'
+        ------------------------------------------------*/
+        cmdBuffer[ 0 ] = ( bufferNumber == SRAMBuffer::BUFFER1 ) ? MAIN_MEM_PAGE_TO_BUFFER1_COMPARE
+                                                                 : MAIN_MEM_PAGE_TO_BUFFER2_COMPARE;
+        buildReadWriteCommand( pageNumber, 0x0000 );
+        SPI_write( cmdBuffer.data(), PAGE_COMPARE_CMD_LEN, true );
+
         if ( onComplete )
         {
           onComplete( 0 );
@@ -420,6 +592,9 @@ namespace Adesto
         SPI_write( cmdBuffer.data(), MAIN_MEM_BYTE_PGM_CMD_LEN, false );
         SPI_write( dataIn, len, true );
 
+        invalidateBuffers( pageNumber, 1 );
+        sramState[ static_cast<uint8_t>( SRAMBuffer::BUFFER1 ) ] = {};
+
         if ( onComplete )
         {
           onComplete( 0 );
@@ -444,6 +619,28 @@ namespace Adesto
       {
         error = Chimera::CommonStatusCodes::INVAL_FUNC_PARAM;
       }
+      else if ( writeCompareEnabled )
+      {
+        /*------------------------------------------------
+        Split the operation up so the chip can check the result
+        of the buffer load before committing to a program cycle
+        ------------------------------------------------*/
+        error = sramLoad( bufferNumber, bufferOffset, dataIn, len );
+
+        if ( ( error == Chimera::CommonStatusCodes::OK ) && bufferMatchesPage( bufferNumber, pageNumber ) )
+        {
+          trackBuffer( bufferNumber, pageNumber );
+        }
+        else if ( error == Chimera::CommonStatusCodes::OK )
+        {
+          error = sramCommit( bufferNumber, pageNumber, true );
+        }
+
+        if ( onComplete )
+        {
+          onComplete( 0 );
+        }
+      }
       else
       {
         static constexpr uint8_t MAIN_MEM_PAGE_PGM_CMD_LEN = 4;
@@ -460,6 +657,8 @@ namespace Adesto
         SPI_write( cmdBuffer.data(), MAIN_MEM_PAGE_PGM_CMD_LEN, false );
         SPI_write( dataIn, len, true );
 
+        trackBuffer( bufferNumber, pageNumber );
+
         if ( onComplete )
         {
           onComplete( 0 );
@@ -500,6 +699,8 @@ namespace Adesto
         SPI_write( cmdBuffer.data(), READ_MODIFY_WRITE_CMD_LEN, false );
         SPI_write( dataIn, len, true );
 
+        trackBuffer( bufferNumber, pageNumber );
+
         if ( onComplete )
         {
           onComplete( 0 );
@@ -511,6 +712,113 @@ namespace Adesto
       return error;
     }
 
+    Chimera::Status_t AT45::copyPage( const uint32_t srcPage, const uint32_t dstPage, const uint16_t patchOffset,
+                                      const uint8_t *const patch, const uint32_t patchLen )
+    {
+      Chimera::Status_t error = Chimera::CommonStatusCodes::FAIL;
+      const uint32_t numPages = chipSpecs[ static_cast<uint8_t>( device ) ].numPages;
+
+      if ( !chipInitialized )
+      {
+        error = Chimera::CommonStatusCodes::NOT_INITIALIZED;
+      }
+      else if ( ( srcPage >= numPages ) || ( dstPage >= numPages ) || ( patchLen && !patch )
+                || ( ( patchOffset + patchLen ) > pageSize ) )
+      {
+        error = Chimera::CommonStatusCodes::INVAL_FUNC_PARAM;
+      }
+      else if ( ( srcPage == dstPage ) && !patchLen )
+      {
+        error = Chimera::CommonStatusCodes::OK;
+      }
+      else
+      {
+        /*------------------------------------------------
+        Buffered changes to the source have to be in main memory before
+        it's transferred, and buffered changes to the destination are
+        about to be replaced wholesale.
+        ------------------------------------------------*/
+        invalidateBuffers( dstPage, ( srcPage == dstPage ) ? 0 : 1 );
+        error = flushBuffers();
+
+        if ( error == Chimera::CommonStatusCodes::OK )
+        {
+          error = sramTransfer( SRAMBuffer::BUFFER1, static_cast<uint16_t>( srcPage ) );
+        }
+
+        if ( error == Chimera::CommonStatusCodes::OK )
+        {
+          error = awaitCompletion( FlashOperation::BUFFER_TRANSFER, Chimera::micros() );
+        }
+
+        if ( ( error == Chimera::CommonStatusCodes::OK ) && patchLen )
+        {
+          error = sramLoad( SRAMBuffer::BUFFER1, patchOffset, patch, patchLen );
+        }
+
+        /*------------------------------------------------
+        Program the destination, unless the compare says it already matches
+        ------------------------------------------------*/
+        if ( ( error == Chimera::CommonStatusCodes::OK ) && writeCompareEnabled
+             && bufferMatchesPage( SRAMBuffer::BUFFER1, dstPage ) )
+        {
+          trackBuffer( SRAMBuffer::BUFFER1, dstPage );
+        }
+        else if ( error == Chimera::CommonStatusCodes::OK )
+        {
+          error = sramCommit( SRAMBuffer::BUFFER1, static_cast<uint16_t>( dstPage ), true );
+          const Chimera::Status_t waitResult = awaitCompletion( FlashOperation::PAGE_ERASE_PROGRAM, Chimera::micros() );
+
+          if ( waitResult != Chimera::CommonStatusCodes::OK )
+          {
+            error = waitResult;
+          }
+          else if ( ( error != Chimera::CommonStatusCodes::OK ) || ( isErasePgmError() != Chimera::CommonStatusCodes::OK )
+                    || ( verifyPage( SRAMBuffer::BUFFER1, dstPage ) != Chimera::CommonStatusCodes::OK ) )
+          {
+            error = Chimera::CommonStatusCodes::FAILED_WRITE;
+          }
+        }
+      }
+
+      return error;
+    }
+
+    Chimera::Status_t AT45::copyRange( const uint32_t srcPage, const uint32_t dstPage, const uint32_t numPages )
+    {
+      Chimera::Status_t error  = Chimera::CommonStatusCodes::FAIL;
+      const uint32_t chipPages = chipSpecs[ static_cast<uint8_t>( device ) ].numPages;
+
+      if ( !chipInitialized )
+      {
+        error = Chimera::CommonStatusCodes::NOT_INITIALIZED;
+      }
+      else if ( ( ( srcPage + numPages ) > chipPages ) || ( ( dstPage + numPages ) > chipPages ) )
+      {
+        error = Chimera::CommonStatusCodes::INVAL_FUNC_PARAM;
+      }
+      else
+      {
+        error = Chimera::CommonStatusCodes::OK;
+
+        /*------------------------------------------------
+        A page to buffer transfer can't run while the chip is programming,
+        so there is nothing to overlap and pages go one at a time. Walk
+        backwards when moving up into an overlapping range so no source
+        page is overwritten before it's copied.
+        ------------------------------------------------*/
+        const bool reverse = ( dstPage > srcPage ) && ( dstPage < ( srcPage + numPages ) );
+
+        for ( uint32_t i = 0; ( error == Chimera::CommonStatusCodes::OK ) && ( i < numPages ); i++ )
+        {
+          const uint32_t idx = reverse ? ( numPages - 1u - i ) : i;
+          error              = copyPage( srcPage + idx, dstPage + idx );
+        }
+      }
+
+      return error;
+    }
+
     Chimera::Status_t AT45::erasePage( const uint32_t page )
     {
       Chimera::Status_t error = Chimera::CommonStatusCodes::FAIL;
@@ -530,6 +838,8 @@ namespace Adesto
 
         SPI_write( cmdBuffer.data(),
                    ( BYTE_LEN( PAGE_ERASE ) + addressFormat[ static_cast<uint8_t>( device ) ].numAddressBytes ), true );
+
+        invalidateBuffers( page, 1 );
         error = Chimera::CommonStatusCodes::OK;
       }
 
@@ -555,6 +865,10 @@ namespace Adesto
 
         SPI_write( cmdBuffer.data(),
                    ( BYTE_LEN( BLOCK_ERASE ) + addressFormat[ static_cast<uint8_t>( device ) ].numAddressBytes ), true );
+
+        const uint32_t pagesPerBlock = chipSpecs[ static_cast<uint8_t>( device ) ].numPages
+                                       / chipSpecs[ static_cast<uint8_t>( device ) ].numBlocks;
+        invalidateBuffers( block * pagesPerBlock, pagesPerBlock );
         error = Chimera::CommonStatusCodes::OK;
       }
 
@@ -580,6 +894,11 @@ namespace Adesto
 
         SPI_write( cmdBuffer.data(),
                    ( BYTE_LEN( SECTOR_ERASE ) + addressFormat[ static_cast<uint8_t>( device ) ].numAddressBytes ), true );
+
+        /*------------------------------------------------
+        Sector 0 is split unevenly, so don't bother working out its bounds
+        ------------------------------------------------*/
+        invalidateBuffers( 0, chipSpecs[ static_cast<uint8_t>( device ) ].numPages );
         error = Chimera::CommonStatusCodes::OK;
       }
 
@@ -600,6 +919,8 @@ namespace Adesto
         memcpy( cmdBuffer.data(), ( uint8_t * )&cmd, sizeof( cmd ) );
 
         SPI_write( cmdBuffer.data(), BYTE_LEN( CHIP_ERASE ), true );
+
+        invalidateBuffers( 0, chipSpecs[ static_cast<uint8_t>( device ) ].numPages );
         error = Chimera::CommonStatusCodes::OK;
       }
 
@@ -691,6 +1012,11 @@ namespace Adesto
       }
       else
       {
+        /*------------------------------------------------
+        Buffer contents are meaningless once the page geometry changes
+        ------------------------------------------------*/
+        sramState.fill( {} );
+
 #if defined( SW_SIM )
         pageSize   = PAGE_SIZE_BINARY;
         blockSize  = BLOCK_SIZE_BINARY;
@@ -708,7 +1034,7 @@ namespace Adesto
         /*------------------------------------------------
         Wait until the chip signals it has completed
         ------------------------------------------------*/
-        while ( !isDeviceReady() )
+        while ( isDeviceReady() != Chimera::CommonStatusCodes::OK )
         {
           Chimera::delayMilliseconds( 10 );
         }
@@ -740,6 +1066,11 @@ namespace Adesto
       }
       else
       {
+        /*------------------------------------------------
+        Buffer contents are meaningless once the page geometry changes
+        ------------------------------------------------*/
+        sramState.fill( {} );
+
 #if defined( SW_SIM )
         pageSize   = PAGE_SIZE_EXTENDED;
         blockSize  = BLOCK_SIZE_EXTENDED;
@@ -757,7 +1088,7 @@ namespace Adesto
         /*------------------------------------------------
         Wait until the chip signals it has completed
         ------------------------------------------------*/
-        while ( !isDeviceReady() )
+        while ( isDeviceReady() != Chimera::CommonStatusCodes::OK )
         {
           Chimera::delayMilliseconds( 10 );
         }
@@ -864,149 +1195,478 @@ namespace Adesto
       return sectorSize;
     }
 
-    BlockStatus AT45::DiskOpen( const uint8_t volNum, BlockMode openMode )
+    Chimera::Status_t AT45::enableBufferCache( const bool enable )
     {
-      return BlockStatus::BLOCK_DEV_ENOSYS;
+      Chimera::Status_t error = Chimera::CommonStatusCodes::OK;
+
+      if ( bufferCacheEnabled && !enable )
+      {
+        error = flushBuffers();
+      }
+
+      bufferCacheEnabled = enable;
+      return error;
     }
 
-    BlockStatus AT45::DiskClose( const uint8_t volNum )
+    void AT45::enableWriteCompare( const bool enable )
     {
-      return BlockStatus::BLOCK_DEV_ENOSYS;
+      writeCompareEnabled = enable;
     }
 
-    BlockStatus AT45::DiskRead( const uint8_t volNum, const uint64_t sectorStart, const uint32_t sectorCount,
-                                void *const readBuffer )
+    void AT45::enableWriteVerify( const bool enable )
     {
-      return BlockStatus::BLOCK_DEV_ENOSYS;
+      writeVerifyEnabled = enable;
     }
 
-    BlockStatus AT45::DiskWrite( const uint8_t volNum, const uint64_t sectorStart, const uint32_t sectorCount,
-                                 const void *const writeBuffer )
+    Chimera::Status_t AT45::flushBuffers()
     {
-      return BlockStatus::BLOCK_DEV_ENOSYS;
+      Chimera::Status_t error = Chimera::CommonStatusCodes::OK;
+
+      if ( !chipInitialized )
+      {
+        error = Chimera::CommonStatusCodes::NOT_INITIALIZED;
+      }
+      else
+      {
+        for ( uint8_t idx = 0; idx < sramState.size(); idx++ )
+        {
+          if ( flushBuffer( static_cast<SRAMBuffer>( idx ) ) != Chimera::CommonStatusCodes::OK )
+          {
+            error = Chimera::CommonStatusCodes::FAILED_WRITE;
+          }
+        }
+      }
+
+      return error;
     }
 
-    BlockStatus AT45::DiskFlush( const uint8_t volNum )
+    OperationStats AT45::getOperationStats( const FlashOperation op )
     {
-      return BlockStatus::BLOCK_DEV_ENOSYS;
+      OperationStats stats;
+
+      if ( op < FlashOperation::NUM_OPTIONS )
+      {
+        stats = opStats[ static_cast<uint8_t>( op ) ];
+      }
+
+      return stats;
     }
 
-    bool AT45::isInitialized()
+    void AT45::resetOperationStats()
     {
-      return chipInitialized;
+      opStats.fill( {} );
     }
 
-    Chimera::Status_t AT45::write( const uint32_t address, const uint8_t *const dataIn, const uint32_t len )
+    Chimera::Status_t AT45::setDiskSectorSize( const uint32_t size )
     {
-      Chimera::Status_t error = Chimera::CommonStatusCodes::FAIL;
+      Chimera::Status_t error = Chimera::CommonStatusCodes::OK;
 
-      if ( !chipInitialized )
+      if ( diskOpen )
       {
-        error = Chimera::CommonStatusCodes::NOT_INITIALIZED;
+        error = Chimera::CommonStatusCodes::LOCKED;
       }
-      else if ( !dataIn )
+      else if ( !size || ( size % pageSize ) )
       {
         error = Chimera::CommonStatusCodes::INVAL_FUNC_PARAM;
       }
-      else if ( ( address + len ) >= getFlashCapacity() )
+      else
       {
-        error = ErrCode::OVERRUN;
+        diskSectorSize = size;
+      }
+
+      return error;
+    }
+
+    Chimera::Status_t AT45::setDiskCache( uint8_t *const storage, const uint32_t size )
+    {
+      Chimera::Status_t error = Chimera::CommonStatusCodes::OK;
+
+      if ( diskOpen )
+      {
+        error = Chimera::CommonStatusCodes::LOCKED;
       }
       else
       {
-        error = Chimera::CommonStatusCodes::OK;
+        diskCacheStorage = storage;
+        diskCacheSize    = storage ? size : 0u;
+      }
 
-        Chimera::Modules::Memory::MemoryBlockRange dataRange( address, address + len, pageSize );
+      return error;
+    }
 
-        uint32_t bytesWritten = 0;
-        uint32_t bytesLeft    = len;
-        uint32_t currentBlock = dataRange.startBlock();
-        uint32_t startOffset  = dataRange.startOffset();
-        uint32_t endOffset    = dataRange.endOffset();
+    uint32_t AT45::getDiskSectorSize()
+    {
+      return diskSectorSize;
+    }
+
+    uint32_t AT45::getDiskSectorCount()
+    {
+      return diskSectorCount;
+    }
 
+    BlockStatus AT45::DiskOpen( const uint8_t volNum, BlockMode openMode )
+    {
+      BlockStatus result = BlockStatus::BLOCK_DEV_ERROR;
+
+      if ( !chipInitialized )
+      {
+        result = BlockStatus::BLOCK_DEV_NOTRDY;
+      }
+      else if ( diskOpen )
+      {
+        result = BlockStatus::BLOCK_DEV_OK;
+      }
+      else if ( !diskSectorSize || ( diskSectorSize % pageSize ) )
+      {
         /*------------------------------------------------
-        Write the first partial page (if there is one)
+        The page size changed since the sector size was chosen
         ------------------------------------------------*/
-        if ( startOffset != std::numeric_limits<uint32_t>::max() )
+        result = BlockStatus::BLOCK_DEV_PARERR;
+      }
+      else
+      {
+        diskPagesPerSect = diskSectorSize / pageSize;
+        diskSectorCount  = getFlashCapacity() / diskSectorSize;
+        diskAccessCount  = 0;
+
+        /*------------------------------------------------
+        Give each entry a whole sector of the cache storage, for as
+        many sectors as fit. The rest stay unused.
+        ------------------------------------------------*/
+        for ( uint32_t i = 0; i < diskCache.size(); i++ )
         {
-          const uint32_t partialWriteSize = dataRange.startBytes();
-          error = readModifyWrite( SRAMBuffer::BUFFER1, currentBlock, startOffset, dataIn, partialWriteSize );
+          const bool fits = ( ( i + 1 ) * diskSectorSize ) <= diskCacheSize;
+
+          auto &entry   = diskCache[ i ];
+          entry.valid   = false;
+          entry.dirty   = false;
+          entry.sector  = 0;
+          entry.lastUse = 0;
+          entry.data    = fits ? ( diskCacheStorage + ( i * diskSectorSize ) ) : nullptr;
+        }
+
+        diskOpen = true;
+        result   = BlockStatus::BLOCK_DEV_OK;
+      }
+
+      return result;
+    }
+
+    BlockStatus AT45::DiskClose( const uint8_t volNum )
+    {
+      BlockStatus result = BlockStatus::BLOCK_DEV_OK;
+
+      if ( diskOpen )
+      {
+        result = DiskFlush( volNum );
+
+        for ( auto &entry : diskCache )
+        {
+          entry.valid = false;
+          entry.dirty = false;
+        }
+
+        diskOpen = false;
+      }
+
+      return result;
+    }
+
+    BlockStatus AT45::DiskRead( const uint8_t volNum, const uint64_t sectorStart, const uint32_t sectorCount,
+                                void *const readBuffer )
+    {
+      BlockStatus result = BlockStatus::BLOCK_DEV_ERROR;
+
+      if ( !diskOpen )
+      {
+        result = BlockStatus::BLOCK_DEV_NOTRDY;
+      }
+      else if ( !readBuffer || !sectorCount || ( ( sectorStart + sectorCount ) > diskSectorCount ) )
+      {
+        result = BlockStatus::BLOCK_DEV_PARERR;
+      }
+      else
+      {
+        auto dataOut         = reinterpret_cast<uint8_t *>( readBuffer );
+        const uint32_t first = static_cast<uint32_t>( sectorStart );
+
+        /*------------------------------------------------
+        Pull the whole range in with a single continuous array read
+        ------------------------------------------------*/
+        const uint32_t address = first * diskSectorSize;
+        const uint32_t length  = sectorCount * diskSectorSize;
 
+        if ( ( directArrayRead( first * diskPagesPerSect, 0, dataOut, length ) == ErrCode::OK )
+             && ( overlayBuffers( address, dataOut, length ) == Chimera::CommonStatusCodes::OK ) )
+        {
           /*------------------------------------------------
-          Wait for the chip to be finished with this operation. Thankfully
-          this is a non-blocking operation if the Chimera backend implements
-          the delay mechanism properly.
+          Sectors still waiting in the cache are newer than flash
+          or the SRAM buffers
           ------------------------------------------------*/
-          while ( !isDeviceReady() )
+          for ( auto &entry : diskCache )
           {
-            Chimera::delayMilliseconds( chipDelay[ static_cast<uint8_t>( device ) ].pageEraseAndProgramming );
+            if ( entry.valid && entry.dirty && ( entry.sector >= first ) && ( entry.sector < ( first + sectorCount ) ) )
+            {
+              memcpy( dataOut + ( ( entry.sector - first ) * diskSectorSize ), entry.data, diskSectorSize );
+            }
           }
 
+          result = BlockStatus::BLOCK_DEV_OK;
+        }
+      }
+
+      return result;
+    }
+
+    BlockStatus AT45::DiskWrite( const uint8_t volNum, const uint64_t sectorStart, const uint32_t sectorCount,
+                                 const void *const writeBuffer )
+    {
+      BlockStatus result = BlockStatus::BLOCK_DEV_ERROR;
+
+      if ( !diskOpen )
+      {
+        result = BlockStatus::BLOCK_DEV_NOTRDY;
+      }
+      else if ( !writeBuffer || !sectorCount || ( ( sectorStart + sectorCount ) > diskSectorCount ) )
+      {
+        result = BlockStatus::BLOCK_DEV_PARERR;
+      }
+      else
+      {
+        auto dataIn = reinterpret_cast<const uint8_t *>( writeBuffer );
+        result      = BlockStatus::BLOCK_DEV_OK;
+
+        for ( uint32_t i = 0; i < sectorCount; i++ )
+        {
+          const uint32_t sector = static_cast<uint32_t>( sectorStart ) + i;
+          DiskCacheEntry *slot  = nullptr;
+
           /*------------------------------------------------
-          Check if the readModifyWrite failed or the chip signaled some error
+          Reuse the entry already holding this sector, otherwise take a free
+          one or evict whichever was used least recently.
           ------------------------------------------------*/
-          if ( ( error != Chimera::CommonStatusCodes::OK ) || ( isErasePgmError() != Chimera::CommonStatusCodes::OK ) )
+          for ( auto &entry : diskCache )
           {
-            error = Chimera::CommonStatusCodes::FAILED_WRITE;
+            if ( !entry.data )
+            {
+              continue;
+            }
+
+            if ( entry.valid && ( entry.sector == sector ) )
+            {
+              slot = &entry;
+              break;
+            }
+
+            if ( !slot || ( slot->valid && ( !entry.valid || ( entry.lastUse < slot->lastUse ) ) ) )
+            {
+              slot = &entry;
+            }
           }
-          else
+
+          /*------------------------------------------------
+          Without cache storage the sector goes straight to flash
+          ------------------------------------------------*/
+          if ( !slot )
           {
-            bytesLeft -= partialWriteSize;
-            bytesWritten += partialWriteSize;
-            currentBlock += 1u;
+            const Chimera::Status_t error =
+                programPages( sector * diskPagesPerSect, dataIn + ( i * diskSectorSize ), diskPagesPerSect );
+
+            if ( ( error != Chimera::CommonStatusCodes::OK ) || ( isErasePgmError() != Chimera::CommonStatusCodes::OK ) )
+            {
+              result = BlockStatus::BLOCK_DEV_ERROR;
+              break;
+            }
+
+            continue;
+          }
+
+          if ( !slot->valid || ( slot->sector != sector ) )
+          {
+            if ( flushCacheEntry( *slot ) != Chimera::CommonStatusCodes::OK )
+            {
+              result = BlockStatus::BLOCK_DEV_ERROR;
+              break;
+            }
+
+            slot->valid  = true;
+            slot->sector = sector;
           }
+
+          /*------------------------------------------------
+          Whole sectors are always written, so the old contents
+          never have to be read back from flash first.
+          ------------------------------------------------*/
+          memcpy( slot->data, dataIn + ( i * diskSectorSize ), diskSectorSize );
+          slot->dirty   = true;
+          slot->lastUse = ++diskAccessCount;
         }
+      }
+
+      return result;
+    }
+
+    BlockStatus AT45::DiskFlush( const uint8_t volNum )
+    {
+      BlockStatus result = BlockStatus::BLOCK_DEV_OK;
+
+      if ( !diskOpen )
+      {
+        result = BlockStatus::BLOCK_DEV_NOTRDY;
+      }
+      else
+      {
+        for ( auto &entry : diskCache )
+        {
+          if ( flushCacheEntry( entry ) != Chimera::CommonStatusCodes::OK )
+          {
+            result = BlockStatus::BLOCK_DEV_ERROR;
+          }
+        }
+      }
+
+      return result;
+    }
+
+    bool AT45::isInitialized()
+    {
+      return chipInitialized;
+    }
+
+    Chimera::Status_t AT45::write( const uint32_t address, const uint8_t *const dataIn, const uint32_t len )
+    {
+      Chimera::Status_t error = Chimera::CommonStatusCodes::FAIL;
+
+      if ( !chipInitialized )
+      {
+        error = Chimera::CommonStatusCodes::NOT_INITIALIZED;
+      }
+      else if ( !dataIn )
+      {
+        error = Chimera::CommonStatusCodes::INVAL_FUNC_PARAM;
+      }
+      else if ( ( address + len ) >= getFlashCapacity() )
+      {
+        error = ErrCode::OVERRUN;
+      }
+      else
+      {
+        error = Chimera::CommonStatusCodes::OK;
+
+        Chimera::Modules::Memory::MemoryBlockRange dataRange( address, address + len, pageSize );
+
+        uint32_t bytesWritten = 0;
+        uint32_t bytesLeft    = len;
+        uint32_t currentBlock = dataRange.startBlock();
+        uint32_t startOffset  = dataRange.startOffset();
+        uint32_t endOffset    = dataRange.endOffset();
 
         /*------------------------------------------------
-        Write consecutive, fully spanned pages next
+        Write the first partial page (if there is one)
         ------------------------------------------------*/
-        if ( error == Chimera::CommonStatusCodes::OK )
+        if ( startOffset != std::numeric_limits<uint32_t>::max() )
         {
-          while ( bytesLeft >= pageSize )
+          const uint32_t partialWriteSize = dataRange.startBytes();
+
+          if ( bufferCacheEnabled || writeCompareEnabled )
           {
-            error = pageWrite( SRAMBuffer::BUFFER1, 0, currentBlock, dataIn + bytesWritten, pageSize );
+            error = bufferedWrite( currentBlock, startOffset, dataIn, partialWriteSize );
 
-            while ( !isDeviceReady() )
+            if ( ( error == Chimera::CommonStatusCodes::OK ) && !bufferCacheEnabled )
             {
-              Chimera::delayMilliseconds( chipDelay[ static_cast<uint8_t>( device ) ].pageEraseAndProgramming );
+              error = flushBuffers();
             }
-
-            if ( error == Chimera::CommonStatusCodes::OK )
+          }
+          else
+          {
+            error = readModifyWrite( SRAMBuffer::BUFFER1, currentBlock, startOffset, dataIn, partialWriteSize );
+
+            /*------------------------------------------------
+            Wait for the chip to be finished with this operation. Thankfully
+            this is a non-blocking operation if the Chimera backend implements
+            the delay mechanism properly.
+            ------------------------------------------------*/
+            const Chimera::Status_t waitResult = awaitCompletion( FlashOperation::PAGE_ERASE_PROGRAM, Chimera::micros() );
+
+            /*------------------------------------------------
+            Check if the chip got stuck, the readModifyWrite failed, or the chip
+            signaled some error. The modified page is left in buffer 1, so it can
+            be verified too.
+            ------------------------------------------------*/
+            if ( waitResult != Chimera::CommonStatusCodes::OK )
             {
-              bytesLeft -= pageSize;
-              bytesWritten += pageSize;
-              currentBlock += 1u;
+              error = waitResult;
             }
-            else
+            else if ( ( error != Chimera::CommonStatusCodes::OK ) || ( isErasePgmError() != Chimera::CommonStatusCodes::OK )
+                      || ( verifyPage( SRAMBuffer::BUFFER1, currentBlock ) != Chimera::CommonStatusCodes::OK ) )
             {
-              break;
+              error = Chimera::CommonStatusCodes::FAILED_WRITE;
             }
           }
+
+          if ( error == Chimera::CommonStatusCodes::OK )
+          {
+            bytesLeft -= partialWriteSize;
+            bytesWritten += partialWriteSize;
+            currentBlock += 1u;
+          }
         }
 
         /*------------------------------------------------
-        Write the last partial page (if there is one)
+        Write consecutive, fully spanned pages next
         ------------------------------------------------*/
-        if ( ( error == Chimera::CommonStatusCodes::OK ) && bytesLeft && ( endOffset != std::numeric_limits<uint32_t>::max() ) )
+        if ( ( error == Chimera::CommonStatusCodes::OK ) && ( bytesLeft >= pageSize ) )
         {
-          error = readModifyWrite( SRAMBuffer::BUFFER1, currentBlock, 0u, dataIn + bytesWritten, endOffset );
+          const uint32_t numPages = bytesLeft / pageSize;
+          error                   = programPages( currentBlock, dataIn + bytesWritten, numPages );
 
-          /*------------------------------------------------
-          Wait for the chip to be finished with this operation. Thankfully
-          this is a non-blocking operation if the Chimera backend implements
-          the delay mechanism properly.
-          ------------------------------------------------*/
-          while ( !isDeviceReady() )
+          if ( error == Chimera::CommonStatusCodes::OK )
           {
-            Chimera::delayMilliseconds( chipDelay[ static_cast<uint8_t>( device ) ].pageEraseAndProgramming );
+            bytesLeft -= numPages * pageSize;
+            bytesWritten += numPages * pageSize;
+            currentBlock += numPages;
           }
+        }
 
-          /*------------------------------------------------
-          Check if the readModifyWrite failed or the chip signaled some error
-          ------------------------------------------------*/
-          if ( ( error != Chimera::CommonStatusCodes::OK ) || ( isErasePgmError() != Chimera::CommonStatusCodes::OK ) )
+        /*------------------------------------------------
+        Write the last partial page (if there is one)
+        ------------------------------------------------*/
+        if ( ( error == Chimera::CommonStatusCodes::OK ) && bytesLeft && ( endOffset != std::numeric_limits<uint32_t>::max() ) )
+        {
+          if ( bufferCacheEnabled || writeCompareEnabled )
           {
-            error = Chimera::CommonStatusCodes::FAILED_WRITE;
+            error = bufferedWrite( currentBlock, 0u, dataIn + bytesWritten, endOffset );
+
+            if ( ( error == Chimera::CommonStatusCodes::OK ) && !bufferCacheEnabled )
+            {
+              error = flushBuffers();
+            }
+          }
+          else
+          {
+            error = readModifyWrite( SRAMBuffer::BUFFER1, currentBlock, 0u, dataIn + bytesWritten, endOffset );
+
+            /*------------------------------------------------
+            Wait for the chip to be finished with this operation. Thankfully
+            this is a non-blocking operation if the Chimera backend implements
+            the delay mechanism properly.
+            ------------------------------------------------*/
+            const Chimera::Status_t waitResult = awaitCompletion( FlashOperation::PAGE_ERASE_PROGRAM, Chimera::micros() );
+
+            /*------------------------------------------------
+            Check if the chip got stuck, the readModifyWrite failed, or the chip
+            signaled some error. The modified page is left in buffer 1, so it can
+            be verified too.
+            ------------------------------------------------*/
+            if ( waitResult != Chimera::CommonStatusCodes::OK )
+            {
+              error = waitResult;
+            }
+            else if ( ( error != Chimera::CommonStatusCodes::OK ) || ( isErasePgmError() != Chimera::CommonStatusCodes::OK )
+                      || ( verifyPage( SRAMBuffer::BUFFER1, currentBlock ) != Chimera::CommonStatusCodes::OK ) )
+            {
+              error = Chimera::CommonStatusCodes::FAILED_WRITE;
+            }
           }
         }
       }
@@ -1030,6 +1690,41 @@ namespace Adesto
       {
         error = ErrCode::OVERRUN;
       }
+      else if ( bufferCacheEnabled )
+      {
+        const uint32_t firstPage  = address / pageSize;
+        const uint16_t pageOffset = static_cast<uint16_t>( address % pageSize );
+        const bool singlePage     = ( pageOffset + len ) <= pageSize;
+
+        error = Chimera::CommonStatusCodes::FAIL;
+
+        /*------------------------------------------------
+        A read confined to a buffered page comes straight out of SRAM
+        ------------------------------------------------*/
+        for ( uint8_t idx = 0; singlePage && ( idx < sramState.size() ); idx++ )
+        {
+          if ( sramState[ idx ].valid && ( sramState[ idx ].page == firstPage ) )
+          {
+            error = sramRead( static_cast<SRAMBuffer>( idx ), pageOffset, dataOut, len );
+            sramState[ idx ].lastUse = ++sramAccessCount;
+            break;
+          }
+        }
+
+        /*------------------------------------------------
+        Otherwise read the array, then patch in any buffered changes
+        that have not reached it yet.
+        ------------------------------------------------*/
+        if ( error != Chimera::CommonStatusCodes::OK )
+        {
+          error = directArrayRead( firstPage, pageOffset, dataOut, len );
+
+          if ( error == Chimera::CommonStatusCodes::OK )
+          {
+            error = overlayBuffers( address, dataOut, len );
+          }
+        }
+      }
       else
       {
         Chimera::Modules::Memory::MemoryBlockRange dataRange( address, address + len, pageSize );
@@ -1089,16 +1784,16 @@ namespace Adesto
       /*------------------------------------------------
       Sectors
       ------------------------------------------------*/
-      for ( size_t i = 0; i < range.sectors.size(); i++ )
+      for ( size_t i = 0; ( error == Chimera::CommonStatusCodes::OK ) && ( i < range.sectors.size() ); i++ )
       {
         error = eraseSector( range.sectors[ i ] );
 
-        while ( isDeviceReady() != Chimera::CommonStatusCodes::OK )
+        if ( error == Chimera::CommonStatusCodes::OK )
         {
-          Chimera::delayMilliseconds( chipDelay[ static_cast<uint8_t>( device ) ].sectorErase );
+          error = awaitCompletion( FlashOperation::SECTOR_ERASE, Chimera::micros() );
         }
 
-        if ( isErasePgmError() != Chimera::CommonStatusCodes::OK )
+        if ( ( error == Chimera::CommonStatusCodes::OK ) && ( isErasePgmError() != Chimera::CommonStatusCodes::OK ) )
         {
           error = ErrCode::FAILED_ERASE;
         }
@@ -1107,16 +1802,16 @@ namespace Adesto
       /*------------------------------------------------
       Blocks
       ------------------------------------------------*/
-      for ( size_t i = 0; i < range.blocks.size(); i++ )
+      for ( size_t i = 0; ( error == Chimera::CommonStatusCodes::OK ) && ( i < range.blocks.size() ); i++ )
       {
         error = eraseBlock( range.blocks[ i ] );
 
-        while ( isDeviceReady() != Chimera::CommonStatusCodes::OK )
+        if ( error == Chimera::CommonStatusCodes::OK )
         {
-          Chimera::delayMilliseconds( chipDelay[ static_cast<uint8_t>( device ) ].blockErase );
+          error = awaitCompletion( FlashOperation::BLOCK_ERASE, Chimera::micros() );
         }
 
-        if ( isErasePgmError() != Chimera::CommonStatusCodes::OK )
+        if ( ( error == Chimera::CommonStatusCodes::OK ) && ( isErasePgmError() != Chimera::CommonStatusCodes::OK ) )
         {
           error = ErrCode::FAILED_ERASE;
         }
@@ -1125,16 +1820,16 @@ namespace Adesto
       /*------------------------------------------------
       Pages
       ------------------------------------------------*/
-      for ( size_t i = 0; i < range.pages.size(); i++ )
+      for ( size_t i = 0; ( error == Chimera::CommonStatusCodes::OK ) && ( i < range.pages.size() ); i++ )
       {
         error = erasePage( range.pages[ i ] );
 
-        while ( isDeviceReady() != Chimera::CommonStatusCodes::OK )
+        if ( error == Chimera::CommonStatusCodes::OK )
         {
-          Chimera::delayMilliseconds( chipDelay[ static_cast<uint8_t>( device ) ].pageErase );
+          error = awaitCompletion( FlashOperation::PAGE_ERASE, Chimera::micros() );
         }
 
-        if ( isErasePgmError() != Chimera::CommonStatusCodes::OK )
+        if ( ( error == Chimera::CommonStatusCodes::OK ) && ( isErasePgmError() != Chimera::CommonStatusCodes::OK ) )
         {
           error = ErrCode::FAILED_ERASE;
         }
@@ -1143,6 +1838,363 @@ namespace Adesto
       return error;
     }
 
+    Chimera::Status_t AT45::programPages( const uint32_t firstPage, const uint8_t *const dataIn, const uint32_t numPages )
+    {
+      Chimera::Status_t error = Chimera::CommonStatusCodes::OK;
+      SRAMBuffer activeBuffer = SRAMBuffer::BUFFER1;
+      bool programming        = false;
+      uint32_t commitTime     = 0;
+      uint32_t commitPage     = 0;
+
+      /*------------------------------------------------
+      Both buffers are about to be overwritten. Changes to pages that are
+      being replaced anyway can be dropped, everything else is saved first.
+      ------------------------------------------------*/
+      for ( uint8_t idx = 0; idx < sramState.size(); idx++ )
+      {
+        const SRAMBufferState &state = sramState[ idx ];
+
+        if ( state.dirty && ( state.page >= firstPage ) && ( state.page < ( firstPage + numPages ) ) )
+        {
+          sramState[ idx ] = {};
+        }
+        else if ( error == Chimera::CommonStatusCodes::OK )
+        {
+          error = flushBuffer( static_cast<SRAMBuffer>( idx ) );
+        }
+      }
+
+      /*------------------------------------------------
+      The two SRAM buffers are used in turn so the next page can be clocked
+      into the idle buffer while the chip is still programming the previous one.
+      ------------------------------------------------*/
+      for ( uint32_t i = 0; ( error == Chimera::CommonStatusCodes::OK ) && ( i < numPages ); i++ )
+      {
+        error = sramLoad( activeBuffer, 0, dataIn + ( i * pageSize ), pageSize );
+
+        /*------------------------------------------------
+        The buffer to page transfer can't start until the
+        previous page has finished programming.
+        ------------------------------------------------*/
+        if ( programming )
+        {
+          const Chimera::Status_t waitResult = awaitCompletion( FlashOperation::PAGE_ERASE_PROGRAM, commitTime );
+          programming                        = false;
+
+          if ( error == Chimera::CommonStatusCodes::OK )
+          {
+            error = waitResult;
+          }
+
+          /*------------------------------------------------
+          The page just programmed came from the other buffer
+          ------------------------------------------------*/
+          if ( error == Chimera::CommonStatusCodes::OK )
+          {
+            error = verifyPage( ( activeBuffer == SRAMBuffer::BUFFER1 ) ? SRAMBuffer::BUFFER2 : SRAMBuffer::BUFFER1,
+                                commitPage );
+          }
+        }
+
+        /*------------------------------------------------
+        Leave the page alone if it already holds this data
+        ------------------------------------------------*/
+        if ( ( error == Chimera::CommonStatusCodes::OK ) && writeCompareEnabled
+             && bufferMatchesPage( activeBuffer, firstPage + i ) )
+        {
+          trackBuffer( activeBuffer, firstPage + i );
+          continue;
+        }
+
+        if ( error == Chimera::CommonStatusCodes::OK )
+        {
+          error      = sramCommit( activeBuffer, firstPage + i, true );
+          commitTime = Chimera::micros();
+          commitPage = firstPage + i;
+        }
+
+        if ( error != Chimera::CommonStatusCodes::OK )
+        {
+          break;
+        }
+
+        programming  = true;
+        activeBuffer = ( activeBuffer == SRAMBuffer::BUFFER1 ) ? SRAMBuffer::BUFFER2 : SRAMBuffer::BUFFER1;
+      }
+
+      /*------------------------------------------------
+      Let the final page finish before anything else is sent
+      ------------------------------------------------*/
+      if ( programming )
+      {
+        const Chimera::Status_t waitResult = awaitCompletion( FlashOperation::PAGE_ERASE_PROGRAM, commitTime );
+
+        if ( error == Chimera::CommonStatusCodes::OK )
+        {
+          error = waitResult;
+        }
+
+        if ( error == Chimera::CommonStatusCodes::OK )
+        {
+          error = verifyPage( ( activeBuffer == SRAMBuffer::BUFFER1 ) ? SRAMBuffer::BUFFER2 : SRAMBuffer::BUFFER1,
+                              commitPage );
+        }
+      }
+
+      return error;
+    }
+
+    void AT45::trackBuffer( const SRAMBuffer bufferNumber, const uint32_t pageNumber )
+    {
+      const uint8_t idx = static_cast<uint8_t>( bufferNumber );
+
+      /*------------------------------------------------
+      The other buffer's copy of this page is out of date now
+      ------------------------------------------------*/
+      invalidateBuffers( pageNumber, 1 );
+
+      sramState[ idx ].valid   = true;
+      sramState[ idx ].dirty   = false;
+      sramState[ idx ].page    = pageNumber;
+      sramState[ idx ].lastUse = ++sramAccessCount;
+    }
+
+    void AT45::invalidateBuffers( const uint32_t firstPage, const uint32_t numPages )
+    {
+      for ( auto &state : sramState )
+      {
+        if ( state.valid && ( state.page >= firstPage ) && ( state.page < ( firstPage + numPages ) ) )
+        {
+          state = {};
+        }
+      }
+    }
+
+    Chimera::Status_t AT45::bufferedWrite( const uint32_t pageNumber, const uint16_t pageOffset,
+                                           const uint8_t *const dataIn, const uint32_t len )
+    {
+      Chimera::Status_t error = Chimera::CommonStatusCodes::OK;
+      SRAMBuffer buffer       = SRAMBuffer::BUFFER1;
+      bool found              = false;
+
+      for ( uint8_t idx = 0; idx < sramState.size(); idx++ )
+      {
+        if ( sramState[ idx ].valid && ( sramState[ idx ].page == pageNumber ) )
+        {
+          buffer = static_cast<SRAMBuffer>( idx );
+          found  = true;
+          break;
+        }
+      }
+
+      if ( !found )
+      {
+        /*------------------------------------------------
+        Prefer an empty buffer, then one that can be dropped without
+        programming, then whichever was used least recently.
+        ------------------------------------------------*/
+        const SRAMBufferState &b1 = sramState[ static_cast<uint8_t>( SRAMBuffer::BUFFER1 ) ];
+        const SRAMBufferState &b2 = sramState[ static_cast<uint8_t>( SRAMBuffer::BUFFER2 ) ];
+        const uint8_t cost1       = b1.valid + b1.dirty;
+        const uint8_t cost2       = b2.valid + b2.dirty;
+
+        if ( ( cost2 < cost1 ) || ( ( cost2 == cost1 ) && ( b2.lastUse < b1.lastUse ) ) )
+        {
+          buffer = SRAMBuffer::BUFFER2;
+        }
+
+        error = flushBuffer( buffer );
+
+        if ( error == Chimera::CommonStatusCodes::OK )
+        {
+          error = sramTransfer( buffer, static_cast<uint16_t>( pageNumber ) );
+        }
+
+        if ( error == Chimera::CommonStatusCodes::OK )
+        {
+          error = awaitCompletion( FlashOperation::BUFFER_TRANSFER, Chimera::micros() );
+        }
+      }
+
+      /*------------------------------------------------
+      Loading data forgets the tracking, so restore it marked dirty
+      ------------------------------------------------*/
+      if ( error == Chimera::CommonStatusCodes::OK )
+      {
+        const uint8_t idx           = static_cast<uint8_t>( buffer );
+        const SRAMBufferState state = sramState[ idx ];
+
+        error = sramLoad( buffer, pageOffset, dataIn, len );
+
+        if ( error == Chimera::CommonStatusCodes::OK )
+        {
+          sramState[ idx ]         = state;
+          sramState[ idx ].dirty   = true;
+          sramState[ idx ].lastUse = ++sramAccessCount;
+        }
+      }
+
+      return error;
+    }
+
+    bool AT45::bufferMatchesPage( const SRAMBuffer bufferNumber, const uint32_t pageNumber )
+    {
+      bool match = false;
+
+      if ( ( sramCompare( bufferNumber, static_cast<uint16_t>( pageNumber ) ) == Chimera::CommonStatusCodes::OK )
+           && ( awaitCompletion( FlashOperation::BUFFER_TRANSFER, Chimera::micros() ) == Chimera::CommonStatusCodes::OK ) )
+      {
+        match = !( readStatusRegister() & COMPARE_RESULT_Pos );
+      }
+
+      return match;
+    }
+
+    Chimera::Status_t AT45::verifyPage( const SRAMBuffer bufferNumber, const uint32_t pageNumber )
+    {
+      Chimera::Status_t error = Chimera::CommonStatusCodes::OK;
+
+      if ( writeVerifyEnabled
+           && ( ( isErasePgmError() != Chimera::CommonStatusCodes::OK ) || !bufferMatchesPage( bufferNumber, pageNumber ) ) )
+      {
+        error = Chimera::CommonStatusCodes::FAILED_WRITE;
+      }
+
+      return error;
+    }
+
+    Chimera::Status_t AT45::flushBuffer( const SRAMBuffer bufferNumber )
+    {
+      Chimera::Status_t error      = Chimera::CommonStatusCodes::OK;
+      const SRAMBufferState &state = sramState[ static_cast<uint8_t>( bufferNumber ) ];
+
+      if ( state.valid && state.dirty && writeCompareEnabled && bufferMatchesPage( bufferNumber, state.page ) )
+      {
+        trackBuffer( bufferNumber, state.page );
+      }
+      else if ( state.valid && state.dirty )
+      {
+        const uint32_t pageNumber = state.page;
+
+        error = sramCommit( bufferNumber, static_cast<uint16_t>( pageNumber ), true );
+        const Chimera::Status_t waitResult = awaitCompletion( FlashOperation::PAGE_ERASE_PROGRAM, Chimera::micros() );
+
+        if ( waitResult != Chimera::CommonStatusCodes::OK )
+        {
+          sramState[ static_cast<uint8_t>( bufferNumber ) ] = {};
+          error                                            = waitResult;
+        }
+        else if ( ( error != Chimera::CommonStatusCodes::OK ) || ( isErasePgmError() != Chimera::CommonStatusCodes::OK )
+                  || ( verifyPage( bufferNumber, pageNumber ) != Chimera::CommonStatusCodes::OK ) )
+        {
+          sramState[ static_cast<uint8_t>( bufferNumber ) ] = {};
+          error                                            = Chimera::CommonStatusCodes::FAILED_WRITE;
+        }
+      }
+
+      return error;
+    }
+
+    Chimera::Status_t AT45::overlayBuffers( const uint32_t address, uint8_t *const dataOut, const uint32_t len )
+    {
+      Chimera::Status_t error = Chimera::CommonStatusCodes::OK;
+
+      for ( uint8_t idx = 0; ( error == Chimera::CommonStatusCodes::OK ) && ( idx < sramState.size() ); idx++ )
+      {
+        const SRAMBufferState &state = sramState[ idx ];
+        const uint32_t pageStart     = state.page * pageSize;
+        const uint32_t overlapStart  = std::max( address, pageStart );
+        const uint32_t overlapEnd    = std::min( address + len, pageStart + pageSize );
+
+        if ( state.valid && state.dirty && ( overlapStart < overlapEnd ) )
+        {
+          error = sramRead( static_cast<SRAMBuffer>( idx ), static_cast<uint16_t>( overlapStart - pageStart ),
+                            dataOut + ( overlapStart - address ), overlapEnd - overlapStart );
+        }
+      }
+
+      return error;
+    }
+
+    Chimera::Status_t AT45::flushCacheEntry( DiskCacheEntry &entry )
+    {
+      Chimera::Status_t error = Chimera::CommonStatusCodes::OK;
+
+      if ( entry.valid && entry.dirty )
+      {
+        error = programPages( entry.sector * diskPagesPerSect, entry.data, diskPagesPerSect );
+
+        if ( ( error == Chimera::CommonStatusCodes::OK ) && ( isErasePgmError() == Chimera::CommonStatusCodes::OK ) )
+        {
+          entry.dirty = false;
+        }
+        else
+        {
+          error = Chimera::CommonStatusCodes::FAILED_WRITE;
+        }
+      }
+
+      return error;
+    }
+
+    Chimera::Status_t AT45::awaitCompletion( const FlashOperation op, const uint32_t startTime )
+    {
+      OperationStats &stats  = opStats[ static_cast<uint8_t>( op ) ];
+      const uint32_t typical = typicalDelay( device, op );
+      const uint32_t poll    = std::max( typical / POLL_DIVISOR, MIN_POLL_INTERVAL_US );
+      const uint32_t limit   = TIMEOUT_MULTIPLIER * std::max( typical, stats.maximum );
+
+      /*------------------------------------------------
+      Sleep off most of the expected time in one go. The fastest completion
+      seen so far is used once available, otherwise the datasheet value. Only
+      three quarters is slept so that an overestimate shrinks with each wait
+      rather than locking in.
+      ------------------------------------------------*/
+      const uint32_t expected = stats.samples ? stats.minimum : typical;
+      const uint32_t target   = expected - ( expected / 4 );
+      const uint32_t elapsed  = Chimera::micros() - startTime;
+
+      if ( target > elapsed )
+      {
+        sleepFor( target - elapsed );
+      }
+
+      /*------------------------------------------------
+      Poll at a fine interval for the remainder, giving up on a
+      chip that never reports ready
+      ------------------------------------------------*/
+      while ( isDeviceReady() != Chimera::CommonStatusCodes::OK )
+      {
+        if ( ( Chimera::micros() - startTime ) >= limit )
+        {
+          return Chimera::CommonStatusCodes::TIMEOUT;
+        }
+
+        sleepFor( poll );
+      }
+
+      /*------------------------------------------------
+      Record how long the operation took
+      ------------------------------------------------*/
+      const uint32_t actual = Chimera::micros() - startTime;
+
+      if ( !stats.samples )
+      {
+        stats.minimum = actual;
+        stats.maximum = actual;
+        stats.average = actual;
+      }
+      else
+      {
+        stats.minimum = std::min( stats.minimum, actual );
+        stats.maximum = std::max( stats.maximum, actual );
+        stats.average = stats.average - ( stats.average / 8 ) + ( actual / 8 );
+      }
+
+      stats.samples++;
+      return Chimera::CommonStatusCodes::OK;
+    }
+
     void AT45::buildReadWriteCommand( const uint16_t pageNumber, const uint16_t offset )
     {
       /*------------------------------------------------
@@ -12,6 +12,7 @@
 #define AT45DB081_HPP
 
 /* Standard C++ Includes */
+#include <array>
 #include <cstdlib>
 #include <memory>
 
@@ -53,6 +54,55 @@ namespace Adesto
       bool eraseSuspend           = false;
     };
 
+    /**
+     *  Long running chip operations whose completion time is tracked
+     */
+    enum class FlashOperation : uint8_t
+    {
+      PAGE_ERASE_PROGRAM,
+      PAGE_PROGRAM,
+      PAGE_ERASE,
+      BLOCK_ERASE,
+      SECTOR_ERASE,
+      CHIP_ERASE,
+      BUFFER_TRANSFER,
+      NUM_OPTIONS
+    };
+
+    /**
+     *  Observed completion times of a single operation type, in microseconds
+     */
+    struct OperationStats
+    {
+      uint32_t samples = 0; /**< Number of completions measured */
+      uint32_t minimum = 0; /**< Fastest completion seen */
+      uint32_t maximum = 0; /**< Slowest completion seen */
+      uint32_t average = 0; /**< Running average of the completion time */
+    };
+
+    /**
+     *  What the driver knows about the contents of an SRAM buffer
+     */
+    struct SRAMBufferState
+    {
+      bool valid       = false; /**< Whether the buffer is known to hold a page */
+      bool dirty       = false; /**< Whether the buffer holds changes not yet programmed */
+      uint32_t page    = 0;     /**< Page the buffer contents belong to */
+      uint32_t lastUse = 0;     /**< Access stamp used to pick an eviction victim */
+    };
+
+    /**
+     *  A single logical sector held by the block device write-back cache
+     */
+    struct DiskCacheEntry
+    {
+      bool valid       = false; /**< Whether the entry holds a sector */
+      bool dirty       = false; /**< Whether the data differs from what is in flash */
+      uint32_t sector  = 0;     /**< Logical sector number being held */
+      uint32_t lastUse = 0;     /**< Access stamp used to pick an eviction victim */
+      uint8_t *data    = nullptr; /**< Sector contents, carved out of the storage given to setDiskCache() */
+    };
+
     struct AT45xx_DeviceInfo
     {
       uint8_t manufacturerID;
@@ -145,6 +195,31 @@ namespace Adesto
       Chimera::Status_t sramCommit( const SRAMBuffer bufferNumber, const uint16_t pageNumber, const bool erase,
                                     Chimera::void_func_uint32_t onComplete = nullptr );
 
+      /**
+       *  Copies a page from main memory into one of the SRAM buffers
+       *
+       *  @note   The transfer takes time to complete, so wait for the device to be ready before using the buffer.
+       *
+       *	@param[in]	bufferNumber	Selects which SRAM buffer to fill
+       *	@param[in]	pageNumber		Page number in memory to copy from
+       *	@param[in]	onComplete		Optional function pointer to execute upon task completion
+       *	@return Chimera::Status_t
+       */
+      Chimera::Status_t sramTransfer( const SRAMBuffer bufferNumber, const uint16_t pageNumber,
+                                      Chimera::void_func_uint32_t onComplete = nullptr );
+
+      /**
+       *  Starts an in-chip comparison of an SRAM buffer against a page in main memory. Once the
+       *  device is ready, the result is in the COMPARE_RESULT_Pos bit of the status register.
+       *
+       *	@param[in]	bufferNumber	Selects which SRAM buffer to compare
+       *	@param[in]	pageNumber		Page number in memory to compare against
+       *	@param[in]	onComplete		Optional function pointer to execute upon task completion
+       *	@return Chimera::Status_t
+       */
+      Chimera::Status_t sramCompare( const SRAMBuffer bufferNumber, const uint16_t pageNumber,
+                                     Chimera::void_func_uint32_t onComplete = nullptr );
+
       /**
        *  Reads data directly from a page in internal memory, bypassing both SRAM buffers without modification.
        *
@@ -233,6 +308,32 @@ namespace Adesto
                                          const uint8_t *const dataIn, const uint32_t len,
                                          Chimera::void_func_uint32_t onComplete = nullptr );
 
+      /**
+       *  Copies a page to another location without the data leaving the chip. The source page
+       *  is pulled into SRAM buffer 1, optionally patched, then programmed into the destination
+       *  with built-in erase. Blocks until the destination has been programmed.
+       *
+       *	@param[in]	srcPage			  Page to copy from
+       *	@param[in]	dstPage			  Page to copy to
+       *	@param[in]	patchOffset		Offset within the page to apply the patch at
+       *	@param[in]	patch			    Optional data to overwrite part of the page with before programming
+       *	@param[in]	patchLen		  Number of patch bytes, up to a full page size
+       *	@return Chimera::Status_t
+       */
+      Chimera::Status_t copyPage( const uint32_t srcPage, const uint32_t dstPage, const uint16_t patchOffset = 0,
+                                  const uint8_t *const patch = nullptr, const uint32_t patchLen = 0 );
+
+      /**
+       *  Copies a run of pages to another location without the data leaving the chip.
+       *  Overlapping ranges are handled, so this can be used to slide data in either direction.
+       *
+       *	@param[in]	srcPage			  First page to copy from
+       *	@param[in]	dstPage			  First page to copy to
+       *	@param[in]	numPages		  How many pages to copy
+       *	@return Chimera::Status_t
+       */
+      Chimera::Status_t copyRange( const uint32_t srcPage, const uint32_t dstPage, const uint32_t numPages );
+
       /**
        *  Erases a given page
        *
@@ -345,6 +446,100 @@ namespace Adesto
        */
       uint32_t getSectorSize();
 
+      /**
+       *  Uses the SRAM buffers as a two page cache for write() and read(). Partial page writes
+       *  are gathered in a buffer and only programmed once the buffer is needed for another
+       *  page or flushBuffers() is called, and reads of a buffered page come straight from SRAM.
+       *  Disabling the cache flushes it.
+       *
+       *  @note   While enabled, data written may not be in main memory until flushBuffers() is called.
+       *
+       *  @param[in]  enable      Whether to turn the cache on or off
+       *  @return Chimera::Status_t
+       */
+      Chimera::Status_t enableBufferCache( const bool enable );
+
+      /**
+       *  Makes write() and pageWrite() compare new page contents against main memory inside the
+       *  chip before programming, skipping the erase and program entirely when nothing changed.
+       *  Costs a buffer compare per page, but saves a full program cycle for every unchanged one.
+       *
+       *  @param[in]  enable      Whether to turn compare before write on or off
+       *  @return void
+       */
+      void enableWriteCompare( const bool enable );
+
+      /**
+       *  Makes write() check every page it programs. The data is still sitting in the SRAM
+       *  buffer afterwards, so the chip compares it against main memory itself and the result
+       *  is read from the status register along with the erase/program error flag. Failures
+       *  are reported as FAILED_WRITE.
+       *
+       *  @param[in]  enable      Whether to turn verify after write on or off
+       *  @return void
+       */
+      void enableWriteVerify( const bool enable );
+
+      /**
+       *  Programs any SRAM buffers holding changes that have not yet been written to main memory
+       *
+       *  @return Chimera::Status_t
+       */
+      Chimera::Status_t flushBuffers();
+
+      /**
+       *  Gets the completion times observed so far for an operation type
+       *
+       *  @param[in]  op          Which operation to look up
+       *  @return OperationStats
+       */
+      OperationStats getOperationStats( const FlashOperation op );
+
+      /**
+       *  Forgets all observed completion times, reverting back to the datasheet values
+       *
+       *  @return void
+       */
+      void resetOperationStats();
+
+      /**
+       *  Selects the logical sector size presented through the block device interface.
+       *  Must be a whole number of pages in the current page size configuration and
+       *  can only be changed while the disk is closed.
+       *
+       *  @param[in]  size        Sector size in bytes
+       *  @return Chimera::Status_t
+       */
+      Chimera::Status_t setDiskSectorSize( const uint32_t size );
+
+      /**
+       *  Hands the block device interface memory for its write-back sector cache. The
+       *  cache is opt-in: without storage every DiskWrite() goes straight to flash. When
+       *  the disk is opened, up to DISK_CACHE_SECTORS whole sectors are carved out of the
+       *  storage, which must stay valid until the disk is closed. Passing nullptr turns
+       *  the cache back off. Can only be changed while the disk is closed.
+       *
+       *  @param[in]  storage     Memory to hold cached sectors, or nullptr
+       *  @param[in]  size        Size of storage in bytes
+       *  @return Chimera::Status_t
+       */
+      Chimera::Status_t setDiskCache( uint8_t *const storage, const uint32_t size );
+
+      /**
+       *  Gets the logical sector size used by the block device interface
+       *
+       *  @return uint32_t
+       */
+      uint32_t getDiskSectorSize();
+
+      /**
+       *  Gets how many logical sectors the block device interface exposes. Only
+       *  valid once the disk has been opened.
+       *
+       *  @return uint32_t
+       */
+      uint32_t getDiskSectorCount();
+
       /*------------------------------------------------
       Block Device Interface Functions
       ------------------------------------------------*/
@@ -398,6 +593,126 @@ namespace Adesto
       uint32_t blockSize      = BLOCK_SIZE_BINARY;  /**< Keeps track of the current block size configuration in bytes */
       uint32_t sectorSize     = SECTOR_SIZE_BINARY; /**< Keeps track of the current sector size configuration in bytes */
 
+      std::array<OperationStats, static_cast<uint8_t>( FlashOperation::NUM_OPTIONS )> opStats; /**< Observed completion times */
+
+      bool bufferCacheEnabled  = false; /**< Whether write() and read() use the SRAM buffers as a cache */
+      bool writeCompareEnabled = false; /**< Whether unchanged pages are detected and left alone */
+      bool writeVerifyEnabled  = false; /**< Whether programmed pages are compared against their buffer */
+      uint32_t sramAccessCount = 0;     /**< Running access stamp for buffer eviction */
+
+      std::array<SRAMBufferState, 2> sramState; /**< Tracked contents of SRAM buffers 1 and 2 */
+
+      bool diskOpen             = false;                    /**< Tracks if the block device interface is open */
+      uint32_t diskSectorSize   = DISK_SECTOR_SIZE_DEFAULT; /**< Logical sector size in bytes */
+      uint32_t diskPagesPerSect = 0;                        /**< Number of pages spanned by a logical sector */
+      uint32_t diskSectorCount  = 0;                        /**< Number of logical sectors on the disk */
+      uint32_t diskAccessCount  = 0;                        /**< Running access stamp for cache eviction */
+      uint8_t *diskCacheStorage = nullptr;                  /**< Memory given to setDiskCache() */
+      uint32_t diskCacheSize    = 0;                        /**< Size of diskCacheStorage in bytes */
+
+      std::array<DiskCacheEntry, DISK_CACHE_SECTORS> diskCache; /**< Write-back sector cache, entries without data are unused */
+
+      /**
+       *  Programs a run of whole pages with built-in erase, alternating between the two
+       *  SRAM buffers so the next page loads while the previous one programs.
+       *
+       *  @param[in]  firstPage   First page to program
+       *  @param[in]  dataIn      Data for every page, back to back
+       *  @param[in]  numPages    How many pages to program
+       *  @return Chimera::Status_t
+       */
+      Chimera::Status_t programPages( const uint32_t firstPage, const uint8_t *const dataIn, const uint32_t numPages );
+
+      /**
+       *  Records that an SRAM buffer holds an exact copy of a page in main memory
+       *
+       *  @param[in]  bufferNumber  The buffer that was filled
+       *  @param[in]  pageNumber    The page it now matches
+       *  @return void
+       */
+      void trackBuffer( const SRAMBuffer bufferNumber, const uint32_t pageNumber );
+
+      /**
+       *  Forgets any SRAM buffer contents that belong to a range of pages, usually
+       *  because those pages were changed without going through the buffer.
+       *
+       *  @param[in]  firstPage   First page affected
+       *  @param[in]  numPages    Number of pages affected
+       *  @return void
+       */
+      void invalidateBuffers( const uint32_t firstPage, const uint32_t numPages );
+
+      /**
+       *  Gathers a partial page write into the SRAM buffer holding that page, pulling the
+       *  page into a buffer first if neither holds it.
+       *
+       *  @param[in]  pageNumber  Page to write
+       *  @param[in]  pageOffset  Offset within the page
+       *  @param[in]  dataIn      Data to write
+       *  @param[in]  len         Number of bytes, not crossing the end of the page
+       *  @return Chimera::Status_t
+       */
+      Chimera::Status_t bufferedWrite( const uint32_t pageNumber, const uint16_t pageOffset, const uint8_t *const dataIn,
+                                       const uint32_t len );
+
+      /**
+       *  Runs an in-chip compare and waits for the result
+       *
+       *  @param[in]  bufferNumber  The buffer to compare
+       *  @param[in]  pageNumber    The page to compare against
+       *  @return bool              True if the buffer and page hold identical data
+       */
+      bool bufferMatchesPage( const SRAMBuffer bufferNumber, const uint32_t pageNumber );
+
+      /**
+       *  Checks a freshly programmed page against the buffer it came from, if verification is
+       *  turned on. The device must have finished programming.
+       *
+       *  @param[in]  bufferNumber  The buffer the page was programmed from
+       *  @param[in]  pageNumber    The page that was programmed
+       *  @return Chimera::Status_t
+       */
+      Chimera::Status_t verifyPage( const SRAMBuffer bufferNumber, const uint32_t pageNumber );
+
+      /**
+       *  Programs an SRAM buffer into its page if it holds unwritten changes
+       *
+       *  @param[in]  bufferNumber  The buffer to write back
+       *  @return Chimera::Status_t
+       */
+      Chimera::Status_t flushBuffer( const SRAMBuffer bufferNumber );
+
+      /**
+       *  Copies any SRAM buffer changes not yet programmed over data read from the array
+       *
+       *  @param[in]  address     Flash address the data was read from
+       *  @param[out] dataOut     Data read from the array, patched in place
+       *  @param[in]  len         Number of bytes in dataOut
+       *  @return Chimera::Status_t
+       */
+      Chimera::Status_t overlayBuffers( const uint32_t address, uint8_t *const dataOut, const uint32_t len );
+
+      /**
+       *  Writes a dirty cache entry back to flash
+       *
+       *  @param[in]  entry       The cache entry to write back
+       *  @return Chimera::Status_t
+       */
+      Chimera::Status_t flushCacheEntry( DiskCacheEntry &entry );
+
+      /**
+       *  Blocks until the chip finishes a long running operation. The expected completion
+       *  time is slept off in one go, after which the status register is polled at a fine
+       *  interval. Completion times are recorded so later waits can be tighter than the
+       *  datasheet values. A chip still busy after several times the expected duration
+       *  is given up on.
+       *
+       *  @param[in]  op          The operation that was started
+       *  @param[in]  startTime   Chimera::micros() timestamp of when the operation was issued
+       *  @return Chimera::Status_t   OK, or TIMEOUT if the chip never reported ready
+       */
+      Chimera::Status_t awaitCompletion( const FlashOperation op, const uint32_t startTime );
+
       /**
        *  Erases a ranged set of pages, blocks, and sectors
        *
@@ -53,6 +53,12 @@ namespace Adesto
     static constexpr uint32_t BLOCK_SIZE_EXTENDED  = 2112u;
     static constexpr uint32_t SECTOR_SIZE_EXTENDED = 67584u;
 
+    /*------------------------------------------------
+    Block Device Configuration
+    ------------------------------------------------*/
+    static constexpr uint32_t DISK_SECTOR_SIZE_DEFAULT = 512u; /* Logical sector size used if none is configured */
+    static constexpr uint8_t DISK_CACHE_SECTORS        = 4u;   /* Most sectors the write-back cache will hold */
+
     /*------------------------------------------------
     Status Register Bits
     ------------------------------------------------*/
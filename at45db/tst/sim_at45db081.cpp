@@ -0,0 +1,641 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_at45db081.cpp
+ *
+ *  Description:
+ *    Behavioral simulation of the AT45DB081E for running the driver on a host
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* C++ Includes */
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+/* Driver Includes */
+#include "sim_at45db081.hpp"
+
+namespace Adesto
+{
+  namespace NORFlash
+  {
+    /*------------------------------------------------
+    Manufacturer and device ID bytes, in the order they
+    are shifted out. See: (11.1) Manufacturer and Device ID Read
+    ------------------------------------------------*/
+    static constexpr std::array<uint8_t, 5> SIM_DEVICE_ID = { JEDEC_CODE, 0x25, 0x00, 0x01, 0x00 };
+
+    /*------------------------------------------------
+    Status register byte 1 density bits for an 8Mbit part
+    ------------------------------------------------*/
+    static constexpr uint16_t SIM_DENSITY_BITS = ( 0x09 << 2 ) << 8;
+
+    /*------------------------------------------------
+    Leading byte of the four byte configuration sequences
+    ------------------------------------------------*/
+    static constexpr uint8_t SIM_CFG_OPCODE = 0x3D;
+
+    static constexpr uint8_t SIM_DUMMY_BYTE = 0xFF;
+    static constexpr size_t SIM_HEADER_LEN  = 4; /**< CMD(1) + Address(3) */
+
+    static uint64_t steadyMicros()
+    {
+      using namespace std::chrono;
+      return duration_cast<microseconds>( steady_clock::now().time_since_epoch() ).count();
+    }
+
+    AT45Simulator::AT45Simulator() : memory( NUM_PAGES * PAGE_SIZE_EXTENDED ), timeSource( steadyMicros )
+    {
+      /*------------------------------------------------
+      Default to the same delays the driver assumes
+      ------------------------------------------------*/
+      setOperationTime( SimOperation::PAGE_ERASE_PROGRAM, 15000 );
+      setOperationTime( SimOperation::PAGE_PROGRAM, 2000 );
+      setOperationTime( SimOperation::PAGE_ERASE, 12000 );
+      setOperationTime( SimOperation::BLOCK_ERASE, 30000 );
+      setOperationTime( SimOperation::SECTOR_ERASE, 700000 );
+      setOperationTime( SimOperation::CHIP_ERASE, 10000000 );
+      setOperationTime( SimOperation::BUFFER_TRANSFER, 200 );
+      setOperationTime( SimOperation::CONFIGURE, 15000 );
+
+      reset();
+    }
+
+    Chimera::Status_t AT45Simulator::setChipSelect( const Chimera::GPIO::State value )
+    {
+      if ( value == Chimera::GPIO::State::LOW )
+      {
+        /*------------------------------------------------
+        The driver re-asserts chip select between the command
+        and data phases, so only a falling edge starts a command.
+        ------------------------------------------------*/
+        if ( !selected )
+        {
+          selected  = true;
+          byteIdx   = 0;
+          ignore    = false;
+          dataCount = 0;
+          header.fill( 0 );
+          touched.fill( false );
+          stats.transactions++;
+        }
+      }
+      else if ( selected )
+      {
+        selected = false;
+        execute();
+      }
+
+      return Chimera::CommonStatusCodes::OK;
+    }
+
+    Chimera::Status_t AT45Simulator::writeBytes( const uint8_t *const txBuffer, const size_t length )
+    {
+      return readWriteBytes( txBuffer, nullptr, length );
+    }
+
+    Chimera::Status_t AT45Simulator::readBytes( uint8_t *const rxBuffer, const size_t length )
+    {
+      return readWriteBytes( nullptr, rxBuffer, length );
+    }
+
+    Chimera::Status_t AT45Simulator::readWriteBytes( const uint8_t *const txBuffer, uint8_t *const rxBuffer,
+                                                     const size_t length )
+    {
+      for ( size_t i = 0; i < length; i++ )
+      {
+        const uint8_t out = exchange( txBuffer ? txBuffer[ i ] : SIM_DUMMY_BYTE );
+
+        if ( rxBuffer )
+        {
+          rxBuffer[ i ] = out;
+        }
+      }
+
+      return Chimera::CommonStatusCodes::OK;
+    }
+
+    void AT45Simulator::setOperationTime( const SimOperation op, const uint64_t duration )
+    {
+      if ( op < SimOperation::NUM_OPTIONS )
+      {
+        opTime[ static_cast<size_t>( op ) ] = duration;
+      }
+    }
+
+    void AT45Simulator::disableTiming()
+    {
+      opTime.fill( 0 );
+    }
+
+    void AT45Simulator::setTimeSource( SimTimeSource source )
+    {
+      timeSource = source ? source : steadyMicros;
+    }
+
+    void AT45Simulator::setBinaryPageSize( const bool binary )
+    {
+      binaryPages = binary;
+    }
+
+    void AT45Simulator::setWeakCell( const uint32_t pageNumber, const uint16_t offset )
+    {
+      weakCell   = true;
+      weakPage   = pageNumber % NUM_PAGES;
+      weakOffset = offset % PAGE_SIZE_EXTENDED;
+    }
+
+    void AT45Simulator::reset()
+    {
+      std::fill( memory.begin(), memory.end(), ERASE_RESET_VAL );
+      sram[ 0 ].fill( ERASE_RESET_VAL );
+      sram[ 1 ].fill( ERASE_RESET_VAL );
+
+      binaryPages     = false;
+      compareMismatch = false;
+      selected        = false;
+      busyStart       = 0;
+      busyDuration    = 0;
+      busyBuffer      = -1;
+      weakCell        = false;
+      weakPage        = 0;
+      weakOffset      = 0;
+      byteIdx         = 0;
+      ignore          = false;
+      dataCount       = 0;
+      header.fill( 0 );
+      touched.fill( false );
+    }
+
+    bool AT45Simulator::busy()
+    {
+      if ( busyDuration && ( ( timeSource() - busyStart ) >= busyDuration ) )
+      {
+        busyDuration = 0;
+        busyBuffer   = -1;
+      }
+
+      return busyDuration != 0;
+    }
+
+    uint16_t AT45Simulator::statusRegister()
+    {
+      uint16_t sr = SIM_DENSITY_BITS;
+
+      if ( !busy() )
+      {
+        sr |= READY_BUSY_Pos | ( READY_BUSY_Pos >> 8 );
+      }
+
+      if ( compareMismatch )
+      {
+        sr |= COMPARE_RESULT_Pos;
+      }
+
+      if ( binaryPages )
+      {
+        sr |= PAGE_SIZE_CONFIG_Pos;
+      }
+
+      return sr;
+    }
+
+    uint16_t AT45Simulator::pageSize() const
+    {
+      return binaryPages ? PAGE_SIZE_BINARY : PAGE_SIZE_EXTENDED;
+    }
+
+    uint8_t *AT45Simulator::page( const uint32_t pageNumber )
+    {
+      return memory.data() + ( ( pageNumber % NUM_PAGES ) * PAGE_SIZE_EXTENDED );
+    }
+
+    uint8_t *AT45Simulator::buffer( const SRAMBuffer bufferNumber )
+    {
+      return sram[ ( bufferNumber == SRAMBuffer::BUFFER1 ) ? 0 : 1 ].data();
+    }
+
+    SimStats AT45Simulator::getStats() const
+    {
+      return stats;
+    }
+
+    void AT45Simulator::resetStats()
+    {
+      stats = {};
+    }
+
+    uint8_t AT45Simulator::exchange( const uint8_t tx )
+    {
+      if ( !selected )
+      {
+        return SIM_DUMMY_BYTE;
+      }
+
+      stats.bytesClocked++;
+      const size_t idx = byteIdx++;
+
+      /*------------------------------------------------
+      Opcode. While busy, the chip still answers status reads
+      and lets the buffer that isn't in use be accessed.
+      ------------------------------------------------*/
+      if ( idx == 0 )
+      {
+        header[ 0 ] = tx;
+
+        if ( tx == STATUS_REGISTER_READ )
+        {
+          stats.statusReads++;
+        }
+        else if ( busy() )
+        {
+          const bool bufferAccess = ( tx == BUFFER1_WRITE ) || ( tx == BUFFER2_WRITE ) || ( tx == BUFFER1_READ_LF )
+                                    || ( tx == BUFFER2_READ_LF ) || ( tx == BUFFER1_READ_HF ) || ( tx == BUFFER2_READ_HF );
+
+          ignore = !( bufferAccess && ( bufferFor( tx ) != busyBuffer ) );
+          stats.busyRejects += ignore ? 1 : 0;
+        }
+
+        return SIM_DUMMY_BYTE;
+      }
+
+      if ( ignore )
+      {
+        return SIM_DUMMY_BYTE;
+      }
+
+      const uint8_t opcode = header[ 0 ];
+
+      /*------------------------------------------------
+      Commands without an address field
+      ------------------------------------------------*/
+      if ( opcode == STATUS_REGISTER_READ )
+      {
+        const uint16_t sr = statusRegister();
+        return ( idx % 2 ) ? static_cast<uint8_t>( sr >> 8 ) : static_cast<uint8_t>( sr & 0xFF );
+      }
+
+      if ( opcode == READ_DEVICE_INFO )
+      {
+        return ( idx <= SIM_DEVICE_ID.size() ) ? SIM_DEVICE_ID[ idx - 1 ] : 0x00;
+      }
+
+      if ( !hasAddress( opcode ) )
+      {
+        /* Multi-byte sequences such as chip erase and the configuration commands */
+        if ( idx < header.size() )
+        {
+          header[ idx ] = tx;
+        }
+
+        return SIM_DUMMY_BYTE;
+      }
+
+      /*------------------------------------------------
+      Address bytes, MSB first
+      ------------------------------------------------*/
+      if ( idx < SIM_HEADER_LEN )
+      {
+        header[ idx ] = tx;
+
+        /*------------------------------------------------
+        Read-modify-write pulls the page into the buffer before
+        any data arrives, so incoming bytes land on top of it.
+        ------------------------------------------------*/
+        if ( ( idx == ( SIM_HEADER_LEN - 1 ) ) && ( ( opcode == RMW_THR_BUFFER1 ) || ( opcode == RMW_THR_BUFFER2 ) ) )
+        {
+          memcpy( sram[ bufferFor( opcode ) ].data(), page( decodePage() ), PAGE_SIZE_EXTENDED );
+        }
+
+        return SIM_DUMMY_BYTE;
+      }
+
+      const size_t dummies = dummyBytes( opcode );
+      if ( idx < ( SIM_HEADER_LEN + dummies ) )
+      {
+        return SIM_DUMMY_BYTE;
+      }
+
+      /*------------------------------------------------
+      Data phase
+      ------------------------------------------------*/
+      const uint32_t ps   = pageSize();
+      const uint32_t step = static_cast<uint32_t>( idx - SIM_HEADER_LEN - dummies );
+
+      switch ( opcode )
+      {
+        case MAIN_MEM_PAGE_READ:
+          return page( decodePage() )[ ( decodeOffset() + step ) % ps ];
+
+        case CONT_ARR_READ_LP:
+        case CONT_ARR_READ_LF:
+        case CONT_ARR_READ_HF1:
+        case CONT_ARR_READ_HF2:
+        case CONT_ARR_READ_LEG: {
+          const uint32_t linear = ( ( decodePage() * ps ) + decodeOffset() + step ) % ( NUM_PAGES * ps );
+          return page( linear / ps )[ linear % ps ];
+        }
+
+        case BUFFER1_READ_LF:
+        case BUFFER2_READ_LF:
+        case BUFFER1_READ_HF:
+        case BUFFER2_READ_HF:
+          return sram[ bufferFor( opcode ) ][ ( decodeOffset() + step ) % ps ];
+
+        case BUFFER1_WRITE:
+        case BUFFER2_WRITE:
+        case MAIN_MEM_PAGE_PGM_THR_BUFFER1_W_ERASE:
+        case MAIN_MEM_PAGE_PGM_THR_BUFFER2_W_ERASE:
+        case MAIN_MEM_BP_PGM_THR_BUFFER1_WO_ERASE:
+        case RMW_THR_BUFFER1:
+        case RMW_THR_BUFFER2: {
+          const uint32_t offset = ( decodeOffset() + step ) % ps;
+
+          sram[ bufferFor( opcode ) ][ offset ] = tx;
+          touched[ offset ]                     = true;
+          dataCount++;
+          return SIM_DUMMY_BYTE;
+        }
+
+        default:
+          return SIM_DUMMY_BYTE;
+      }
+    }
+
+    void AT45Simulator::execute()
+    {
+      if ( ignore || !byteIdx )
+      {
+        return;
+      }
+
+      const uint8_t opcode = header[ 0 ];
+      const bool complete  = byteIdx >= SIM_HEADER_LEN;
+
+      if ( !complete )
+      {
+        return;
+      }
+
+      switch ( opcode )
+      {
+        /*------------------------------------------------
+        Buffer to main memory
+        ------------------------------------------------*/
+        case BUFFER1_TO_MAIN_MEM_PAGE_PGM_W_ERASE:
+        case BUFFER2_TO_MAIN_MEM_PAGE_PGM_W_ERASE:
+          programPage( decodePage(), bufferFor( opcode ), true, false );
+          startOperation( SimOperation::PAGE_ERASE_PROGRAM, bufferFor( opcode ) );
+          break;
+
+        case BUFFER1_TO_MAIN_MEM_PAGE_PGM_WO_ERASE:
+        case BUFFER2_TO_MAIN_MEM_PAGE_PGM_WO_ERASE:
+          programPage( decodePage(), bufferFor( opcode ), false, false );
+          startOperation( SimOperation::PAGE_PROGRAM, bufferFor( opcode ) );
+          break;
+
+        case MAIN_MEM_PAGE_PGM_THR_BUFFER1_W_ERASE:
+        case MAIN_MEM_PAGE_PGM_THR_BUFFER2_W_ERASE:
+        case RMW_THR_BUFFER1:
+        case RMW_THR_BUFFER2:
+          programPage( decodePage(), bufferFor( opcode ), true, false );
+          startOperation( SimOperation::PAGE_ERASE_PROGRAM, bufferFor( opcode ) );
+          break;
+
+        case MAIN_MEM_BP_PGM_THR_BUFFER1_WO_ERASE:
+          if ( dataCount )
+          {
+            programPage( decodePage(), bufferFor( opcode ), false, true );
+            startOperation( SimOperation::PAGE_PROGRAM, bufferFor( opcode ) );
+          }
+          break;
+
+        /*------------------------------------------------
+        Main memory to buffer
+        ------------------------------------------------*/
+        case MAIN_MEM_PAGE_TO_BUFFER1_TRANSFER:
+        case MAIN_MEM_PAGE_TO_BUFFER2_TRANSFER:
+          memcpy( sram[ bufferFor( opcode ) ].data(), page( decodePage() ), PAGE_SIZE_EXTENDED );
+          startOperation( SimOperation::BUFFER_TRANSFER, bufferFor( opcode ) );
+          break;
+
+        case MAIN_MEM_PAGE_TO_BUFFER1_COMPARE:
+        case MAIN_MEM_PAGE_TO_BUFFER2_COMPARE:
+          compareMismatch = memcmp( sram[ bufferFor( opcode ) ].data(), page( decodePage() ), pageSize() ) != 0;
+          startOperation( SimOperation::BUFFER_TRANSFER, bufferFor( opcode ) );
+          break;
+
+        /*------------------------------------------------
+        Erase
+        ------------------------------------------------*/
+        case PAGE_ERASE:
+          erasePages( decodePage(), 1 );
+          startOperation( SimOperation::PAGE_ERASE );
+          break;
+
+        case BLOCK_ERASE:
+          erasePages( decodePage() & ~( PAGES_PER_BLOCK - 1 ), PAGES_PER_BLOCK );
+          startOperation( SimOperation::BLOCK_ERASE );
+          break;
+
+        case SECTOR_ERASE: {
+          /*------------------------------------------------
+          Sector 0 is split into 0a (first block) and 0b (the rest)
+          ------------------------------------------------*/
+          const uint32_t pg = decodePage();
+
+          if ( pg < PAGES_PER_BLOCK )
+          {
+            erasePages( 0, PAGES_PER_BLOCK );
+          }
+          else if ( pg < PAGES_PER_SECT )
+          {
+            erasePages( PAGES_PER_BLOCK, PAGES_PER_SECT - PAGES_PER_BLOCK );
+          }
+          else
+          {
+            erasePages( pg & ~( PAGES_PER_SECT - 1 ), PAGES_PER_SECT );
+          }
+
+          startOperation( SimOperation::SECTOR_ERASE );
+          break;
+        }
+
+        default: {
+          /*------------------------------------------------
+          Four byte sequences, compared in the order they are sent
+          ------------------------------------------------*/
+          uint32_t chipErase   = CHIP_ERASE;
+          uint32_t binaryCfg   = CFG_PWR_2_PAGE_SIZE;
+          uint32_t extendedCfg = CFG_STD_FLASH_PAGE_SIZE;
+
+          if ( memcmp( header.data(), &chipErase, header.size() ) == 0 )
+          {
+            erasePages( 0, NUM_PAGES );
+            startOperation( SimOperation::CHIP_ERASE );
+          }
+          else if ( ( opcode == SIM_CFG_OPCODE ) && ( memcmp( header.data(), &binaryCfg, header.size() ) == 0 ) )
+          {
+            binaryPages = true;
+            startOperation( SimOperation::CONFIGURE );
+          }
+          else if ( ( opcode == SIM_CFG_OPCODE ) && ( memcmp( header.data(), &extendedCfg, header.size() ) == 0 ) )
+          {
+            binaryPages = false;
+            startOperation( SimOperation::CONFIGURE );
+          }
+          break;
+        }
+      }
+    }
+
+    void AT45Simulator::startOperation( const SimOperation op, const int bufferInUse )
+    {
+      busyStart    = timeSource();
+      busyDuration = opTime[ static_cast<size_t>( op ) ];
+      busyBuffer   = busyDuration ? bufferInUse : -1;
+    }
+
+    bool AT45Simulator::hasAddress( const uint8_t opcode ) const
+    {
+      switch ( opcode )
+      {
+        case MAIN_MEM_PAGE_READ:
+        case CONT_ARR_READ_LP:
+        case CONT_ARR_READ_LF:
+        case CONT_ARR_READ_HF1:
+        case CONT_ARR_READ_HF2:
+        case CONT_ARR_READ_LEG:
+        case BUFFER1_READ_LF:
+        case BUFFER2_READ_LF:
+        case BUFFER1_READ_HF:
+        case BUFFER2_READ_HF:
+        case BUFFER1_WRITE:
+        case BUFFER2_WRITE:
+        case BUFFER1_TO_MAIN_MEM_PAGE_PGM_W_ERASE:
+        case BUFFER2_TO_MAIN_MEM_PAGE_PGM_W_ERASE:
+        case BUFFER1_TO_MAIN_MEM_PAGE_PGM_WO_ERASE:
+        case BUFFER2_TO_MAIN_MEM_PAGE_PGM_WO_ERASE:
+        case MAIN_MEM_PAGE_PGM_THR_BUFFER1_W_ERASE:
+        case MAIN_MEM_PAGE_PGM_THR_BUFFER2_W_ERASE:
+        case MAIN_MEM_BP_PGM_THR_BUFFER1_WO_ERASE:
+        case PAGE_ERASE:
+        case BLOCK_ERASE:
+        case SECTOR_ERASE:
+        case RMW_THR_BUFFER1:
+        case RMW_THR_BUFFER2:
+        case MAIN_MEM_PAGE_TO_BUFFER1_TRANSFER:
+        case MAIN_MEM_PAGE_TO_BUFFER2_TRANSFER:
+        case MAIN_MEM_PAGE_TO_BUFFER1_COMPARE:
+        case MAIN_MEM_PAGE_TO_BUFFER2_COMPARE:
+          return true;
+
+        default:
+          return false;
+      }
+    }
+
+    size_t AT45Simulator::dummyBytes( const uint8_t opcode ) const
+    {
+      switch ( opcode )
+      {
+        case MAIN_MEM_PAGE_READ:
+        case CONT_ARR_READ_LEG:
+          return 4;
+
+        case CONT_ARR_READ_HF2:
+          return 2;
+
+        case CONT_ARR_READ_HF1:
+        case BUFFER1_READ_HF:
+        case BUFFER2_READ_HF:
+          return 1;
+
+        default:
+          return 0;
+      }
+    }
+
+    int AT45Simulator::bufferFor( const uint8_t opcode ) const
+    {
+      switch ( opcode )
+      {
+        case BUFFER2_READ_LF:
+        case BUFFER2_READ_HF:
+        case BUFFER2_WRITE:
+        case BUFFER2_TO_MAIN_MEM_PAGE_PGM_W_ERASE:
+        case BUFFER2_TO_MAIN_MEM_PAGE_PGM_WO_ERASE:
+        case MAIN_MEM_PAGE_PGM_THR_BUFFER2_W_ERASE:
+        case RMW_THR_BUFFER2:
+        case MAIN_MEM_PAGE_TO_BUFFER2_TRANSFER:
+        case MAIN_MEM_PAGE_TO_BUFFER2_COMPARE:
+          return 1;
+
+        default:
+          return 0;
+      }
+    }
+
+    uint32_t AT45Simulator::decodePage() const
+    {
+      /*------------------------------------------------
+      For 264 byte page size: xxxaaaaa|aaaaaaao|oooooooo
+      For 256 byte page size: xxxxaaaa|aaaaaaaa|oooooooo
+      ------------------------------------------------*/
+      const uint32_t address    = ( header[ 1 ] << 16 ) | ( header[ 2 ] << 8 ) | header[ 3 ];
+      const uint32_t offsetBits = binaryPages ? 8 : 9;
+
+      return ( address >> offsetBits ) % NUM_PAGES;
+    }
+
+    uint32_t AT45Simulator::decodeOffset() const
+    {
+      const uint32_t address = ( header[ 1 ] << 16 ) | ( header[ 2 ] << 8 ) | header[ 3 ];
+      const uint32_t offset  = address & ( binaryPages ? 0xFF : 0x1FF );
+
+      return offset % pageSize();
+    }
+
+    void AT45Simulator::erasePages( const uint32_t first, const uint32_t count )
+    {
+      for ( uint32_t p = first; ( p < first + count ) && ( p < NUM_PAGES ); p++ )
+      {
+        memset( page( p ), ERASE_RESET_VAL, PAGE_SIZE_EXTENDED );
+      }
+
+      stats.erases++;
+    }
+
+    void AT45Simulator::programPage( const uint32_t pageNumber, const int bufferNumber, const bool erase,
+                                     const bool onlyTouched )
+    {
+      uint8_t *const dst       = page( pageNumber );
+      const uint8_t *const src = sram[ bufferNumber ].data();
+      const uint32_t ps        = pageSize();
+
+      if ( erase )
+      {
+        erasePages( pageNumber, 1 );
+      }
+
+      const bool weak       = weakCell && ( weakPage == pageNumber );
+      const uint8_t weakVal = dst[ weakOffset ];
+
+      for ( uint32_t i = 0; i < ps; i++ )
+      {
+        if ( !onlyTouched || touched[ i ] )
+        {
+          dst[ i ] &= src[ i ];
+        }
+      }
+
+      if ( weak )
+      {
+        dst[ weakOffset ] = weakVal;
+      }
+
+      stats.programs++;
+    }
+  }  // namespace NORFlash
+}  // namespace Adesto
@@ -0,0 +1,246 @@
+/********************************************************************************
+ *  File Name:
+ *    sim_at45db081.hpp
+ *
+ *  Description:
+ *    Behavioral simulation of the AT45DB081E for running the driver on a host
+ *
+ *  2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef AT45DB081_SIM_HPP
+#define AT45DB081_SIM_HPP
+
+/* C++ Includes */
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+/* Chimera Includes */
+#include <Chimera/spi.hpp>
+
+/* Driver Includes */
+#include "at45db081.hpp"
+
+namespace Adesto
+{
+  namespace NORFlash
+  {
+    /**
+     *  Long running operations the simulated chip can be busy with
+     */
+    enum class SimOperation : uint8_t
+    {
+      PAGE_ERASE_PROGRAM, /**< tEP: Buffer to page with erase, page program through buffer, read-modify-write */
+      PAGE_PROGRAM,       /**< tP:  Buffer to page without erase, byte/page program through buffer 1 */
+      PAGE_ERASE,         /**< tPE */
+      BLOCK_ERASE,        /**< tBE */
+      SECTOR_ERASE,       /**< tSE */
+      CHIP_ERASE,         /**< tCE */
+      BUFFER_TRANSFER,    /**< tXFR: Page to buffer transfer and compare */
+      CONFIGURE,          /**< Page size reconfiguration */
+
+      NUM_OPTIONS
+    };
+
+    /**
+     *  Bus level counters kept by the simulator
+     */
+    struct SimStats
+    {
+      size_t transactions = 0; /**< Number of chip select assertions */
+      size_t bytesClocked = 0; /**< Total bytes exchanged on the bus */
+      size_t programs     = 0; /**< Page program operations executed */
+      size_t erases       = 0; /**< Erase operations executed, including built-in erases */
+      size_t statusReads  = 0; /**< Status register read commands */
+      size_t busyRejects  = 0; /**< Commands ignored because the chip was busy */
+    };
+
+    using SimTimeSource = uint64_t ( * )(); /**< Returns the current time in microseconds */
+
+    /**
+     *  Models an AT45DB081E at the SPI byte level, including both SRAM buffers and
+     *  the binary (256 byte) and extended (264 byte) page size modes. Every command
+     *  in at45db081_definitions.hpp that moves data is decoded: buffer read/write,
+     *  buffer to page with and without erase, page program through buffer, byte
+     *  program, read-modify-write, page/block/sector/chip erase, page to buffer
+     *  transfer and compare, array and page reads, status and ID reads, and the page
+     *  size configuration sequences.
+     *
+     *  Memory follows NOR rules: programs without erase can only clear bits and erases
+     *  set bytes to 0xFF. Operations take effect immediately, but the RDY/BUSY bit stays
+     *  clear for the configured operation time. While busy, only status reads and
+     *  accesses to the SRAM buffer not used by the operation are accepted, mirroring
+     *  the real part.
+     *
+     *  The transfer functions mirror those of the Chimera SPI driver, so a mock can
+     *  forward to them and run the unmodified driver against the simulation.
+     */
+    class AT45Simulator
+    {
+    public:
+      AT45Simulator();
+      ~AT45Simulator() = default;
+
+      /*------------------------------------------------
+      SPI Bus Interface
+      ------------------------------------------------*/
+      Chimera::Status_t setChipSelect( const Chimera::GPIO::State value );
+      Chimera::Status_t writeBytes( const uint8_t *const txBuffer, const size_t length );
+      Chimera::Status_t readBytes( uint8_t *const rxBuffer, const size_t length );
+      Chimera::Status_t readWriteBytes( const uint8_t *const txBuffer, uint8_t *const rxBuffer, const size_t length );
+
+      /*------------------------------------------------
+      Simulation Interface
+      ------------------------------------------------*/
+      /**
+       *  Sets how long the chip reports busy after starting an operation. The defaults
+       *  match the delays the driver assumes in its chipDelay table.
+       *
+       *  @param[in]  op          Which operation to configure
+       *  @param[in]  duration    Busy time in microseconds
+       *  @return void
+       */
+      void setOperationTime( const SimOperation op, const uint64_t duration );
+
+      /**
+       *  Sets every operation time to zero so functional tests don't wait
+       *
+       *  @return void
+       */
+      void disableTiming();
+
+      /**
+       *  Replaces the clock that busy timing is measured against
+       *
+       *  @param[in]  source      Function returning the time in microseconds
+       *  @return void
+       */
+      void setTimeSource( SimTimeSource source );
+
+      /**
+       *  Forces the page size configuration without going over the bus. Useful
+       *  when the driver is built with SW_SIM and skips the configuration command.
+       *
+       *  @param[in]  binary      True for 256 byte pages, false for 264 byte pages
+       *  @return void
+       */
+      void setBinaryPageSize( const bool binary );
+
+      /**
+       *  Marks a memory cell as worn out. Programming no longer clears any of its bits,
+       *  yet the chip doesn't flag an error, so only a read back or compare will notice.
+       *  Only one weak cell is modeled at a time.
+       *
+       *  @param[in]  pageNumber  Page containing the cell
+       *  @param[in]  offset      Byte offset of the cell within the page
+       *  @return void
+       */
+      void setWeakCell( const uint32_t pageNumber, const uint16_t offset );
+
+      /**
+       *  Erases the array, clears both buffers and resets all volatile state.
+       *  The page size is restored to the factory default of 264 bytes.
+       *
+       *  @return void
+       */
+      void reset();
+
+      /**
+       *  Checks whether an operation is still in progress
+       *
+       *  @return bool
+       */
+      bool busy();
+
+      /**
+       *  Builds the two status register bytes, byte 1 in the upper half
+       *
+       *  @return uint16_t
+       */
+      uint16_t statusRegister();
+
+      /**
+       *  Gets the page size the chip is currently configured for
+       *
+       *  @return uint16_t
+       */
+      uint16_t pageSize() const;
+
+      /**
+       *  Direct access to a physical page, bypassing the bus. Pages are always
+       *  264 bytes wide; in binary mode only the first 256 are addressable.
+       *
+       *  @param[in]  pageNumber  Which page to access
+       *  @return uint8_t *
+       */
+      uint8_t *page( const uint32_t pageNumber );
+
+      /**
+       *  Direct access to an SRAM buffer, bypassing the bus
+       *
+       *  @param[in]  bufferNumber  Which buffer to access
+       *  @return uint8_t *
+       */
+      uint8_t *buffer( const SRAMBuffer bufferNumber );
+
+      /**
+       *  Gets the bus counters
+       *
+       *  @return SimStats
+       */
+      SimStats getStats() const;
+
+      /**
+       *  Zeros the bus counters
+       *
+       *  @return void
+       */
+      void resetStats();
+
+      static constexpr uint32_t NUM_PAGES       = 4096;
+      static constexpr uint32_t PAGES_PER_BLOCK = 8;
+      static constexpr uint32_t PAGES_PER_SECT  = 256;
+
+    private:
+      std::vector<uint8_t> memory;                                                   /**< Physical array, always 264 bytes per page */
+      std::array<std::array<uint8_t, PAGE_SIZE_EXTENDED>, 2> sram;                   /**< SRAM buffers 1 and 2 */
+      std::array<uint64_t, static_cast<size_t>( SimOperation::NUM_OPTIONS )> opTime; /**< Busy time per operation */
+      SimTimeSource timeSource;                                                      /**< Clock for busy timing */
+      SimStats stats;                                                                /**< Bus counters */
+
+      bool binaryPages;      /**< Page size configuration */
+      bool compareMismatch;  /**< Result of the last compare */
+      bool selected;         /**< Chip select state */
+      uint64_t busyStart;    /**< Time the current operation started */
+      uint64_t busyDuration; /**< How long the current operation lasts */
+      int busyBuffer;        /**< SRAM buffer in use by the current operation, or -1 */
+      bool weakCell;         /**< Whether a worn out cell is being modeled */
+      uint32_t weakPage;     /**< Page containing the worn out cell */
+      uint16_t weakOffset;   /**< Offset of the worn out cell */
+
+      std::array<uint8_t, 4> header;                /**< Opcode and address bytes of the current command */
+      size_t byteIdx;                               /**< Bytes received since chip select was asserted */
+      bool ignore;                                  /**< Whether this command is dropped because the chip is busy */
+      uint32_t dataCount;                           /**< Bytes received during the data phase */
+      std::array<bool, PAGE_SIZE_EXTENDED> touched; /**< Buffer bytes written during this command */
+
+      uint8_t exchange( const uint8_t tx );
+      void execute();
+      void startOperation( const SimOperation op, const int bufferInUse = -1 );
+
+      bool hasAddress( const uint8_t opcode ) const;
+      size_t dummyBytes( const uint8_t opcode ) const;
+      int bufferFor( const uint8_t opcode ) const;
+      uint32_t decodePage() const;
+      uint32_t decodeOffset() const;
+
+      void erasePages( const uint32_t first, const uint32_t count );
+      void programPage( const uint32_t pageNumber, const int bufferNumber, const bool erase, const bool onlyTouched );
+    };
+  }  // namespace NORFlash
+}  // namespace Adesto
+
+#endif /* !AT45DB081_SIM_HPP */
@@ -0,0 +1,149 @@
+/********************************************************************************
+ * File Name:
+ *	  test_at45db081_awaitCompletion.cpp
+ *
+ * Description:
+ *	  Implements tests for the adaptive completion waits on the AT45DB081
+ *
+ * 2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* C++ Includes */
+#include <chrono>
+
+/* Driver Includes */
+#include "at45db081.hpp"
+
+/* Testing Framework Includes */
+#include <gtest/gtest.h>
+#include <Chimera/spi.hpp>
+#include "test_fixtures_at45db081.hpp"
+
+#if defined( GMOCK_TEST )
+/* Mock Includes */
+#include <Chimera/mock/spi.hpp>
+#include <gmock/gmock.h>
+
+using namespace Adesto::NORFlash;
+
+/*------------------------------------------------
+Datasheet page erase and program time, in microseconds
+------------------------------------------------*/
+static constexpr uint32_t PAGE_PROGRAM_TYPICAL = 15000;
+
+/*------------------------------------------------
+Adaptive Timing
+------------------------------------------------*/
+TEST_F( SimulatedFlash, AwaitCompletion_FastChipShortensWaits )
+{
+  static constexpr uint32_t opTime = 1000;
+
+  std::array<uint8_t, PAGE_SIZE_BINARY> data;
+  data.fill( 0x3C );
+
+  passInit();
+  sim.setOperationTime( SimOperation::PAGE_ERASE_PROGRAM, opTime );
+
+  /*------------------------------------------------
+  The first write sleeps off most of the datasheet time,
+  later ones only what was actually measured.
+  ------------------------------------------------*/
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( 0, data.data(), data.size() ) );
+  const uint32_t first = flash->getOperationStats( FlashOperation::PAGE_ERASE_PROGRAM ).maximum;
+  EXPECT_GT( first, 10 * opTime );
+
+  const auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( PAGE_SIZE_BINARY, data.data(), data.size() ) );
+  const auto stop = std::chrono::steady_clock::now();
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>( stop - start ).count();
+  EXPECT_LT( elapsed, first );
+  EXPECT_EQ( 2, flash->getOperationStats( FlashOperation::PAGE_ERASE_PROGRAM ).samples );
+}
+
+TEST_F( SimulatedFlash, AwaitCompletion_SlowChipStillCompletes )
+{
+  static constexpr uint32_t opTime = 2 * PAGE_PROGRAM_TYPICAL;
+
+  std::array<uint8_t, PAGE_SIZE_BINARY> data;
+  data.fill( 0x3C );
+
+  passInit();
+  sim.setOperationTime( SimOperation::PAGE_ERASE_PROGRAM, opTime );
+
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( 0, data.data(), data.size() ) );
+
+  const OperationStats stats = flash->getOperationStats( FlashOperation::PAGE_ERASE_PROGRAM );
+  EXPECT_EQ( 1, stats.samples );
+  EXPECT_GE( stats.maximum, opTime );
+  EXPECT_EQ( 0, memcmp( sim.page( 0 ), data.data(), data.size() ) );
+}
+
+/*------------------------------------------------
+Timeouts
+------------------------------------------------*/
+TEST_F( SimulatedFlash, AwaitCompletion_StuckProgramTimesOut )
+{
+  std::array<uint8_t, PAGE_SIZE_BINARY> data;
+  data.fill( 0x3C );
+
+  passInit();
+  sim.setOperationTime( SimOperation::PAGE_ERASE_PROGRAM, 100 * PAGE_PROGRAM_TYPICAL );
+
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ( Chimera::CommonStatusCodes::TIMEOUT, flash->write( 0, data.data(), data.size() ) );
+  const auto stop = std::chrono::steady_clock::now();
+
+  /*------------------------------------------------
+  The failed wait gave up long before the chip finished
+  and wasn't learned as a completion time.
+  ------------------------------------------------*/
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>( stop - start ).count();
+  EXPECT_LT( elapsed, 10 * PAGE_PROGRAM_TYPICAL );
+  EXPECT_EQ( 0, flash->getOperationStats( FlashOperation::PAGE_ERASE_PROGRAM ).samples );
+}
+
+TEST_F( SimulatedFlash, AwaitCompletion_StuckPartialWriteTimesOut )
+{
+  uint8_t value = 0x00;
+
+  passInit();
+  sim.setOperationTime( SimOperation::PAGE_ERASE_PROGRAM, 100 * PAGE_PROGRAM_TYPICAL );
+
+  EXPECT_EQ( Chimera::CommonStatusCodes::TIMEOUT, flash->write( 10, &value, 1 ) );
+}
+
+TEST_F( SimulatedFlash, AwaitCompletion_StuckEraseTimesOut )
+{
+  passInit();
+  sim.setOperationTime( SimOperation::PAGE_ERASE, 100 * 12000 );
+
+  EXPECT_EQ( Chimera::CommonStatusCodes::TIMEOUT, flash->erase( 0, flash->getPageSize() ) );
+  EXPECT_EQ( 0, flash->getOperationStats( FlashOperation::PAGE_ERASE ).samples );
+}
+
+TEST_F( SimulatedFlash, AwaitCompletion_TimeoutFollowsSlowestCompletion )
+{
+  static constexpr uint32_t slow   = 3 * PAGE_PROGRAM_TYPICAL;
+  static constexpr uint32_t slower = 6 * PAGE_PROGRAM_TYPICAL;
+
+  std::array<uint8_t, PAGE_SIZE_BINARY> data;
+  data.fill( 0x3C );
+
+  passInit();
+
+  /*------------------------------------------------
+  A chip this slow is only tolerated once it has been
+  seen completing slowly before.
+  ------------------------------------------------*/
+  sim.setOperationTime( SimOperation::PAGE_ERASE_PROGRAM, slow );
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( 0, data.data(), data.size() ) );
+
+  sim.setOperationTime( SimOperation::PAGE_ERASE_PROGRAM, slower );
+  EXPECT_EQ( Chimera::CommonStatusCodes::OK, flash->write( PAGE_SIZE_BINARY, data.data(), data.size() ) );
+
+  flash->resetOperationStats();
+  EXPECT_EQ( Chimera::CommonStatusCodes::TIMEOUT, flash->write( 2 * PAGE_SIZE_BINARY, data.data(), data.size() ) );
+}
+
+#endif /* GMOCK_TEST */
@@ -0,0 +1,224 @@
+/********************************************************************************
+ * File Name:
+ *	  test_at45db081_blockDevice.cpp
+ *
+ * Description:
+ *	  Implements tests for the AT45DB081 block device interface
+ *
+ * 2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* C++ Includes */
+#include <numeric>
+
+/* Driver Includes */
+#include "at45db081.hpp"
+
+/* Testing Framework Includes */
+#include <gtest/gtest.h>
+#include <Chimera/spi.hpp>
+#include "test_fixtures_at45db081.hpp"
+
+#if defined( GMOCK_TEST )
+/* Mock Includes */
+#include <Chimera/mock/spi.hpp>
+#include <gmock/gmock.h>
+
+using namespace Adesto::NORFlash;
+using namespace Chimera::Modules::Memory;
+
+/*------------------------------------------------
+Room for a full cache of default sized sectors
+------------------------------------------------*/
+static std::array<uint8_t, DISK_CACHE_SECTORS * DISK_SECTOR_SIZE_DEFAULT> diskCache;
+
+TEST_F( SimulatedFlash, Disk_OpenPreInit )
+{
+  EXPECT_EQ( BlockStatus::BLOCK_DEV_NOTRDY, flash->DiskOpen( 0, BlockMode::WRITE ) );
+}
+
+TEST_F( SimulatedFlash, Disk_SectorSizeMustSpanWholePages )
+{
+  sim.disableTiming();
+  passInit();
+
+  EXPECT_EQ( Chimera::CommonStatusCodes::INVAL_FUNC_PARAM, flash->setDiskSectorSize( 0 ) );
+  EXPECT_EQ( Chimera::CommonStatusCodes::INVAL_FUNC_PARAM, flash->setDiskSectorSize( 300 ) );
+  EXPECT_EQ( Chimera::CommonStatusCodes::OK, flash->setDiskSectorSize( 1024 ) );
+
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskOpen( 0, BlockMode::WRITE ) );
+  EXPECT_EQ( Chimera::CommonStatusCodes::LOCKED, flash->setDiskSectorSize( 512 ) );
+  EXPECT_EQ( flash->getFlashCapacity() / 1024, flash->getDiskSectorCount() );
+}
+
+TEST_F( SimulatedFlash, Disk_NoCacheWritesThrough )
+{
+  std::array<uint8_t, 2 * DISK_SECTOR_SIZE_DEFAULT> writeData;
+
+  std::iota( writeData.begin(), writeData.end(), 7 );
+
+  sim.disableTiming();
+  passInit();
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskOpen( 0, BlockMode::WRITE ) );
+
+  sim.resetStats();
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskWrite( 0, 3, 2, writeData.data() ) );
+  EXPECT_EQ( 4, sim.getStats().programs );
+
+  for ( uint32_t page = 0; page < 4; page++ )
+  {
+    EXPECT_EQ( 0, memcmp( sim.page( 6 + page ), writeData.data() + ( page * PAGE_SIZE_BINARY ), PAGE_SIZE_BINARY ) );
+  }
+}
+
+TEST_F( SimulatedFlash, Disk_CacheHoldsWholeSectorsOnly )
+{
+  std::array<uint8_t, 1024> data;
+
+  sim.disableTiming();
+  passInit();
+
+  /*------------------------------------------------
+  The storage fits one 1024 byte sector and part of another
+  ------------------------------------------------*/
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->setDiskSectorSize( 1024 ) );
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->setDiskCache( diskCache.data(), 1536 ) );
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskOpen( 0, BlockMode::WRITE ) );
+  EXPECT_EQ( Chimera::CommonStatusCodes::LOCKED, flash->setDiskCache( nullptr, 0 ) );
+
+  sim.resetStats();
+  data.fill( 0x11 );
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskWrite( 0, 0, 1, data.data() ) );
+  EXPECT_EQ( 0, sim.getStats().programs );
+
+  /*------------------------------------------------
+  A second sector pushes the first one out
+  ------------------------------------------------*/
+  data.fill( 0x22 );
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskWrite( 0, 1, 1, data.data() ) );
+  EXPECT_EQ( 4, sim.getStats().programs );
+  EXPECT_EQ( 0x11, sim.page( 0 )[ 0 ] );
+  EXPECT_EQ( ERASE_RESET_VAL, sim.page( 4 )[ 0 ] );
+}
+
+TEST_F( SimulatedFlash, Disk_WritesStayCachedUntilFlush )
+{
+  std::array<uint8_t, 2 * DISK_SECTOR_SIZE_DEFAULT> writeData;
+  std::array<uint8_t, 2 * DISK_SECTOR_SIZE_DEFAULT> readData;
+
+  std::iota( writeData.begin(), writeData.end(), 3 );
+
+  sim.disableTiming();
+  passInit();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->setDiskCache( diskCache.data(), diskCache.size() ) );
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskOpen( 0, BlockMode::WRITE ) );
+
+  sim.resetStats();
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskWrite( 0, 10, 2, writeData.data() ) );
+  EXPECT_EQ( 0, sim.getStats().programs );
+
+  /*------------------------------------------------
+  Reads see the cached data even though flash is untouched
+  ------------------------------------------------*/
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskRead( 0, 10, 2, readData.data() ) );
+  EXPECT_EQ( 0, memcmp( readData.data(), writeData.data(), readData.size() ) );
+  EXPECT_EQ( ERASE_RESET_VAL, sim.page( 20 )[ 0 ] );
+
+  /*------------------------------------------------
+  Flushing writes each sector as two binary pages
+  ------------------------------------------------*/
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskFlush( 0 ) );
+  EXPECT_EQ( 4, sim.getStats().programs );
+
+  for ( uint32_t page = 0; page < 4; page++ )
+  {
+    EXPECT_EQ( 0, memcmp( sim.page( 20 + page ), writeData.data() + ( page * PAGE_SIZE_BINARY ), PAGE_SIZE_BINARY ) );
+  }
+}
+
+TEST_F( SimulatedFlash, Disk_RewritesCoalesceInCache )
+{
+  std::array<uint8_t, DISK_SECTOR_SIZE_DEFAULT> data;
+
+  sim.disableTiming();
+  passInit();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->setDiskCache( diskCache.data(), diskCache.size() ) );
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskOpen( 0, BlockMode::WRITE ) );
+
+  sim.resetStats();
+  for ( uint8_t x = 0; x < 10; x++ )
+  {
+    data.fill( x );
+    ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskWrite( 0, 0, 1, data.data() ) );
+  }
+
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskClose( 0 ) );
+  EXPECT_EQ( 2, sim.getStats().programs );
+  EXPECT_EQ( 9, sim.page( 0 )[ 0 ] );
+  EXPECT_EQ( 9, sim.page( 1 )[ PAGE_SIZE_BINARY - 1 ] );
+}
+
+TEST_F( SimulatedFlash, Disk_EvictionWritesBackOldestSector )
+{
+  std::array<uint8_t, DISK_SECTOR_SIZE_DEFAULT> data;
+
+  sim.disableTiming();
+  passInit();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->setDiskCache( diskCache.data(), diskCache.size() ) );
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskOpen( 0, BlockMode::WRITE ) );
+
+  /*------------------------------------------------
+  One more sector than the cache holds pushes out the first
+  ------------------------------------------------*/
+  for ( uint32_t sector = 0; sector <= DISK_CACHE_SECTORS; sector++ )
+  {
+    data.fill( static_cast<uint8_t>( sector + 1 ) );
+    ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskWrite( 0, sector, 1, data.data() ) );
+  }
+
+  EXPECT_EQ( 1, sim.page( 0 )[ 0 ] );
+  EXPECT_EQ( ERASE_RESET_VAL, sim.page( 2 )[ 0 ] );
+}
+
+TEST_F( SimulatedFlash, Disk_ReadSeesBufferedWrites )
+{
+  std::array<uint8_t, 16> patch;
+  std::array<uint8_t, 2 * DISK_SECTOR_SIZE_DEFAULT> readData;
+
+  patch.fill( 0x3C );
+
+  sim.disableTiming();
+  passInit();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->enableBufferCache( true ) );
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskOpen( 0, BlockMode::WRITE ) );
+
+  /*------------------------------------------------
+  The write is still sitting in an SRAM buffer
+  ------------------------------------------------*/
+  const uint32_t offset = DISK_SECTOR_SIZE_DEFAULT + 100;
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( ( 4 * DISK_SECTOR_SIZE_DEFAULT ) + offset, patch.data(), patch.size() ) );
+  ASSERT_EQ( ERASE_RESET_VAL, sim.page( 10 )[ 100 ] );
+
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskRead( 0, 4, 2, readData.data() ) );
+  EXPECT_EQ( 0, memcmp( readData.data() + offset, patch.data(), patch.size() ) );
+  EXPECT_EQ( ERASE_RESET_VAL, readData[ offset - 1 ] );
+  EXPECT_EQ( ERASE_RESET_VAL, readData[ offset + patch.size() ] );
+}
+
+TEST_F( SimulatedFlash, Disk_OutOfRange )
+{
+  std::array<uint8_t, DISK_SECTOR_SIZE_DEFAULT> data;
+
+  sim.disableTiming();
+  passInit();
+  ASSERT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskOpen( 0, BlockMode::WRITE ) );
+
+  const uint32_t count = flash->getDiskSectorCount();
+  EXPECT_EQ( BlockStatus::BLOCK_DEV_PARERR, flash->DiskRead( 0, count, 1, data.data() ) );
+  EXPECT_EQ( BlockStatus::BLOCK_DEV_PARERR, flash->DiskWrite( 0, count - 1, 2, data.data() ) );
+  EXPECT_EQ( BlockStatus::BLOCK_DEV_PARERR, flash->DiskWrite( 0, 0, 1, nullptr ) );
+  EXPECT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskWrite( 0, count - 1, 1, data.data() ) );
+  EXPECT_EQ( BlockStatus::BLOCK_DEV_OK, flash->DiskFlush( 0 ) );
+}
+
+#endif /* GMOCK_TEST */
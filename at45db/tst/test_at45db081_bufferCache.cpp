@@ -0,0 +1,153 @@
+/********************************************************************************
+ * File Name:
+ *	  test_at45db081_bufferCache.cpp
+ *
+ * Description:
+ *	  Implements tests for using the AT45DB081 SRAM buffers as a page cache
+ *
+ * 2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* C++ Includes */
+#include <numeric>
+
+/* Driver Includes */
+#include "at45db081.hpp"
+
+/* Testing Framework Includes */
+#include <gtest/gtest.h>
+#include <Chimera/spi.hpp>
+#include "test_fixtures_at45db081.hpp"
+
+#if defined( GMOCK_TEST )
+/* Mock Includes */
+#include <Chimera/mock/spi.hpp>
+#include <gmock/gmock.h>
+
+using namespace Adesto::NORFlash;
+
+TEST_F( SimulatedFlash, BufferCache_PartialWritesGatherInBuffer )
+{
+  static constexpr uint32_t page = 5;
+
+  std::array<uint8_t, 4> counter;
+  std::array<uint8_t, 4> readData;
+
+  sim.disableTiming();
+  passInit();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->enableBufferCache( true ) );
+
+  sim.resetStats();
+  const uint32_t address = ( page * flash->getPageSize() ) + 40;
+
+  for ( uint8_t x = 0; x < 10; x++ )
+  {
+    counter.fill( x );
+    ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( address, counter.data(), counter.size() ) );
+  }
+
+  /*------------------------------------------------
+  Nothing has been programmed, yet reads see the new data
+  ------------------------------------------------*/
+  EXPECT_EQ( 0, sim.getStats().programs );
+  EXPECT_EQ( ERASE_RESET_VAL, sim.page( page )[ 40 ] );
+
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->read( address, readData.data(), readData.size() ) );
+  EXPECT_EQ( 0, memcmp( readData.data(), counter.data(), counter.size() ) );
+
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->flushBuffers() );
+  EXPECT_EQ( 1, sim.getStats().programs );
+  EXPECT_EQ( 0, memcmp( sim.page( page ) + 40, counter.data(), counter.size() ) );
+}
+
+TEST_F( SimulatedFlash, BufferCache_ReadOverlaysDirtyPages )
+{
+  std::array<uint8_t, 3 * PAGE_SIZE_BINARY> readData;
+  std::array<uint8_t, 8> patch;
+  patch.fill( 0x42 );
+
+  sim.disableTiming();
+  passInit();
+  flash->enableBufferCache( true );
+
+  /*------------------------------------------------
+  Dirty the middle of a three page span and read across it
+  ------------------------------------------------*/
+  const uint32_t base = 20 * flash->getPageSize();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( base + PAGE_SIZE_BINARY + 10, patch.data(), patch.size() ) );
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->read( base, readData.data(), readData.size() ) );
+
+  for ( uint32_t x = 0; x < readData.size(); x++ )
+  {
+    const bool patched = ( x >= PAGE_SIZE_BINARY + 10 ) && ( x < PAGE_SIZE_BINARY + 10 + patch.size() );
+    ASSERT_EQ( patched ? 0x42 : ERASE_RESET_VAL, readData[ x ] ) << "Index " << x;
+  }
+}
+
+TEST_F( SimulatedFlash, BufferCache_ThirdPageEvictsOldest )
+{
+  uint8_t data = 0x11;
+
+  sim.disableTiming();
+  passInit();
+  flash->enableBufferCache( true );
+  sim.resetStats();
+
+  flash->write( ( 1 * flash->getPageSize() ) + 3, &data, 1 );
+  flash->write( ( 2 * flash->getPageSize() ) + 3, &data, 1 );
+  EXPECT_EQ( 0, sim.getStats().programs );
+
+  flash->write( ( 3 * flash->getPageSize() ) + 3, &data, 1 );
+  EXPECT_EQ( 1, sim.getStats().programs );
+  EXPECT_EQ( data, sim.page( 1 )[ 3 ] );
+  EXPECT_EQ( ERASE_RESET_VAL, sim.page( 2 )[ 3 ] );
+
+  /*------------------------------------------------
+  Turning the cache off writes back everything else
+  ------------------------------------------------*/
+  EXPECT_EQ( Chimera::CommonStatusCodes::OK, flash->enableBufferCache( false ) );
+  EXPECT_EQ( 3, sim.getStats().programs );
+  EXPECT_EQ( data, sim.page( 2 )[ 3 ] );
+  EXPECT_EQ( data, sim.page( 3 )[ 3 ] );
+}
+
+TEST_F( SimulatedFlash, BufferCache_FullPageWriteSupersedesBuffer )
+{
+  std::array<uint8_t, PAGE_SIZE_BINARY> pageData;
+  uint8_t data = 0x00;
+
+  std::iota( pageData.begin(), pageData.end(), 0 );
+
+  sim.disableTiming();
+  passInit();
+  flash->enableBufferCache( true );
+  sim.resetStats();
+
+  const uint32_t base = 7 * flash->getPageSize();
+  flash->write( base + 9, &data, 1 );
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( base, pageData.data(), pageData.size() ) );
+  flash->flushBuffers();
+
+  EXPECT_EQ( 1, sim.getStats().programs );
+  EXPECT_EQ( 0, memcmp( sim.page( 7 ), pageData.data(), pageData.size() ) );
+}
+
+TEST_F( SimulatedFlash, BufferCache_EraseDiscardsBuffer )
+{
+  uint8_t data = 0x00;
+
+  sim.disableTiming();
+  passInit();
+  flash->enableBufferCache( true );
+  sim.resetStats();
+
+  const uint32_t base = 9 * flash->getPageSize();
+  flash->write( base + 9, &data, 1 );
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->erase( base, flash->getPageSize() ) );
+  flash->flushBuffers();
+
+  EXPECT_EQ( 0, sim.getStats().programs );
+  EXPECT_EQ( ERASE_RESET_VAL, sim.page( 9 )[ 9 ] );
+}
+
+#endif /* GMOCK_TEST */
@@ -0,0 +1,109 @@
+/********************************************************************************
+ * File Name:
+ *	  test_at45db081_copyPage.cpp
+ *
+ * Description:
+ *	  Implements tests for in-chip page copies on the AT45DB081
+ *
+ * 2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* C++ Includes */
+#include <numeric>
+
+/* Driver Includes */
+#include "at45db081.hpp"
+
+/* Testing Framework Includes */
+#include <gtest/gtest.h>
+#include <Chimera/spi.hpp>
+#include "test_fixtures_at45db081.hpp"
+
+#if defined( GMOCK_TEST )
+/* Mock Includes */
+#include <Chimera/mock/spi.hpp>
+#include <gmock/gmock.h>
+
+using namespace Adesto::NORFlash;
+
+TEST_F( SimulatedFlash, CopyPage_PreInit )
+{
+  EXPECT_EQ( Chimera::CommonStatusCodes::NOT_INITIALIZED, flash->copyPage( 0, 1 ) );
+  EXPECT_EQ( Chimera::CommonStatusCodes::NOT_INITIALIZED, flash->copyRange( 0, 1, 1 ) );
+}
+
+TEST_F( SimulatedFlash, CopyPage_BadParameters )
+{
+  uint8_t patch = 0;
+
+  sim.disableTiming();
+  passInit();
+
+  EXPECT_EQ( Chimera::CommonStatusCodes::INVAL_FUNC_PARAM, flash->copyPage( AT45Simulator::NUM_PAGES, 1 ) );
+  EXPECT_EQ( Chimera::CommonStatusCodes::INVAL_FUNC_PARAM, flash->copyPage( 1, AT45Simulator::NUM_PAGES ) );
+  EXPECT_EQ( Chimera::CommonStatusCodes::INVAL_FUNC_PARAM, flash->copyPage( 1, 2, 0, nullptr, 4 ) );
+  EXPECT_EQ( Chimera::CommonStatusCodes::INVAL_FUNC_PARAM, flash->copyPage( 1, 2, PAGE_SIZE_BINARY, &patch, 1 ) );
+  EXPECT_EQ( Chimera::CommonStatusCodes::INVAL_FUNC_PARAM, flash->copyRange( AT45Simulator::NUM_PAGES - 1, 0, 2 ) );
+}
+
+TEST_F( SimulatedFlash, CopyPage_DataStaysOnChip )
+{
+  std::array<uint8_t, PAGE_SIZE_BINARY> data;
+  std::iota( data.begin(), data.end(), 1 );
+
+  sim.disableTiming();
+  passInit();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( 3 * flash->getPageSize(), data.data(), data.size() ) );
+
+  sim.resetStats();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->copyPage( 3, 50 ) );
+
+  EXPECT_EQ( 0, memcmp( sim.page( 50 ), data.data(), data.size() ) );
+  EXPECT_EQ( 1, sim.getStats().programs );
+  EXPECT_LT( sim.getStats().bytesClocked, data.size() );
+}
+
+TEST_F( SimulatedFlash, CopyPage_Patched )
+{
+  std::array<uint8_t, PAGE_SIZE_BINARY> data;
+  std::array<uint8_t, 6> patch;
+
+  std::iota( data.begin(), data.end(), 1 );
+  patch.fill( 0xEE );
+
+  sim.disableTiming();
+  passInit();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( 3 * flash->getPageSize(), data.data(), data.size() ) );
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->copyPage( 3, 4, 100, patch.data(), patch.size() ) );
+
+  memcpy( data.data() + 100, patch.data(), patch.size() );
+  EXPECT_EQ( 0, memcmp( sim.page( 4 ), data.data(), data.size() ) );
+  EXPECT_NE( 0, memcmp( sim.page( 3 ), data.data(), data.size() ) );
+}
+
+TEST_F( SimulatedFlash, CopyRange_OverlappingForward )
+{
+  static constexpr uint32_t numPages = 4;
+  std::array<uint8_t, numPages * PAGE_SIZE_BINARY> data;
+
+  for ( uint32_t i = 0; i < data.size(); i++ )
+  {
+    data[ i ] = static_cast<uint8_t>( i / PAGE_SIZE_BINARY );
+  }
+
+  sim.disableTiming();
+  passInit();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( 10 * flash->getPageSize(), data.data(), data.size() ) );
+
+  /*------------------------------------------------
+  Shift the run up by two pages, overlapping itself
+  ------------------------------------------------*/
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->copyRange( 10, 12, numPages ) );
+
+  for ( uint32_t i = 0; i < numPages; i++ )
+  {
+    EXPECT_EQ( 0, memcmp( sim.page( 12 + i ), data.data() + ( i * PAGE_SIZE_BINARY ), PAGE_SIZE_BINARY ) );
+  }
+}
+
+#endif /* GMOCK_TEST */
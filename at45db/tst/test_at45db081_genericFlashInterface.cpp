@@ -100,6 +100,43 @@ TEST_F( VirtualFlash, GFI_IsInitialized_PostInit )
   EXPECT_EQ( true, flash->isInitialized() );
 }
 
+/*------------------------------------------------
+Simulated Chip
+------------------------------------------------*/
+TEST_F( SimulatedFlash, GFI_Write_MultiPage_AlternatesBuffers )
+{
+  using namespace Adesto::NORFlash;
+
+  static constexpr uint32_t numPages = 6;
+  static constexpr uint32_t len      = numPages * PAGE_SIZE_BINARY;
+
+  std::array<uint8_t, len> writeData;
+
+  for ( uint32_t i = 0; i < len; i++ )
+  {
+    writeData[ i ] = static_cast<uint8_t>( i / PAGE_SIZE_BINARY );
+  }
+
+  passInit();
+  sim.setOperationTime( SimOperation::PAGE_ERASE_PROGRAM, 1000 );
+
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( 0, writeData.data(), len ) );
+
+  for ( uint32_t page = 0; page < numPages; page++ )
+  {
+    EXPECT_EQ( 0, memcmp( sim.page( page ), writeData.data() + ( page * PAGE_SIZE_BINARY ), PAGE_SIZE_BINARY ) );
+  }
+
+  /*------------------------------------------------
+  The last two pages were staged in opposite buffers, and
+  no load had to be dropped because the chip was busy.
+  ------------------------------------------------*/
+  EXPECT_EQ( numPages - 1, sim.buffer( SRAMBuffer::BUFFER2 )[ 0 ] );
+  EXPECT_EQ( numPages - 2, sim.buffer( SRAMBuffer::BUFFER1 )[ 0 ] );
+  EXPECT_EQ( 0, sim.getStats().busyRejects );
+  EXPECT_EQ( numPages, sim.getStats().programs );
+}
+
 #endif /* GMOCK_TEST */
 
 #if defined( HW_TEST )
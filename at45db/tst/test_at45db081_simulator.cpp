@@ -0,0 +1,226 @@
+/********************************************************************************
+ * File Name:
+ *	  test_at45db081_simulator.cpp
+ *
+ * Description:
+ *	  Runs the AT45DB081 driver against the behavioral chip simulator
+ *
+ * 2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* C++ Includes */
+#include <chrono>
+#include <numeric>
+
+/* Driver Includes */
+#include "at45db081.hpp"
+
+/* Testing Framework Includes */
+#include <gtest/gtest.h>
+#include <Chimera/spi.hpp>
+#include "test_fixtures_at45db081.hpp"
+
+#if defined( GMOCK_TEST )
+/* Mock Includes */
+#include <Chimera/mock/spi.hpp>
+#include <gmock/gmock.h>
+
+using namespace Adesto::NORFlash;
+
+/*------------------------------------------------
+Functional Behavior
+------------------------------------------------*/
+TEST_F( SimulatedFlash, Simulator_WriteReadBack )
+{
+  static constexpr uint32_t address = 300;
+  static constexpr uint32_t len     = 1000;
+
+  std::array<uint8_t, len> writeData;
+  std::array<uint8_t, len> readData;
+
+  std::iota( writeData.begin(), writeData.end(), 7 );
+  readData.fill( 0 );
+
+  sim.disableTiming();
+  passInit();
+
+  EXPECT_EQ( Chimera::CommonStatusCodes::OK, flash->write( address, writeData.data(), len ) );
+  EXPECT_EQ( Chimera::CommonStatusCodes::OK, flash->read( address, readData.data(), len ) );
+  EXPECT_EQ( 0, memcmp( readData.data(), writeData.data(), len ) );
+}
+
+TEST_F( SimulatedFlash, Simulator_PartialWritePreservesNeighbors )
+{
+  static constexpr uint32_t page = 12;
+
+  std::array<uint8_t, PAGE_SIZE_BINARY> pageData;
+  std::array<uint8_t, PAGE_SIZE_BINARY> readData;
+  std::array<uint8_t, 10> patch;
+
+  pageData.fill( 0xA5 );
+  patch.fill( 0x3C );
+
+  sim.disableTiming();
+  passInit();
+
+  const uint32_t base = page * flash->getPageSize();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( base, pageData.data(), pageData.size() ) );
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( base + 100, patch.data(), patch.size() ) );
+
+  memcpy( pageData.data() + 100, patch.data(), patch.size() );
+  flash->directPageRead( page, 0, readData.data(), readData.size() );
+  EXPECT_EQ( 0, memcmp( readData.data(), pageData.data(), pageData.size() ) );
+}
+
+TEST_F( SimulatedFlash, Simulator_EraseRange )
+{
+  std::array<uint8_t, 64> data;
+  data.fill( 0x00 );
+
+  sim.disableTiming();
+  passInit();
+
+  const uint32_t len = 2 * flash->getBlockSize();
+  for ( uint32_t addr = 0; addr < len; addr += flash->getPageSize() )
+  {
+    ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( addr, data.data(), data.size() ) );
+  }
+
+  EXPECT_EQ( Chimera::CommonStatusCodes::OK, flash->erase( 0, len ) );
+
+  for ( uint32_t addr = 0; addr < len; addr += flash->getPageSize() )
+  {
+    flash->read( addr, data.data(), data.size() );
+    EXPECT_TRUE( std::all_of( data.begin(), data.end(), []( uint8_t x ) { return x == ERASE_RESET_VAL; } ) );
+  }
+}
+
+TEST_F( SimulatedFlash, Simulator_ByteWriteOnlyClearsBits )
+{
+  uint8_t hi     = 0xF0;
+  uint8_t lo     = 0x0F;
+  uint8_t result = 0xFF;
+
+  sim.disableTiming();
+  passInit();
+
+  flash->erasePage( 5 );
+  flash->byteWrite( 5, 17, &hi, 1 );
+  flash->byteWrite( 5, 17, &lo, 1 );
+  flash->directPageRead( 5, 17, &result, 1 );
+
+  EXPECT_EQ( 0x00, result );
+  EXPECT_EQ( ERASE_RESET_VAL, sim.page( 5 )[ 16 ] );
+  EXPECT_EQ( ERASE_RESET_VAL, sim.page( 5 )[ 18 ] );
+}
+
+TEST_F( SimulatedFlash, Simulator_ExtendedPageSize )
+{
+  std::array<uint8_t, 4> writeData = { 1, 2, 3, 4 };
+  std::array<uint8_t, 4> readData;
+
+  sim.disableTiming();
+  passInit();
+
+  flash->useExtendedPageSize();
+  sim.setBinaryPageSize( false );
+  ASSERT_EQ( PAGE_SIZE_EXTENDED, flash->getPageSize() );
+
+  /*------------------------------------------------
+  The last bytes of a 264 byte page only exist in extended mode
+  ------------------------------------------------*/
+  flash->erasePage( 3 );
+  flash->byteWrite( 3, 260, writeData.data(), writeData.size() );
+  flash->directPageRead( 3, 260, readData.data(), readData.size() );
+
+  EXPECT_EQ( 0, memcmp( readData.data(), writeData.data(), writeData.size() ) );
+  EXPECT_EQ( 0, memcmp( sim.page( 3 ) + 260, writeData.data(), writeData.size() ) );
+}
+
+TEST_F( SimulatedFlash, Simulator_SecondBufferUsableWhileBusy )
+{
+  std::array<uint8_t, 8> b1Data;
+  std::array<uint8_t, 8> b2Data;
+  std::array<uint8_t, 8> readData;
+
+  b1Data.fill( 0x11 );
+  b2Data.fill( 0x22 );
+
+  passInit();
+
+  flash->sramLoad( SRAMBuffer::BUFFER1, 0, b1Data.data(), b1Data.size() );
+  flash->sramCommit( SRAMBuffer::BUFFER1, 40, true );
+  ASSERT_NE( Chimera::CommonStatusCodes::OK, flash->isDeviceReady() );
+
+  /*------------------------------------------------
+  Buffer 2 is free while buffer 1 is being programmed
+  ------------------------------------------------*/
+  flash->sramLoad( SRAMBuffer::BUFFER2, 0, b2Data.data(), b2Data.size() );
+  flash->sramRead( SRAMBuffer::BUFFER2, 0, readData.data(), readData.size() );
+  EXPECT_EQ( 0, memcmp( readData.data(), b2Data.data(), b2Data.size() ) );
+  EXPECT_EQ( 0, sim.getStats().busyRejects );
+}
+
+/*------------------------------------------------
+Timing Behavior
+------------------------------------------------*/
+TEST_F( SimulatedFlash, Simulator_BusyFollowsOperationTime )
+{
+  passInit();
+  sim.setOperationTime( SimOperation::PAGE_ERASE, 20000 );
+
+  flash->erasePage( 9 );
+  EXPECT_NE( Chimera::CommonStatusCodes::OK, flash->isDeviceReady() );
+
+  Chimera::delayMilliseconds( 30 );
+  EXPECT_EQ( Chimera::CommonStatusCodes::OK, flash->isDeviceReady() );
+}
+
+TEST_F( SimulatedFlash, Simulator_CompletionTimesAreLearned )
+{
+  static constexpr uint32_t numPages = 12;
+  static constexpr uint32_t opTime   = 2000;
+  static constexpr uint32_t len      = numPages * PAGE_SIZE_BINARY;
+
+  std::array<uint8_t, len> data;
+  data.fill( 0x5A );
+
+  passInit();
+  sim.setOperationTime( SimOperation::PAGE_ERASE_PROGRAM, opTime );
+
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( 0, data.data(), len ) );
+
+  /*------------------------------------------------
+  Every page was measured and the waits converged from
+  the 15ms datasheet value toward the real time.
+  ------------------------------------------------*/
+  const OperationStats stats = flash->getOperationStats( FlashOperation::PAGE_ERASE_PROGRAM );
+  EXPECT_EQ( numPages, stats.samples );
+  EXPECT_GE( stats.minimum, opTime );
+  EXPECT_LT( stats.minimum, 2 * opTime );
+
+  flash->resetOperationStats();
+  EXPECT_EQ( 0, flash->getOperationStats( FlashOperation::PAGE_ERASE_PROGRAM ).samples );
+}
+
+TEST_F( SimulatedFlash, Simulator_WriteThroughput )
+{
+  static constexpr uint32_t len = 16 * PAGE_SIZE_BINARY;
+  std::array<uint8_t, len> data;
+  data.fill( 0x5A );
+
+  passInit();
+
+  const auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( 0, data.data(), len ) );
+  const auto stop = std::chrono::steady_clock::now();
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>( stop - start ).count();
+  ASSERT_GT( elapsed, 0 );
+
+  RecordProperty( "write_us", static_cast<int>( elapsed ) );
+  RecordProperty( "write_bytes_per_sec", static_cast<int>( ( len * 1000000ull ) / elapsed ) );
+  RecordProperty( "bus_bytes", static_cast<int>( sim.getStats().bytesClocked ) );
+}
+
+#endif /* GMOCK_TEST */
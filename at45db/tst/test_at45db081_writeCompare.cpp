@@ -0,0 +1,97 @@
+/********************************************************************************
+ * File Name:
+ *	  test_at45db081_writeCompare.cpp
+ *
+ * Description:
+ *	  Implements tests for skipping unchanged page writes on the AT45DB081
+ *
+ * 2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* C++ Includes */
+#include <numeric>
+
+/* Driver Includes */
+#include "at45db081.hpp"
+
+/* Testing Framework Includes */
+#include <gtest/gtest.h>
+#include <Chimera/spi.hpp>
+#include "test_fixtures_at45db081.hpp"
+
+#if defined( GMOCK_TEST )
+/* Mock Includes */
+#include <Chimera/mock/spi.hpp>
+#include <gmock/gmock.h>
+
+using namespace Adesto::NORFlash;
+
+TEST_F( SimulatedFlash, WriteCompare_UnchangedPagesAreSkipped )
+{
+  static constexpr uint32_t len = 4 * PAGE_SIZE_BINARY;
+
+  std::array<uint8_t, len> data;
+  std::iota( data.begin(), data.end(), 0 );
+
+  sim.disableTiming();
+  passInit();
+  flash->enableWriteCompare( true );
+
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( 0, data.data(), len ) );
+  EXPECT_EQ( 4, sim.getStats().programs );
+
+  /*------------------------------------------------
+  Rewriting the same data costs no program cycles
+  ------------------------------------------------*/
+  sim.resetStats();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( 0, data.data(), len ) );
+  EXPECT_EQ( 0, sim.getStats().programs );
+  EXPECT_EQ( 0, sim.getStats().erases );
+
+  /*------------------------------------------------
+  Only the page that changed gets programmed
+  ------------------------------------------------*/
+  data[ PAGE_SIZE_BINARY + 5 ] ^= 0xFF;
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( 0, data.data(), len ) );
+  EXPECT_EQ( 1, sim.getStats().programs );
+  EXPECT_EQ( data[ PAGE_SIZE_BINARY + 5 ], sim.page( 1 )[ 5 ] );
+}
+
+TEST_F( SimulatedFlash, WriteCompare_PartialPages )
+{
+  std::array<uint8_t, 10> data;
+  data.fill( 0x3C );
+
+  sim.disableTiming();
+  passInit();
+  flash->enableWriteCompare( true );
+
+  const uint32_t address = ( 30 * flash->getPageSize() ) + 17;
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( address, data.data(), data.size() ) );
+  EXPECT_EQ( 1, sim.getStats().programs );
+  EXPECT_EQ( 0, memcmp( sim.page( 30 ) + 17, data.data(), data.size() ) );
+
+  sim.resetStats();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( address, data.data(), data.size() ) );
+  EXPECT_EQ( 0, sim.getStats().programs );
+}
+
+TEST_F( SimulatedFlash, WriteCompare_PageWrite )
+{
+  std::array<uint8_t, PAGE_SIZE_BINARY> data;
+  data.fill( 0x81 );
+
+  sim.disableTiming();
+  passInit();
+  flash->enableWriteCompare( true );
+
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->pageWrite( SRAMBuffer::BUFFER2, 0, 12, data.data(), data.size() ) );
+  EXPECT_EQ( 1, sim.getStats().programs );
+
+  sim.resetStats();
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->pageWrite( SRAMBuffer::BUFFER2, 0, 12, data.data(), data.size() ) );
+  EXPECT_EQ( 0, sim.getStats().programs );
+  EXPECT_EQ( 0, memcmp( sim.page( 12 ), data.data(), data.size() ) );
+}
+
+#endif /* GMOCK_TEST */
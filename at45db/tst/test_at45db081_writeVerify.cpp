@@ -0,0 +1,79 @@
+/********************************************************************************
+ * File Name:
+ *	  test_at45db081_writeVerify.cpp
+ *
+ * Description:
+ *	  Implements tests for verifying AT45DB081 writes with the in-chip compare
+ *
+ * 2020 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* C++ Includes */
+#include <numeric>
+
+/* Driver Includes */
+#include "at45db081.hpp"
+
+/* Testing Framework Includes */
+#include <gtest/gtest.h>
+#include <Chimera/spi.hpp>
+#include "test_fixtures_at45db081.hpp"
+
+#if defined( GMOCK_TEST )
+/* Mock Includes */
+#include <Chimera/mock/spi.hpp>
+#include <gmock/gmock.h>
+
+using namespace Adesto::NORFlash;
+
+TEST_F( SimulatedFlash, WriteVerify_GoodWritePasses )
+{
+  static constexpr uint32_t len = 3 * PAGE_SIZE_BINARY + 40;
+
+  std::array<uint8_t, len> data;
+  std::iota( data.begin(), data.end(), 9 );
+
+  sim.disableTiming();
+  passInit();
+  flash->enableWriteVerify( true );
+
+  /*------------------------------------------------
+  Verifying adds command bytes, not another copy of the data
+  ------------------------------------------------*/
+  ASSERT_EQ( Chimera::CommonStatusCodes::OK, flash->write( 100, data.data(), len ) );
+  EXPECT_LT( sim.getStats().bytesClocked, 2 * len );
+}
+
+TEST_F( SimulatedFlash, WriteVerify_WeakCellFullPage )
+{
+  static constexpr uint32_t len = 4 * PAGE_SIZE_BINARY;
+
+  std::array<uint8_t, len> data;
+  data.fill( 0x00 );
+
+  sim.disableTiming();
+  passInit();
+  sim.setWeakCell( 2, 77 );
+
+  EXPECT_EQ( Chimera::CommonStatusCodes::OK, flash->write( 0, data.data(), len ) );
+
+  flash->enableWriteVerify( true );
+  EXPECT_EQ( Chimera::CommonStatusCodes::FAILED_WRITE, flash->write( 0, data.data(), len ) );
+}
+
+TEST_F( SimulatedFlash, WriteVerify_WeakCellPartialPage )
+{
+  std::array<uint8_t, 16> data;
+  data.fill( 0x00 );
+
+  sim.disableTiming();
+  passInit();
+  sim.setWeakCell( 6, 3 );
+  flash->enableWriteVerify( true );
+
+  const uint32_t base = 6 * flash->getPageSize();
+  EXPECT_EQ( Chimera::CommonStatusCodes::OK, flash->write( base + 100, data.data(), data.size() ) );
+  EXPECT_EQ( Chimera::CommonStatusCodes::FAILED_WRITE, flash->write( base + 1, data.data(), data.size() ) );
+}
+
+#endif /* GMOCK_TEST */
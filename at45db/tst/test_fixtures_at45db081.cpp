@@ -15,6 +15,7 @@ using ::testing::_;
 using ::testing::AtLeast;
 using ::testing::DoAll;
 using ::testing::Exactly;
+using ::testing::Invoke;
 using ::testing::NiceMock;
 using ::testing::Return;
 using ::testing::SetArgPointee;
@@ -67,6 +68,46 @@ void VirtualFlash::testReset()
 {
 
 }
+
+void SimulatedFlash::SetUp()
+{
+  /*------------------------------------------------
+  Route all bus traffic into the simulated chip
+  ------------------------------------------------*/
+  // clang-format off
+
+  ON_CALL( spi, init( _ ) )
+    .WillByDefault( Return( Chimera::SPI::Status::OK ) );
+
+  ON_CALL( spi, setChipSelect( _ ) )
+    .WillByDefault( Invoke( [ this ]( auto state ) { return sim.setChipSelect( state ); } ) );
+
+  ON_CALL( spi, writeBytes( _, _, _ ) )
+    .WillByDefault( Invoke( [ this ]( auto data, auto len, auto ) { return sim.writeBytes( data, len ); } ) );
+
+  ON_CALL( spi, readBytes( _, _, _ ) )
+    .WillByDefault( Invoke( [ this ]( auto data, auto len, auto ) { return sim.readBytes( data, len ); } ) );
+
+  // clang-format on
+
+  flash = new Adesto::NORFlash::AT45( &spi );
+}
+
+void SimulatedFlash::TearDown()
+{
+  delete flash;
+}
+
+void SimulatedFlash::passInit()
+{
+  ASSERT_EQ( ErrCode::OK, flash->init( Adesto::NORFlash::FlashChip::AT45DB081E ) );
+  ASSERT_EQ( true, flash->isInitialized() );
+
+  /*------------------------------------------------
+  With SW_SIM the driver skips the page size command
+  ------------------------------------------------*/
+  sim.setBinaryPageSize( flash->getPageSize() == Adesto::NORFlash::PAGE_SIZE_BINARY );
+}
 #endif /* GMOCK_TEST */
 
 #if defined( HW_TEST )
@@ -21,6 +21,7 @@
 #if defined( GMOCK_TEST )
 #include <gmock/gmock.h>
 #include <Chimera/mock/spi.hpp>
+#include "sim_at45db081.hpp"
 
 using ::testing::NiceMock;
 
@@ -43,6 +44,28 @@ protected:
 
   void passInit();
 };
+
+/**
+ *  Runs the driver against a functional model of the chip rather than
+ *  a list of expected SPI calls. The mock simply forwards all bus traffic
+ *  to the simulator.
+ */
+class SimulatedFlash : public ::testing::Test
+{
+protected:
+  NiceMock<Chimera::Mock::SPIMock> spi;
+  Adesto::NORFlash::AT45Simulator sim;
+  Adesto::NORFlash::AT45 *flash;
+
+  SimulatedFlash()          = default;
+  virtual ~SimulatedFlash() = default;
+
+  virtual void SetUp();
+
+  virtual void TearDown();
+
+  void passInit();
+};
 #endif  /* GMOCK_TEST */
 
 #if defined( HW_TEST )